@@ -0,0 +1,1866 @@
+// src/Benchmark.cpp
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+#include <glad/glad.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <glm/gtc/matrix_transform.hpp>
+#include "Benchmark.h"
+#include "Bvh.h"
+#include "ClusteredLighting.h"
+#include "Culling.h"
+#include "DeferredRenderer.h"
+#include "FrameProfiler.h"
+#include "FrameUniformBuffer.h"
+#include "Framebuffer.h"
+#include "GLStateCache.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "OcclusionCulling.h"
+#include "Picking.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "Shader.h"
+#include "SinCos.h"
+#include "StreamBuffer.h"
+#include "ThreadPool.h"
+#include "Transform.h"
+
+namespace {
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Vertex shader con los defines del formato de vértice actual
+    std::string loadVertexShader(const char* path, const std::string& extraDefines = "")
+    {
+        return injectDefines(loadTextFile(path), vertexLayoutDefines(defaultVertexLayout()) + extraDefines);
+    }
+
+    // ---------------------------------------------------
+    // Tiempo de creación de los programas con la cache de
+    // binarios vacía (compilación + enlace) y llena (glProgramBinary)
+    // ---------------------------------------------------
+    int runShaderCacheBenchmark(const AppOptions&)
+    {
+        const int repetitions = 5;
+        const std::string cacheDir = "shader_cache/bench";
+        std::string vsCode = loadVertexShader("src/shaders/vertex_shader.glsl");
+        std::string fsCode = loadTextFile("src/shaders/fragment_shader.glsl");
+
+        Shader::SetBinaryCacheDirectory(cacheDir);
+
+        double coldTotal = 0.0, warmTotal = 0.0;
+        bool warmHits = true;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            std::error_code error;
+            std::filesystem::remove_all(cacheDir, error);
+
+            auto start = std::chrono::steady_clock::now();
+            {
+                Shader cold(vsCode, fsCode);
+                glFinish();
+                if (cold.GetId() == 0)
+                    return 1;
+            }
+            coldTotal += elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            {
+                Shader warm(vsCode, fsCode);
+                glFinish();
+                warmHits = warmHits && warm.LoadedFromCache();
+            }
+            warmTotal += elapsedMs(start);
+        }
+
+        std::error_code error;
+        std::filesystem::remove_all(cacheDir, error);
+
+        printf("renderer: %s\n", glGetString(GL_RENDERER));
+        printf("shader-cache cold (compile + link): %8.3f ms\n", coldTotal / repetitions);
+        printf("shader-cache warm (program binary): %8.3f ms%s\n", warmTotal / repetitions,
+            warmHits ? "" : "  (driver rejected the binary, fell back to source)");
+        return 0;
+    }
+
+    // ---------------------------------------------------
+    // Tiempo por frame de la escena instanciada al crecer el número
+    // de instancias de 1 a 1M (cuatro llamadas de dibujo por frame)
+    // ---------------------------------------------------
+    int runInstancingBenchmark(const AppOptions& options)
+    {
+        const int warmupFrames = 5;
+        const int measuredFrames = 30;
+
+        Shader shader(loadVertexShader("src/shaders/instanced_vertex_shader.glsl"),
+            loadTextFile("src/shaders/instanced_fragment_shader.glsl"));
+        if (shader.GetId() == 0)
+            return 1;
+
+        std::vector<Shape> shapes = { createCube(), createSphere(24, 24), createPyramid(), createTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+        glm::vec3 specular[4] = { glm::vec3(0.3f), glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.5f) };
+        float shininess[4] = { 8.0f, 32.0f, 64.0f, 4.0f };
+
+        Framebuffer target(options.width, options.height);
+        target.Bind();
+        shader.Bind();
+        shader.SetVec3(shader.GetUniform("materialSpecular"), specular, 4);
+        shader.SetFloat(shader.GetUniform("materialShininess"), shininess, 4);
+        shader.SetMat4("model", glm::mat4(1.0f));
+        shader.SetMat3("normalMatrix", glm::mat3(1.0f));
+
+        FrameUniformBuffer frameUniforms;
+        FrameData frameData{};
+        frameData.lightAmbient = glm::vec3(0.2f);
+        frameData.lightDiffuse = glm::vec3(0.7f);
+        frameData.lightSpecular = glm::vec3(1.0f);
+
+        GLuint query;
+        glGenQueries(1, &query);
+
+        printf("renderer: %s, %dx%d\n", glGetString(GL_RENDERER), options.width, options.height);
+        printf("%10s %12s %12s %12s %12s %14s\n", "instances", "triangles", "cpu p50 ms", "cpu p95 ms", "gpu p50 ms", "Minst/s");
+        for (int count = 1; count <= 1000000; count *= 10)
+        {
+            Scene scene = generateScene(count, static_cast<int>(shapes.size()), palette, 4, 1234u);
+            auto instanced = std::make_unique<InstancedScene>(shapes, scene);
+
+            long long triangles = 0;
+            for (const SceneObject& object : scene.objects)
+                triangles += shapes[object.shapeType].indexCount / 3;
+
+            float distance = std::max(5.0f, scene.radius * 2.5f);
+            glm::vec3 eye(0.0f, 0.0f, distance);
+            frameData.view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            frameData.projection = glm::perspective(glm::radians(45.0f),
+                (float)options.width / (float)options.height, 0.1f, distance + scene.radius + 10.0f);
+            frameData.viewPos = eye;
+            frameData.lightPos = glm::vec3(distance * 0.4f);
+            frameUniforms.Update(frameData);
+
+            FrameProfiler::RollingStats cpu(measuredFrames), gpu(measuredFrames);
+            for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+            {
+                auto start = std::chrono::steady_clock::now();
+                glBeginQuery(GL_TIME_ELAPSED, query);
+                glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                instanced->Draw();
+                glEndQuery(GL_TIME_ELAPSED);
+                glFinish();
+
+                GLuint64 gpuNs = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                if (frame >= warmupFrames)
+                {
+                    cpu.Add(elapsedMs(start));
+                    gpu.Add(gpuNs / 1.0e6);
+                }
+            }
+            frameUniforms.EndFrame();
+
+            double p50 = cpu.Percentile(50);
+            printf("%10d %12lld %12.3f %12.3f %12.3f %14.2f\n", count, triangles, p50, cpu.Percentile(95),
+                gpu.Percentile(50), p50 > 0.0 ? count / (p50 * 1000.0) : 0.0);
+            fflush(stdout);
+        }
+
+        glDeleteQueries(1, &query);
+        for (Shape& shape : shapes)
+            destroyShape(shape);
+        return 0;
+    }
+
+    // ---------------------------------------------------
+    // Matriz de normales por vértice (inverse() en el vertex shader)
+    // frente a un uniform calculado una vez en la CPU, sobre una
+    // esfera de ~1M de vértices
+    // ---------------------------------------------------
+    int runNormalMatrixBenchmark(const AppOptions& options)
+    {
+        const int warmupFrames = 5;
+        const int measuredFrames = 30;
+        const int drawsPerFrame = 4;
+
+        std::string fsCode = loadTextFile("src/shaders/fragment_shader.glsl");
+        Shader perVertex(loadVertexShader("src/shaders/vertex_shader.glsl", "#define NORMAL_MATRIX_PER_VERTEX\n"), fsCode);
+        Shader perObject(loadVertexShader("src/shaders/vertex_shader.glsl"), fsCode);
+        if (perVertex.GetId() == 0 || perObject.GetId() == 0)
+            return 1;
+
+        Shape sphere = createSphere(1024, 1024);
+
+        Framebuffer target(options.width, options.height);
+        target.Bind();
+
+        glm::mat4 model = glm::rotate(glm::mat4(1.0f), 0.6f, glm::vec3(0.3f, 1.0f, 0.2f));
+        model = glm::scale(model, glm::vec3(1.5f));
+
+        FrameUniformBuffer frameUniforms;
+        FrameData frameData{};
+        glm::vec3 eye(0.0f, 0.0f, 5.0f);
+        frameData.view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        frameData.projection = glm::perspective(glm::radians(45.0f),
+            (float)options.width / (float)options.height, 0.1f, 100.0f);
+        frameData.viewPos = eye;
+        frameData.lightPos = glm::vec3(1.2f, 1.0f, 2.0f);
+        frameData.lightAmbient = glm::vec3(0.2f);
+        frameData.lightDiffuse = glm::vec3(0.7f);
+        frameData.lightSpecular = glm::vec3(1.0f);
+        frameUniforms.Update(frameData);
+
+        GLuint query;
+        glGenQueries(1, &query);
+
+        printf("renderer: %s, %dx%d\n", glGetString(GL_RENDERER), options.width, options.height);
+        printf("vertices per draw: %d, draws per frame: %d\n", sphere.vertexCount, drawsPerFrame);
+        printf("%-22s %12s %12s %14s\n", "variant", "gpu p50 ms", "gpu p95 ms", "Mvert/s");
+
+        // Las dos variantes deben dar la misma imagen: la de por vértice
+        // recibe la decodificación de posiciones aparte para invertir
+        // solo la matriz modelo
+        std::vector<unsigned char> pixels[2];
+        struct Variant { const char* name; Shader* shader; };
+        Variant variants[] = { { "per-vertex inverse", &perVertex }, { "cpu uniform", &perObject } };
+        for (int v = 0; v < 2; ++v)
+        {
+            const Variant& variant = variants[v];
+            Shader& shader = *variant.shader;
+            shader.Bind();
+            if (&shader == &perVertex)
+            {
+                shader.SetMat4("model", model);
+                shader.SetMat4("positionDecode", positionDecodeMatrix(sphere));
+            }
+            else
+            {
+                shader.SetMat4("model", model * positionDecodeMatrix(sphere));
+            }
+            shader.SetMat3("normalMatrix", computeNormalMatrix(model));
+            shader.SetVec3("objectColor", glm::vec3(1.0f));
+            shader.SetVec3("materialSpecular", glm::vec3(0.5f));
+            shader.SetFloat("materialShininess", 32.0f);
+
+            FrameProfiler::RollingStats gpu(measuredFrames);
+            for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+            {
+                glBeginQuery(GL_TIME_ELAPSED, query);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                for (int draw = 0; draw < drawsPerFrame; ++draw)
+                    drawShape(sphere);
+                glEndQuery(GL_TIME_ELAPSED);
+
+                GLuint64 gpuNs = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                if (frame >= warmupFrames)
+                    gpu.Add(gpuNs / 1.0e6);
+            }
+
+            double p50 = gpu.Percentile(50);
+            printf("%-22s %12.3f %12.3f %14.2f\n", variant.name, p50, gpu.Percentile(95),
+                p50 > 0.0 ? (double)sphere.vertexCount * drawsPerFrame / (p50 * 1000.0) : 0.0);
+            fflush(stdout);
+
+            pixels[v].resize(static_cast<std::size_t>(options.width) * options.height * 4);
+            glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels[v].data());
+        }
+
+        int largest = 0;
+        for (std::size_t i = 0; i < pixels[0].size(); ++i)
+            largest = std::max(largest, std::abs(static_cast<int>(pixels[0][i]) - pixels[1][i]));
+        printf("max pixel difference between variants: %d\n", largest);
+
+        glDeleteQueries(1, &query);
+        destroyShape(sphere);
+        return 0;
+    }
+
+    bool sameMesh(const MeshData& a, const MeshData& b)
+    {
+        return a.vertices.size() == b.vertices.size() && a.indices.size() == b.indices.size() &&
+            std::memcmp(a.vertices.data(), b.vertices.data(), a.vertices.size() * sizeof(float)) == 0 &&
+            std::memcmp(a.indices.data(), b.indices.data(), a.indices.size() * sizeof(unsigned int)) == 0;
+    }
+
+    // ---------------------------------------------------
+    // Escalado de los generadores de esfera y toro de 1 a N hilos.
+    // Cada resultado se compara bit a bit con el de un solo hilo.
+    // ---------------------------------------------------
+    int runMeshGenerationBenchmark(const AppOptions&)
+    {
+        const int repetitions = 5;
+        const int sphereSectors = 2048, sphereStacks = 2048;
+        const int torusMajor = 2048, torusMinor = 1024;
+
+        MeshData sphereReference, torusReference;
+        {
+            ThreadPool serial(1);
+            sphereReference = generateSphere(sphereSectors, sphereStacks, serial);
+            torusReference = generateTorus(torusMajor, torusMinor, 1.0f, 0.3f, serial);
+        }
+
+        int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(maxThreads);
+
+        printf("sphere %dx%d: %zu vertices, torus %dx%d: %zu vertices\n", sphereSectors, sphereStacks,
+            sphereReference.VertexCount(), torusMajor, torusMinor, torusReference.VertexCount());
+        printf("%8s %14s %14s %10s %14s %10s\n", "threads", "sphere ms", "torus ms", "speedup", "Mvert/s", "identical");
+
+        double baseline = 0.0;
+        bool allIdentical = true;
+        for (int threads : threadCounts)
+        {
+            ThreadPool pool(threads);
+            FrameProfiler::RollingStats sphereMs(repetitions), torusMs(repetitions);
+            bool identical = true;
+            for (int i = 0; i < repetitions; ++i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                MeshData sphere = generateSphere(sphereSectors, sphereStacks, pool);
+                sphereMs.Add(elapsedMs(start));
+
+                start = std::chrono::steady_clock::now();
+                MeshData torus = generateTorus(torusMajor, torusMinor, 1.0f, 0.3f, pool);
+                torusMs.Add(elapsedMs(start));
+
+                identical = identical && sameMesh(sphere, sphereReference) && sameMesh(torus, torusReference);
+            }
+
+            double total = sphereMs.Percentile(50) + torusMs.Percentile(50);
+            if (threads == 1)
+                baseline = total;
+            double vertices = static_cast<double>(sphereReference.VertexCount() + torusReference.VertexCount());
+            printf("%8d %14.3f %14.3f %9.2fx %14.2f %10s\n", threads, sphereMs.Percentile(50), torusMs.Percentile(50),
+                total > 0.0 ? baseline / total : 0.0, total > 0.0 ? vertices / (total * 1000.0) : 0.0,
+                identical ? "yes" : "NO");
+            fflush(stdout);
+            allIdentical = allIdentical && identical;
+        }
+        return allIdentical ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Precisión de sinCos frente a libm (en double) y rendimiento de
+    // cada variante, más el de los generadores que usan sus tablas
+    // ---------------------------------------------------
+    int runSinCosBenchmark(const AppOptions&)
+    {
+        const std::size_t count = 1 << 20;
+        const int repetitions = 20;
+        const double maxAllowedError = 1e-6;
+
+        // Ángulos en [-4pi, 4pi], más de lo que usan los generadores
+        std::vector<float> angles(count), sines(count), cosines(count);
+        for (std::size_t i = 0; i < count; ++i)
+            angles[i] = static_cast<float>(-4.0 * 3.14159265358979 + 8.0 * 3.14159265358979 * i / (count - 1));
+
+        const SinCosKernel kernels[] = { SinCosScalar, SinCosSSE2, SinCosAVX2 };
+        std::vector<float> referenceSines, referenceCosines;
+        bool ok = true;
+
+        printf("best kernel: %s\n", sinCosKernelName(bestSinCosKernel()));
+        printf("%-8s %14s %14s %12s %10s\n", "kernel", "max abs err", "max ulp (f32)", "Mangles/s", "same bits");
+        for (SinCosKernel kernel : kernels)
+        {
+            if (!sinCosKernelSupported(kernel))
+            {
+                printf("%-8s %14s\n", sinCosKernelName(kernel), "not supported");
+                continue;
+            }
+
+            sinCos(angles.data(), sines.data(), cosines.data(), count, kernel);
+
+            double maxError = 0.0;
+            long long maxUlp = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                double s = std::sin(static_cast<double>(angles[i]));
+                double c = std::cos(static_cast<double>(angles[i]));
+                maxError = std::max(maxError, std::max(std::fabs(sines[i] - s), std::fabs(cosines[i] - c)));
+
+                float expected[2] = { static_cast<float>(s), static_cast<float>(c) };
+                float actual[2] = { sines[i], cosines[i] };
+                for (int k = 0; k < 2; ++k)
+                {
+                    int a, b;
+                    std::memcpy(&a, &expected[k], 4);
+                    std::memcpy(&b, &actual[k], 4);
+                    if ((a < 0) == (b < 0))
+                        maxUlp = std::max(maxUlp, std::llabs(static_cast<long long>(a) - b));
+                }
+            }
+
+            bool sameBits = true;
+            if (referenceSines.empty())
+            {
+                referenceSines = sines;
+                referenceCosines = cosines;
+            }
+            else
+            {
+                sameBits = std::memcmp(sines.data(), referenceSines.data(), count * sizeof(float)) == 0 &&
+                    std::memcmp(cosines.data(), referenceCosines.data(), count * sizeof(float)) == 0;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repetitions; ++r)
+                sinCos(angles.data(), sines.data(), cosines.data(), count, kernel);
+            double ms = elapsedMs(start);
+
+            printf("%-8s %14.3g %14lld %12.1f %10s\n", sinCosKernelName(kernel), maxError, maxUlp,
+                count * repetitions / (ms * 1000.0), sameBits ? "yes" : "NO");
+            ok = ok && sameBits && maxError <= maxAllowedError;
+        }
+
+        // Referencia: sinf/cosf de libm
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                sines[i] = std::sin(angles[i]);
+                cosines[i] = std::cos(angles[i]);
+            }
+        }
+        double libmMs = elapsedMs(start);
+        printf("%-8s %14s %14s %12.1f\n", "libm", "-", "-", count * repetitions / (libmMs * 1000.0));
+
+        // Generadores con las tablas, en un solo hilo
+        ThreadPool serial(1);
+        const int meshRepetitions = 5;
+        FrameProfiler::RollingStats sphereMs(meshRepetitions), torusMs(meshRepetitions);
+        std::size_t sphereVertices = 0, torusVertices = 0;
+        for (int r = 0; r < meshRepetitions; ++r)
+        {
+            start = std::chrono::steady_clock::now();
+            sphereVertices = generateSphere(1024, 1024, serial).VertexCount();
+            sphereMs.Add(elapsedMs(start));
+            start = std::chrono::steady_clock::now();
+            torusVertices = generateTorus(1024, 1024, 1.0f, 0.3f, serial).VertexCount();
+            torusMs.Add(elapsedMs(start));
+        }
+        printf("sphere 1024x1024: %8.3f ms, %8.2f Mvert/s (1 thread)\n", sphereMs.Percentile(50),
+            sphereVertices / (sphereMs.Percentile(50) * 1000.0));
+        printf("torus 1024x1024:  %8.3f ms, %8.2f Mvert/s (1 thread)\n", torusMs.Percentile(50),
+            torusVertices / (torusMs.Percentile(50) * 1000.0));
+
+        if (!ok)
+            printf("FAILED: kernels differ or error above %g\n", maxAllowedError);
+        return ok ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Error de cuantización y bytes por vértice de cada combinación de
+    // formatos sobre las cuatro formas. Las cotas salen del paso de
+    // cada formato: 1/32767 (snorm16), 2^-11 relativo (half),
+    // ~0.01 grados (octaédrica 16 bits) y ~0.2 grados (10 bits).
+    // ---------------------------------------------------
+    int runVertexFormatBenchmark(const AppOptions&)
+    {
+        struct NamedMesh { const char* name; MeshData mesh; };
+        NamedMesh meshes[] = {
+            { "cube", generateCube() },
+            { "sphere", generateSphere(128, 96) },
+            { "pyramid", generatePyramid() },
+            { "torus", generateTorus(128, 64, 1.0f, 0.3f) },
+        };
+
+        // Error máximo de posición relativo a la semiextensión de la caja
+        auto positionBound = [](PositionFormat format) {
+            switch (format)
+            {
+            case PositionHalf: return 0.5f / 2048.0f;
+            case PositionSnorm16: return 0.5f / 32767.0f;
+            default: return 0.0f;
+            }
+            };
+        auto normalBoundDegrees = [](NormalFormat format) {
+            switch (format)
+            {
+            case NormalOctahedral: return 0.01f;
+            case NormalPacked: return 0.2f;
+            default: return 1e-4f;
+            }
+            };
+
+        const PositionFormat positionFormats[] = { PositionFloat32, PositionHalf, PositionSnorm16 };
+        const NormalFormat normalFormats[] = { NormalFloat32, NormalOctahedral, NormalPacked };
+
+        bool ok = true;
+        printf("%-9s %-7s %6s %12s %14s %14s %6s\n", "position", "normal", "bytes", "VRAM ratio",
+            "max pos err", "max nrm deg", "ok");
+        for (PositionFormat positionFormat : positionFormats)
+        {
+            for (NormalFormat normalFormat : normalFormats)
+            {
+                VertexLayout layout = { positionFormat, normalFormat };
+                std::size_t stride = vertexStride(layout);
+
+                float maxPositionError = 0.0f, maxNormalDegrees = 0.0f;
+                bool withinBounds = true;
+                for (const NamedMesh& named : meshes)
+                {
+                    glm::vec3 scale, offset;
+                    std::vector<unsigned char> encoded = encodeVertices(named.mesh.vertices, layout, scale, offset);
+                    float extent = std::max(scale.x, std::max(scale.y, scale.z));
+
+                    for (std::size_t i = 0; i < named.mesh.VertexCount(); ++i)
+                    {
+                        const float* source = &named.mesh.vertices[i * 6];
+                        glm::vec3 position, normal;
+                        decodeVertex(&encoded[i * stride], layout, scale, offset, position, normal);
+
+                        float positionError = glm::length(position - glm::vec3(source[0], source[1], source[2])) / extent;
+                        // atan2(|a x b|, a . b) en double: acos pierde precisión cerca de 0 grados
+                        glm::dvec3 decoded = glm::normalize(glm::dvec3(normal));
+                        glm::dvec3 original = glm::normalize(glm::dvec3(source[3], source[4], source[5]));
+                        float normalDegrees = static_cast<float>(glm::degrees(
+                            std::atan2(glm::length(glm::cross(decoded, original)), glm::dot(decoded, original))));
+
+                        maxPositionError = std::max(maxPositionError, positionError);
+                        maxNormalDegrees = std::max(maxNormalDegrees, normalDegrees);
+                    }
+                }
+                // Error por componente acotado => error euclídeo <= sqrt(3) veces
+                withinBounds = maxPositionError <= positionBound(positionFormat) * std::sqrt(3.0f) + 1e-6f &&
+                    maxNormalDegrees <= normalBoundDegrees(normalFormat);
+                ok = ok && withinBounds;
+
+                printf("%-9s %-7s %6zu %12.2f %14.3g %14.4f %6s\n", positionFormatName(positionFormat),
+                    normalFormatName(normalFormat), stride, stride / 24.0, maxPositionError, maxNormalDegrees,
+                    withinBounds ? "yes" : "NO");
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    // Triángulos como ternas de vértices (rotadas para empezar por el
+    // menor, conservando el sentido) ordenadas: iguales si la malla
+    // describe la misma superficie con la misma orientación
+    std::vector<std::array<std::array<float, 6>, 3>> canonicalTriangles(const MeshData& mesh)
+    {
+        std::vector<std::array<std::array<float, 6>, 3>> triangles(mesh.indices.size() / 3);
+        for (std::size_t t = 0; t < triangles.size(); ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                std::copy_n(&mesh.vertices[mesh.indices[t * 3 + k] * 6], 6, triangles[t][k].begin());
+            auto first = std::min_element(triangles[t].begin(), triangles[t].end());
+            std::rotate(triangles[t].begin(), first, triangles[t].end());
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // ---------------------------------------------------
+    // ACMR/ATVR (cache FIFO de 16) de cada forma y nivel de detalle:
+    // orden original, solo cache (Tipsify) y pipeline completo
+    // (cache + overdraw + orden de vértices)
+    // ---------------------------------------------------
+    int runMeshOptimizerBenchmark(const AppOptions&)
+    {
+        struct NamedMesh { std::string name; MeshData mesh; };
+        std::vector<NamedMesh> meshes = { { "cube", generateCube() }, { "pyramid", generatePyramid() } };
+        const int sphereLevels[][2] = { { 128, 96 }, { 64, 48 }, { 32, 24 }, { 16, 12 } };
+        const int torusLevels[][2] = { { 128, 64 }, { 64, 32 }, { 32, 16 }, { 16, 8 } };
+        for (const auto& level : sphereLevels)
+            meshes.push_back({ "sphere " + std::to_string(level[0]) + "x" + std::to_string(level[1]),
+                generateSphere(level[0], level[1]) });
+        for (const auto& level : torusLevels)
+            meshes.push_back({ "torus " + std::to_string(level[0]) + "x" + std::to_string(level[1]),
+                generateTorus(level[0], level[1], 1.0f, 0.3f) });
+
+        bool ok = true;
+        printf("%-16s %9s %8s %8s %8s %8s %8s %8s %8s %10s\n", "shape", "triangles", "acmr", "atvr",
+            "acmr vc", "atvr vc", "acmr", "atvr", "ms", "same mesh");
+        for (NamedMesh& named : meshes)
+        {
+            VertexCacheStats before = analyzeVertexCache(named.mesh);
+
+            MeshData cacheOnly = named.mesh;
+            optimizeVertexCache(cacheOnly, false);
+            VertexCacheStats tipsified = analyzeVertexCache(cacheOnly);
+
+            MeshData optimized = named.mesh;
+            auto start = std::chrono::steady_clock::now();
+            optimizeMesh(optimized);
+            double ms = elapsedMs(start);
+            VertexCacheStats after = analyzeVertexCache(optimized);
+
+            bool same = canonicalTriangles(optimized) == canonicalTriangles(named.mesh);
+            ok = ok && same;
+            printf("%-16s %9zu %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %10s\n", named.name.c_str(),
+                named.mesh.indices.size() / 3, before.acmr, before.atvr, tipsified.acmr, tipsified.atvr,
+                after.acmr, after.atvr, ms, same ? "yes" : "NO");
+        }
+        printf("(vc = vertex cache only; last pair = cache + overdraw + fetch)\n");
+        return ok ? 0 : 1;
+    }
+
+    // Saca el fichero de la cache de páginas para medir una lectura en
+    // frío (solo Linux; en el resto la medida es siempre en caliente)
+    bool dropFromPageCache(const std::string& path)
+    {
+#ifdef __linux__
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        fdatasync(fd);
+        bool dropped = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+        close(fd);
+        return dropped;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    // ---------------------------------------------------
+    // Carga de una malla de ~100 MB: generar + subir frente a proyectar el
+    // fichero .mesh y pasar los punteros a glBufferData. La referencia es
+    // tocar una vez cada página del fichero (velocidad de page-in).
+    // ---------------------------------------------------
+    int runMeshFileBenchmark(const AppOptions&)
+    {
+        const int segments = 1700;
+        const std::string path = "mesh_cache/bench/sphere.mesh";
+        const VertexLayout& layout = defaultVertexLayout();
+        const std::uint64_t tag = meshFileTag("bench sphere");
+
+        auto start = std::chrono::steady_clock::now();
+        MeshData mesh = generateSphere(segments, segments);
+        double generateMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        Shape generated = createShapeFromVertices(mesh, layout);
+        glFinish();
+        double uploadMs = elapsedMs(start);
+        destroyShape(generated);
+
+        if (!saveMeshFile(path, tag, layout, { mesh }, { 0.0f }, 1.0f))
+            return 1;
+        mesh = MeshData{};
+
+        MappedFile probe(path);
+        double megabytes = probe.Size() / (1024.0 * 1024.0);
+        probe.Close();
+
+        // Page-in: una lectura por página
+        bool cold = dropFromPageCache(path);
+        start = std::chrono::steady_clock::now();
+        {
+            MappedFile file(path);
+            unsigned int sum = 0;
+            for (std::size_t offset = 0; offset < file.Size(); offset += 4096)
+                sum += file.Data()[offset];
+            if (sum == 1)
+                printf(" ");
+        }
+        double touchMs = elapsedMs(start);
+
+        auto load = [&](bool dropCache) {
+            if (dropCache)
+                dropFromPageCache(path);
+            auto loadStart = std::chrono::steady_clock::now();
+            LodChain chain;
+            bool loaded = loadMeshFile(path, tag, layout, chain);
+            glFinish();
+            double ms = elapsedMs(loadStart);
+            if (loaded)
+                destroyLodChain(chain);
+            return loaded ? ms : -1.0;
+            };
+        double coldMs = load(true);
+        double warmMs = load(false);
+
+        std::error_code error;
+        std::filesystem::remove_all("mesh_cache/bench", error);
+        if (coldMs < 0.0 || warmMs < 0.0)
+        {
+            printf("could not load %s\n", path.c_str());
+            return 1;
+        }
+
+        auto rate = [&](double ms) { return ms > 0.0 ? megabytes / (ms / 1000.0) : 0.0; };
+        printf("mesh file: %.1f MB (%s + %s), %s page cache\n", megabytes, positionFormatName(layout.position),
+            normalFormatName(layout.normal), cold ? "cold" : "warm (could not drop)");
+        printf("%-28s %10s %10s\n", "", "ms", "MB/s");
+        printf("%-28s %10.1f %10.1f\n", "generate + upload", generateMs + uploadMs, rate(generateMs + uploadMs));
+        printf("%-28s %10.1f %10.1f\n", "page-in (touch each page)", touchMs, rate(touchMs));
+        printf("%-28s %10.1f %10.1f\n", "mmap + glBufferData (cold)", coldMs, rate(coldMs));
+        printf("%-28s %10.1f %10.1f\n", "mmap + glBufferData (warm)", warmMs, rate(warmMs));
+        return 0;
+    }
+
+    // Escribe la malla como OBJ (v, vn y caras v//n), con los floats
+    // exactos para poder comparar el resultado de la carga
+    bool writeObj(const std::string& path, const MeshData& mesh)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        std::fprintf(file, "# bench sphere\no sphere\n");
+        for (std::size_t i = 0; i < mesh.VertexCount(); ++i)
+            std::fprintf(file, "v %.9g %.9g %.9g\n", mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+        for (std::size_t i = 0; i < mesh.VertexCount(); ++i)
+            std::fprintf(file, "vn %.9g %.9g %.9g\n", mesh.vertices[i * 6 + 3], mesh.vertices[i * 6 + 4], mesh.vertices[i * 6 + 5]);
+        for (std::size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+        {
+            unsigned int a = mesh.indices[t] + 1, b = mesh.indices[t + 1] + 1, c = mesh.indices[t + 2] + 1;
+            std::fprintf(file, "f %u//%u %u//%u %u//%u\n", a, a, b, b, c, c);
+        }
+        return std::fclose(file) == 0;
+    }
+
+    // ---------------------------------------------------
+    // Rendimiento (MB/s) del cargador OBJ de 1 a N hilos sobre una esfera
+    // de ~100 MB ya en la cache de páginas. El resultado de cada número
+    // de hilos debe ser idéntico al de un hilo y describir la misma
+    // superficie que la malla original.
+    // ---------------------------------------------------
+    int runObjLoaderBenchmark(const AppOptions&)
+    {
+        const int repetitions = 3;
+        const int segments = 768;
+        const std::string directory = "mesh_cache/bench";
+        const std::string path = directory + "/sphere.obj";
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        MeshData source = generateSphere(segments, segments);
+        if (!writeObj(path, source))
+        {
+            printf("could not write %s\n", path.c_str());
+            return 1;
+        }
+
+        MeshData reference;
+        ObjLoadStats stats{};
+        {
+            ThreadPool serial(1);
+            if (!loadObj(path, reference, serial, &stats))
+                return 1;
+        }
+        bool matchesSource = canonicalTriangles(reference) == canonicalTriangles(source);
+        source = MeshData{};
+
+        int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(maxThreads);
+
+        double megabytes = stats.bytes / (1024.0 * 1024.0);
+        printf("obj: %.1f MB, %zu triangles, %zu vertices, same surface as the source mesh: %s\n",
+            megabytes, stats.triangles, stats.vertices, matchesSource ? "yes" : "NO");
+        printf("%8s %12s %10s %12s %10s %10s\n", "threads", "ms", "MB/s", "Mtri/s", "speedup", "identical");
+
+        double baseline = 0.0;
+        bool allIdentical = true;
+        for (int threads : threadCounts)
+        {
+            ThreadPool pool(threads);
+            FrameProfiler::RollingStats loadMs(repetitions);
+            bool identical = true;
+            for (int i = 0; i < repetitions; ++i)
+            {
+                MeshData mesh;
+                auto start = std::chrono::steady_clock::now();
+                bool loaded = loadObj(path, mesh, pool);
+                loadMs.Add(elapsedMs(start));
+                identical = identical && loaded && sameMesh(mesh, reference);
+            }
+
+            double ms = loadMs.Percentile(50);
+            if (threads == 1)
+                baseline = ms;
+            printf("%8d %12.1f %10.1f %12.2f %9.2fx %10s\n", threads, ms,
+                ms > 0.0 ? megabytes / (ms / 1000.0) : 0.0, ms > 0.0 ? stats.triangles / (ms * 1000.0) : 0.0,
+                ms > 0.0 ? baseline / ms : 0.0, identical ? "yes" : "NO");
+            fflush(stdout);
+            allIdentical = allIdentical && identical;
+        }
+
+        std::filesystem::remove_all(directory, error);
+        return allIdentical && matchesSource ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Datos de instancia regenerados cada frame (de 1K a 100K
+    // instancias) subidos con glBufferSubData frente al anillo con
+    // fences, sin sincronizar y persistente. Se mide la subida, la CPU
+    // por frame y el total hasta que la GPU termina (MB/s efectivos).
+    // ---------------------------------------------------
+    int runStreamBufferBenchmark(const AppOptions&)
+    {
+        const int warmupFrames = 5;
+        const int measuredFrames = 30;
+        const int targetSize = 256;
+
+        Shader shader(loadVertexShader("src/shaders/instanced_vertex_shader.glsl"),
+            loadTextFile("src/shaders/instanced_fragment_shader.glsl"));
+        if (shader.GetId() == 0)
+            return 1;
+
+        Shape cube = createCube();
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+        glm::vec3 specular[4] = { glm::vec3(0.3f), glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.5f) };
+        float shininess[4] = { 8.0f, 32.0f, 64.0f, 4.0f };
+
+        Framebuffer target(targetSize, targetSize);
+        target.Bind();
+        shader.Bind();
+        shader.SetVec3(shader.GetUniform("materialSpecular"), specular, 4);
+        shader.SetFloat(shader.GetUniform("materialShininess"), shininess, 4);
+        shader.SetMat4("model", glm::mat4(1.0f));
+        shader.SetMat3("normalMatrix", glm::mat3(1.0f));
+
+        std::vector<StreamMode> modes = { StreamBufferSubData, StreamUnsynchronized };
+        if (streamModeSupported(StreamPersistent))
+            modes.push_back(StreamPersistent);
+
+        printf("renderer: %s, %dx%d, persistent mapping %s\n", glGetString(GL_RENDERER), targetSize, targetSize,
+            streamModeSupported(StreamPersistent) ? "available" : "not available (needs GL 4.4)");
+        printf("%10s %-16s %10s %12s %12s %12s %12s %8s\n", "instances", "mode", "MB/frame", "upload p50",
+            "cpu p50 ms", "cpu p95 ms", "MB/s", "waits");
+        for (int count = 1000; count <= 100000; count *= 10)
+        {
+            Scene scene = generateScene(count, 1, palette, 4, 1234u);
+            float distance = std::max(5.0f, scene.radius * 2.5f);
+            glm::vec3 eye(0.0f, 0.0f, distance);
+
+            FrameUniformBuffer frameUniforms;
+            FrameData frameData{};
+            frameData.view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            frameData.projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, distance + scene.radius + 10.0f);
+            frameData.viewPos = eye;
+            frameData.lightPos = glm::vec3(distance * 0.4f);
+            frameData.lightAmbient = glm::vec3(0.2f);
+            frameData.lightDiffuse = glm::vec3(0.7f);
+            frameData.lightSpecular = glm::vec3(1.0f);
+            frameUniforms.Update(frameData);
+
+            // Dos poses precalculadas que se alternan: así solo se mide la
+            // subida, no el cálculo de las matrices
+            std::vector<InstanceData> poses[2];
+            for (int pose = 0; pose < 2; ++pose)
+            {
+                glm::mat4 spin = glm::rotate(glm::mat4(1.0f), pose * 0.3f, glm::vec3(0.0f, 1.0f, 0.0f));
+                for (const SceneObject& object : scene.objects)
+                {
+                    glm::mat4 model = object.model * spin;
+                    InstanceData data;
+                    data.model = model * positionDecodeMatrix(cube);
+                    data.color = object.color;
+                    data.material = static_cast<float>(object.material);
+                    data.normalMatrix = computeNormalMatrix(model);
+                    poses[pose].push_back(data);
+                }
+            }
+            const std::size_t frameBytes = poses[0].size() * sizeof(InstanceData);
+
+            for (StreamMode mode : modes)
+            {
+                StreamBuffer stream(frameBytes, 3, sizeof(InstanceData), mode);
+                GLuint vao;
+                glGenVertexArrays(1, &vao);
+                cachedBindVertexArray(vao);
+                bindShapeVertices(cube);
+                cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cube.EBO);
+                cachedBindBuffer(GL_ARRAY_BUFFER, stream.GetId());
+
+                FrameProfiler::RollingStats upload(measuredFrames), cpu(measuredFrames);
+                std::chrono::steady_clock::time_point measuredStart;
+                for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+                {
+                    if (frame == warmupFrames)
+                    {
+                        glFinish();
+                        measuredStart = std::chrono::steady_clock::now();
+                    }
+                    auto start = std::chrono::steady_clock::now();
+
+                    std::size_t offset = 0;
+                    if (!stream.Write(poses[frame % 2].data(), frameBytes, offset))
+                        return 1;
+                    double uploadMs = elapsedMs(start);
+                    setupInstanceAttributes(offset);
+
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                    glDrawElementsInstanced(GL_TRIANGLES, cube.indexCount, cube.indexType, (void*)0, count);
+                    stream.EndFrame();
+                    frameUniforms.EndFrame();
+
+                    if (frame >= warmupFrames)
+                    {
+                        upload.Add(uploadMs);
+                        cpu.Add(elapsedMs(start));
+                    }
+                }
+                glFinish();
+                double totalMs = elapsedMs(measuredStart);
+
+                cachedDeleteVertexArrays(1, &vao);
+
+                double megabytes = frameBytes / (1024.0 * 1024.0);
+                printf("%10d %-16s %10.2f %12.3f %12.3f %12.3f %12.1f %8llu\n", count, streamModeName(stream.GetMode()),
+                    megabytes, upload.Percentile(50), cpu.Percentile(50), cpu.Percentile(95),
+                    totalMs > 0.0 ? megabytes * measuredFrames / (totalMs / 1000.0) : 0.0, stream.GetWaitCount());
+                fflush(stdout);
+            }
+        }
+
+        destroyShape(cube);
+        return 0;
+    }
+
+    // ---------------------------------------------------
+    // Cola de render con escenas mezcladas de las cuatro formas (1 de
+    // cada 8 objetos transparente): draws y cambios de estado en el
+    // orden de envío frente a ordenados y agrupados, y radix sort frente
+    // a std::sort con las mismas claves
+    // ---------------------------------------------------
+    int runRenderQueueBenchmark(const AppOptions&)
+    {
+        const int repetitions = 5;
+
+        Shader shader(loadVertexShader("src/shaders/instanced_vertex_shader.glsl"),
+            loadTextFile("src/shaders/instanced_fragment_shader.glsl"));
+        if (shader.GetId() == 0)
+            return 1;
+
+        std::vector<Shape> shapes = { createCube(), createSphere(24, 24), createPyramid(), createTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+
+        RenderQueue queue;
+        int program = queue.AddProgram(&shader);
+        std::vector<int> meshes;
+        for (const Shape& shape : shapes)
+            meshes.push_back(queue.AddMesh(shape));
+
+        printf("%10s %12s %12s %10s %10s %12s %12s %12s\n", "objects", "draws before", "changes bef",
+            "draws", "changes", "submit ms", "radix ms", "std::sort ms");
+        for (int count = 1000; count <= 1000000; count *= 10)
+        {
+            Scene scene = generateScene(count, static_cast<int>(shapes.size()), palette, 4, 1234u);
+            std::vector<InstanceData> instances(scene.objects.size());
+            glm::vec3 eye(0.0f, 0.0f, std::max(5.0f, scene.radius * 2.5f));
+
+            FrameProfiler::RollingStats submit(repetitions), radix(repetitions), reference(repetitions);
+            std::vector<SortEntry> entries;
+            for (int repetition = 0; repetition < repetitions; ++repetition)
+            {
+                auto start = std::chrono::steady_clock::now();
+                queue.Begin();
+                entries.clear();
+                for (size_t i = 0; i < scene.objects.size(); ++i)
+                {
+                    const SceneObject& object = scene.objects[i];
+                    RenderPass pass = i % 8 == 0 ? PassTransparent : PassOpaque;
+                    float depth = glm::length(eye - glm::vec3(object.model[3]));
+                    queue.Submit(pass, program, meshes[object.shapeType], object.material, depth, &instances[i]);
+                    entries.push_back(SortEntry{ makeSortKey(pass, program, meshes[object.shapeType],
+                        object.material, depth), static_cast<std::uint32_t>(i) });
+                }
+                submit.Add(elapsedMs(start));
+
+                queue.Prepare();
+                radix.Add(queue.GetStats().sortMs);
+
+                start = std::chrono::steady_clock::now();
+                std::sort(entries.begin(), entries.end(),
+                    [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+                reference.Add(elapsedMs(start));
+            }
+
+            const RenderQueueStats& stats = queue.GetStats();
+            printf("%10d %12llu %12llu %10llu %10llu %12.3f %12.3f %12.3f\n", count, stats.items,
+                stats.unsortedStateChanges, stats.drawCalls, stats.stateChanges, submit.Percentile(50),
+                radix.Percentile(50), reference.Percentile(50));
+            fflush(stdout);
+        }
+
+        for (Shape& shape : shapes)
+            destroyShape(shape);
+        return 0;
+    }
+
+    // ---------------------------------------------------
+    // Frustum culling de 1M objetos (escena de las cuatro formas) con la
+    // cámara dentro de la escena: cada variante SIMD en serie y la mejor
+    // repartida entre 1..N hilos. Todas deben dar la misma lista.
+    // ---------------------------------------------------
+    int runFrustumCullingBenchmark(const AppOptions&)
+    {
+        const int repetitions = 20;
+        const int objectCount = 1000000;
+
+        std::vector<ShapeBounds> shapeBounds = { computeBounds(generateCube()), computeBounds(generateSphere(24, 24)),
+            computeBounds(generatePyramid()), computeBounds(generateTorus(32, 16, 1.0f, 0.3f)) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f) };
+        Scene scene = generateScene(objectCount, static_cast<int>(shapeBounds.size()), palette, 4, 1234u);
+
+        CullBounds bounds;
+        bounds.Reserve(scene.objects.size());
+        for (const SceneObject& object : scene.objects)
+            bounds.Add(shapeBounds[object.shapeType], object.model);
+
+        // Desde el centro mirando en diagonal: parte de la escena queda
+        // detrás, a los lados y más allá del plano lejano
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.3f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, scene.radius);
+        Frustum frustum = extractFrustum(projection * view);
+
+        std::vector<std::uint32_t> reference(bounds.Size());
+        reference.resize(cullBounds(frustum, bounds, reference.data(), 0, bounds.Size(), CullScalar));
+
+        printf("objects: %d, visible: %zu (%.1f%%)\n", objectCount, reference.size(),
+            100.0 * reference.size() / objectCount);
+        printf("%-10s %8s %12s %12s %10s %10s\n", "kernel", "threads", "p50 ms", "Mobj/s", "speedup", "identical");
+
+        std::vector<std::uint32_t> visible(bounds.Size());
+        double scalarMs = 0.0;
+        bool allIdentical = true;
+        auto report = [&](const char* name, int threads, const FrameProfiler::RollingStats& times, bool identical) {
+            double p50 = times.Percentile(50);
+            if (scalarMs == 0.0)
+                scalarMs = p50;
+            printf("%-10s %8d %12.3f %12.1f %9.2fx %10s\n", name, threads, p50,
+                p50 > 0.0 ? objectCount / (p50 * 1000.0) : 0.0, p50 > 0.0 ? scalarMs / p50 : 0.0,
+                identical ? "yes" : "NO");
+            fflush(stdout);
+            allIdentical = allIdentical && identical;
+            };
+
+        const CullKernel kernels[] = { CullScalar, CullSSE2, CullAVX2 };
+        for (CullKernel kernel : kernels)
+        {
+            if (!cullKernelSupported(kernel))
+            {
+                printf("%-10s %8s\n", cullKernelName(kernel), "not supported");
+                continue;
+            }
+            FrameProfiler::RollingStats times(repetitions);
+            bool identical = true;
+            for (int r = 0; r < repetitions; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                std::size_t count = cullBounds(frustum, bounds, visible.data(), 0, bounds.Size(), kernel);
+                times.Add(elapsedMs(start));
+                identical = identical && count == reference.size() &&
+                    std::equal(reference.begin(), reference.end(), visible.begin());
+            }
+            report(cullKernelName(kernel), 1, times, identical);
+        }
+
+        int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(maxThreads);
+
+        for (int threads : threadCounts)
+        {
+            ThreadPool pool(threads);
+            FrameProfiler::RollingStats times(repetitions);
+            bool identical = true;
+            for (int r = 0; r < repetitions; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                std::size_t count = cullBoundsParallel(frustum, bounds, visible.data(), pool);
+                times.Add(elapsedMs(start));
+                identical = identical && count == reference.size() &&
+                    std::equal(reference.begin(), reference.end(), visible.begin());
+            }
+            report("parallel", threads, times, identical);
+        }
+        return allIdentical ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // BVH sobre 1M objetos: construcción de 1 a N hilos (el árbol debe
+    // salir igual), refit tras moverlos, objetos añadidos, culling
+    // jerárquico frente al plano y picking frente a fuerza bruta
+    // ---------------------------------------------------
+    int runBvhBenchmark(const AppOptions&)
+    {
+        const int repetitions = 5;
+        const int objectCount = 1000000;
+        const int addedCount = objectCount / 100;
+        const int rayCount = 10000;
+        const int bruteForceRays = 32;
+
+        // Mismas mallas que la escena del visor (nivel 2 de esfera y toro)
+        std::vector<MeshData> meshes = { generateCube(), generateSphere(32, 24), generatePyramid(),
+            generateTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<PickMesh> pickMeshes;
+        std::vector<ShapeBounds> shapeBounds;
+        for (const MeshData& mesh : meshes)
+        {
+            pickMeshes.emplace_back(mesh);
+            shapeBounds.push_back(computeBounds(mesh));
+        }
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f) };
+        Scene scene = generateScene(objectCount + addedCount, static_cast<int>(meshes.size()), palette, 4, 1234u);
+
+        CullBounds bounds;
+        bounds.Reserve(scene.objects.size());
+        for (const SceneObject& object : scene.objects)
+            bounds.Add(shapeBounds[object.shapeType], object.model);
+        std::vector<BvhBox> allBoxes = boxesFromBounds(bounds);
+        std::vector<BvhBox> boxes(allBoxes.begin(), allBoxes.begin() + objectCount);
+
+        int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<int> threadCounts;
+        for (int threads = 1; threads < maxThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(maxThreads);
+
+        bool allIdentical = true;
+        printf("objects: %d, node size: %zu bytes\n", objectCount, sizeof(BvhNode));
+        printf("%-12s %8s %12s %10s %10s %6s %9s %10s\n", "build", "threads", "p50 ms", "nodes", "leaves", "depth",
+            "SAH cost", "identical");
+        Bvh reference;
+        for (int threads : threadCounts)
+        {
+            ThreadPool pool(threads);
+            FrameProfiler::RollingStats times(repetitions);
+            Bvh bvh;
+            for (int r = 0; r < repetitions; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                bvh.Build(boxes, pool);
+                times.Add(elapsedMs(start));
+            }
+            if (reference.GetNodes().empty())
+                reference = bvh;
+            bool identical = bvh.GetIndices() == reference.GetIndices() &&
+                bvh.GetNodes().size() == reference.GetNodes().size() &&
+                std::memcmp(bvh.GetNodes().data(), reference.GetNodes().data(),
+                    bvh.GetNodes().size() * sizeof(BvhNode)) == 0;
+            allIdentical = allIdentical && identical;
+            BvhStats stats = bvh.ComputeStats();
+            printf("%-12s %8d %12.3f %10zu %10zu %6d %9.2f %10s\n", "binned SAH", threads, times.Percentile(50),
+                stats.nodes, stats.leaves, stats.depth, stats.sahCost, identical ? "yes" : "NO");
+            fflush(stdout);
+        }
+
+        // Actualizaciones: refit tras mover todos los objetos y añadir un
+        // 1% más, cada una frente a reconstruir el árbol entero
+        printf("\n%-28s %12s %9s\n", "update", "p50 ms", "SAH cost");
+        auto reportUpdate = [&](const char* name, const FrameProfiler::RollingStats& times, const Bvh& bvh) {
+            printf("%-28s %12.3f %9.2f\n", name, times.Percentile(50), bvh.ComputeStats().sahCost);
+            fflush(stdout);
+            };
+        {
+            std::vector<BvhBox> moved = boxes;
+            for (std::size_t i = 0; i < moved.size(); ++i)
+            {
+                glm::vec3 offset(0.3f * std::sin(i * 0.37f), 0.3f * std::cos(i * 0.11f), 0.3f * std::sin(i * 0.07f));
+                moved[i].min += offset;
+                moved[i].max += offset;
+            }
+            FrameProfiler::RollingStats refitTimes(repetitions), rebuildTimes(repetitions);
+            Bvh refitted = reference;
+            Bvh rebuilt;
+            for (int r = 0; r < repetitions; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                refitted.Refit(moved);
+                refitTimes.Add(elapsedMs(start));
+                start = std::chrono::steady_clock::now();
+                rebuilt.Build(moved);
+                rebuildTimes.Add(elapsedMs(start));
+            }
+            reportUpdate("refit (all objects moved)", refitTimes, refitted);
+            reportUpdate("rebuild (all objects moved)", rebuildTimes, rebuilt);
+        }
+        {
+            FrameProfiler::RollingStats appendTimes(repetitions), rebuildTimes(repetitions);
+            Bvh appended;
+            Bvh rebuilt;
+            for (int r = 0; r < repetitions; ++r)
+            {
+                appended = reference;
+                auto start = std::chrono::steady_clock::now();
+                appended.Append(allBoxes);
+                appendTimes.Add(elapsedMs(start));
+                start = std::chrono::steady_clock::now();
+                rebuilt.Build(allBoxes);
+                rebuildTimes.Add(elapsedMs(start));
+            }
+            reportUpdate("append 1% objects", appendTimes, appended);
+            reportUpdate("rebuild with 1% more", rebuildTimes, rebuilt);
+        }
+
+        // Culling: mismo frustum que el benchmark frustum-culling
+        CullBounds baseBounds;
+        baseBounds.Reserve(objectCount);
+        for (int i = 0; i < objectCount; ++i)
+            baseBounds.Add(shapeBounds[scene.objects[i].shapeType], scene.objects[i].model);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(1.0f, 0.3f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, scene.radius);
+        Frustum frustum = extractFrustum(projection * view);
+        {
+            std::vector<std::uint32_t> flat(objectCount), hierarchical(objectCount);
+            FrameProfiler::RollingStats flatTimes(repetitions * 4), bvhTimes(repetitions * 4);
+            std::size_t flatCount = 0, bvhCount = 0;
+            for (int r = 0; r < repetitions * 4; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                flatCount = cullBoundsParallel(frustum, baseBounds, flat.data());
+                flatTimes.Add(elapsedMs(start));
+                start = std::chrono::steady_clock::now();
+                bvhCount = reference.Cull(frustum, baseBounds, hierarchical.data());
+                bvhTimes.Add(elapsedMs(start));
+            }
+            std::sort(hierarchical.begin(), hierarchical.begin() + bvhCount);
+            bool identical = flatCount == bvhCount && std::equal(flat.begin(), flat.begin() + flatCount,
+                hierarchical.begin());
+            allIdentical = allIdentical && identical;
+            printf("\n%-28s %12s %10s %10s\n", "frustum culling", "p50 ms", "visible", "identical");
+            printf("%-28s %12.3f %10zu %10s\n", "flat SIMD (all threads)", flatTimes.Percentile(50), flatCount, "-");
+            printf("%-28s %12.3f %10zu %10s\n", "BVH hierarchical (1 thread)", bvhTimes.Percentile(50), bvhCount,
+                identical ? "yes" : "NO");
+            fflush(stdout);
+        }
+
+        // Picking: rayos desde fuera de la escena hacia puntos al azar de
+        // dentro; la referencia prueba la caja de cada objeto y todos los
+        // triángulos de su malla
+        {
+            std::mt19937 rng(99u);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            glm::vec3 origin(0.0f, 0.0f, scene.radius * 1.5f);
+            std::vector<glm::vec3> directions(rayCount);
+            for (glm::vec3& direction : directions)
+                direction = glm::vec3(unit(rng), unit(rng), unit(rng)) * (0.5f * scene.radius) - origin;
+
+            std::vector<PickHit> hits(rayCount);
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < rayCount; ++r)
+                hits[r] = pickObject(reference, scene.objects, pickMeshes, origin, directions[r]);
+            double bvhMs = elapsedMs(start);
+
+            const std::vector<BvhBox> baseBoxes(allBoxes.begin(), allBoxes.begin() + objectCount);
+            bool identical = true;
+            int hitCount = 0;
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < bruteForceRays; ++r)
+            {
+                PickHit best{ -1, std::numeric_limits<float>::infinity() };
+                glm::vec3 inverseDirection = 1.0f / directions[r];
+                for (int i = 0; i < objectCount; ++i)
+                {
+                    if (rayBoxDistance(baseBoxes[i], origin, inverseDirection) >= best.distance)
+                        continue;
+                    glm::vec3 localOrigin = origin;
+                    glm::vec3 localDirection = directions[r];
+                    rayToObjectSpace(scene.objects[i].model, localOrigin, localDirection);
+                    float distance = pickMeshes[scene.objects[i].shapeType].IntersectAll(localOrigin, localDirection,
+                        best.distance);
+                    if (distance < best.distance)
+                        best = PickHit{ i, distance };
+                }
+                identical = identical && best.object == hits[r].object && best.distance == hits[r].distance;
+            }
+            double bruteMs = elapsedMs(start);
+            for (const PickHit& hit : hits)
+                hitCount += hit.object >= 0;
+            allIdentical = allIdentical && identical;
+
+            printf("\n%-28s %8s %12s %12s %10s\n", "ray picking", "rays", "hits", "rays/s", "identical");
+            printf("%-28s %8d %12d %12.0f %10s\n", "BVH + per-mesh BVH", rayCount, hitCount,
+                rayCount / (bvhMs / 1000.0), "-");
+            printf("%-28s %8d %12s %12.0f %10s\n", "brute force", bruteForceRays, "-",
+                bruteForceRays / (bruteMs / 1000.0), identical ? "yes" : "NO");
+        }
+        return allIdentical ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Escena densa vista desde fuera, sin y con oclusión por hardware:
+    // tiempo de frame, objetos de la primera pasada y contadores de las
+    // consultas. La imagen del último frame debe ser la misma.
+    // ---------------------------------------------------
+    int runOcclusionBenchmark(const AppOptions& options)
+    {
+        const int warmupFrames = 5;
+        const int measuredFrames = 20;
+
+        Shader shader(loadVertexShader("src/shaders/instanced_vertex_shader.glsl"),
+            loadTextFile("src/shaders/instanced_fragment_shader.glsl"));
+        if (shader.GetId() == 0)
+            return 1;
+
+        std::vector<Shape> shapes = { createCube(), createSphere(24, 24), createPyramid(), createTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+        glm::vec3 specular[4] = { glm::vec3(0.3f), glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.5f) };
+        float shininess[4] = { 8.0f, 32.0f, 64.0f, 4.0f };
+
+        Framebuffer target(options.width, options.height);
+        target.Bind();
+        shader.Bind();
+        shader.SetVec3(shader.GetUniform("materialSpecular"), specular, 4);
+        shader.SetFloat(shader.GetUniform("materialShininess"), shininess, 4);
+        shader.SetMat4("model", glm::mat4(1.0f));
+        shader.SetMat3("normalMatrix", glm::mat3(1.0f));
+
+        FrameUniformBuffer frameUniforms;
+        FrameData frameData{};
+        frameData.lightAmbient = glm::vec3(0.2f);
+        frameData.lightDiffuse = glm::vec3(0.7f);
+        frameData.lightSpecular = glm::vec3(1.0f);
+
+        RenderQueue queue;
+        int program = queue.AddProgram(&shader);
+        std::vector<int> meshes;
+        for (const Shape& shape : shapes)
+            meshes.push_back(queue.AddMesh(shape));
+
+        GLuint timer;
+        glGenQueries(1, &timer);
+
+        bool allIdentical = true;
+        printf("renderer: %s, %dx%d\n", glGetString(GL_RENDERER), options.width, options.height);
+        printf("%10s %-10s %12s %12s %10s %10s %10s %10s %10s\n", "objects", "variant", "cpu p50 ms", "gpu p50 ms",
+            "pass 1", "tested", "culled", "false neg", "identical");
+        for (int count = 1000; count <= 100000; count *= 10)
+        {
+            Scene scene = generateScene(count, static_cast<int>(shapes.size()), palette, 4, 1234u);
+            std::vector<InstanceData> instances;
+            std::vector<std::uint32_t> objects;
+            CullBounds bounds;
+            bounds.Reserve(scene.objects.size());
+            for (std::uint32_t i = 0; i < scene.objects.size(); ++i)
+            {
+                const SceneObject& object = scene.objects[i];
+                bounds.Add(shapes[object.shapeType].bounds, object.model);
+                InstanceData data;
+                data.model = object.model * positionDecodeMatrix(shapes[object.shapeType]);
+                data.color = object.color;
+                data.material = static_cast<float>(object.material);
+                data.normalMatrix = computeNormalMatrix(object.model);
+                instances.push_back(data);
+                objects.push_back(i);
+            }
+
+            float distance = std::max(5.0f, scene.radius * 2.5f);
+            glm::vec3 eye(0.0f, 0.0f, distance);
+            frameData.view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            frameData.projection = glm::perspective(glm::radians(45.0f),
+                (float)options.width / (float)options.height, 0.1f, distance + scene.radius + 10.0f);
+            frameData.viewPos = eye;
+            frameData.lightPos = glm::vec3(distance * 0.4f);
+            frameUniforms.Update(frameData);
+
+            std::vector<unsigned char> reference;
+            std::vector<std::uint32_t> hidden;
+            for (int variant = 0; variant < 2; ++variant)
+            {
+                std::unique_ptr<OcclusionCuller> occlusion;
+                if (variant == 1)
+                {
+                    occlusion = std::make_unique<OcclusionCuller>(scene.objects.size());
+                    if (!occlusion->IsValid())
+                        return 1;
+                }
+
+                FrameProfiler::RollingStats cpu(measuredFrames), gpu(measuredFrames);
+                OcclusionStats totals{};
+                unsigned long long firstPass = 0;
+                for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    glBeginQuery(GL_TIME_ELAPSED, timer);
+                    glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                    if (occlusion)
+                        occlusion->BeginFrame();
+                    hidden.clear();
+                    queue.Begin();
+                    for (std::uint32_t i : objects)
+                    {
+                        if (occlusion && occlusion->IsOccluded(i))
+                        {
+                            hidden.push_back(i);
+                            continue;
+                        }
+                        const SceneObject& object = scene.objects[i];
+                        queue.Submit(PassOpaque, program, meshes[object.shapeType], object.material,
+                            -(frameData.view * object.model[3]).z, &instances[i]);
+                    }
+                    queue.Execute();
+                    std::size_t submitted = queue.GetItemCount();
+
+                    if (occlusion)
+                    {
+                        occlusion->Test(objects.data(), objects.size(), bounds,
+                            frameData.projection * frameData.view, eye, 0.2f);
+                        queue.Begin();
+                        for (std::uint32_t i : hidden)
+                        {
+                            const SceneObject& object = scene.objects[i];
+                            queue.Submit(PassOpaque, program, meshes[object.shapeType], object.material,
+                                -(frameData.view * object.model[3]).z, &instances[i], occlusion->GetConditionQuery(i));
+                        }
+                        queue.Execute();
+                    }
+                    queue.EndFrame();
+                    glEndQuery(GL_TIME_ELAPSED);
+                    glFinish();
+
+                    GLuint64 gpuNs = 0;
+                    glGetQueryObjectui64v(timer, GL_QUERY_RESULT, &gpuNs);
+                    if (frame >= warmupFrames)
+                    {
+                        cpu.Add(elapsedMs(start));
+                        gpu.Add(gpuNs / 1.0e6);
+                        firstPass += submitted;
+                        if (occlusion)
+                        {
+                            totals.tested += occlusion->GetStats().tested;
+                            totals.culled += occlusion->GetStats().culled;
+                            totals.falseNegatives += occlusion->GetStats().falseNegatives;
+                        }
+                    }
+                }
+
+                std::vector<unsigned char> pixels(static_cast<std::size_t>(options.width) * options.height * 4);
+                glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                bool identical = variant == 0 || pixels == reference;
+                if (variant == 0)
+                    reference.swap(pixels);
+                allIdentical = allIdentical && identical;
+
+                printf("%10d %-10s %12.3f %12.3f %10llu %10llu %10llu %10llu %10s\n", count,
+                    occlusion ? "occlusion" : "frustum", cpu.Percentile(50), gpu.Percentile(50),
+                    firstPass / measuredFrames, totals.tested / measuredFrames, totals.culled / measuredFrames,
+                    totals.falseNegatives, variant == 0 ? "-" : identical ? "yes" : "NO");
+                fflush(stdout);
+            }
+            frameUniforms.EndFrame();
+        }
+
+        glDeleteQueries(1, &timer);
+        for (Shape& shape : shapes)
+            destroyShape(shape);
+        return allIdentical ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Clustered forward shading: reparto de 4096 luces en la CPU con cada
+    // variante SIMD y de 1 a N hilos (mismas listas), comprobación de que
+    // ningún punto pierde una luz que lo alcanza y tiempo de frame de una
+    // escena de 1000 objetos con 0 a 4096 luces. Como referencia, un solo
+    // cluster con todas las luces (forward clásico) hasta 256.
+    // ---------------------------------------------------
+    int runClusteredLightingBenchmark(const AppOptions& options)
+    {
+        const int repetitions = 20;
+        const int lightCount = 4096;
+        const int samplePoints = 20000;
+        const int warmupFrames = 3;
+        const int measuredFrames = 10;
+        const int maxUnclusteredLights = 256;
+
+        std::vector<Shape> shapes = { createCube(), createSphere(24, 24), createPyramid(), createTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+        Scene scene = generateScene(1000, static_cast<int>(shapes.size()), palette, 4, 1234u);
+
+        // La misma cámara y las mismas luces que --scene 1000 --lights n
+        float distance = std::max(5.0f, scene.radius * 2.5f);
+        glm::vec3 eye(0.0f, 0.0f, distance);
+        glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f),
+            (float)options.width / (float)options.height, 0.1f, distance + scene.radius + 10.0f);
+        auto sceneLights = [&](int count) {
+            return generateLights(count, scene.radius, scene.radius * std::cbrt(8.0f / count), 99u);
+            };
+
+        std::vector<PointLight> lights = sceneLights(lightCount);
+        ThreadPool serial(1);
+        LightClusters reference;
+        reference.Assign(lights, view, projection, serial, CullScalar);
+        const ClusterStats& referenceStats = reference.GetStats();
+        printf("lights: %d, clusters: %d (%zu with lights), indices: %zu, max per cluster: %zu\n", lightCount,
+            reference.GetClusterCount(), referenceStats.activeClusters, referenceStats.indices,
+            referenceStats.maxPerCluster);
+
+        // Puntos al azar dentro del frustum: cada luz que alcanza el punto
+        // debe estar en la lista de su cluster
+        std::mt19937 rng(7u);
+        std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+        long long checked = 0, missed = 0;
+        for (int p = 0; p < samplePoints; ++p)
+        {
+            glm::vec3 point = scene.radius * glm::vec3(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+            glm::vec4 clip = projection * view * glm::vec4(point, 1.0f);
+            if (std::fabs(clip.x) > clip.w || std::fabs(clip.y) > clip.w || std::fabs(clip.z) > clip.w)
+                continue;
+            glm::vec3 viewPoint = glm::vec3(view * glm::vec4(point, 1.0f));
+            int cluster = reference.FindCluster(viewPoint);
+            const std::uint32_t* range = &reference.GetRanges()[2 * cluster];
+            const std::uint16_t* list = reference.GetIndices().data() + range[0];
+            for (int l = 0; l < lightCount; ++l)
+            {
+                if (glm::length(lights[l].position - point) >= lights[l].radius)
+                    continue;
+                ++checked;
+                missed += std::find(list, list + range[1], static_cast<std::uint16_t>(l)) == list + range[1];
+            }
+        }
+        printf("coverage: %lld light/point pairs checked, %lld missing\n\n", checked, missed);
+        bool allIdentical = missed == 0;
+
+        auto sameLists = [&](const LightClusters& clusters) {
+            return clusters.GetRanges() == reference.GetRanges() && clusters.GetIndices() == reference.GetIndices();
+            };
+        printf("%-10s %8s %12s %10s %10s\n", "assign", "threads", "p50 ms", "speedup", "identical");
+        double scalarMs = 0.0;
+        auto report = [&](const char* name, int threads, const FrameProfiler::RollingStats& times, bool identical) {
+            double p50 = times.Percentile(50);
+            if (scalarMs == 0.0)
+                scalarMs = p50;
+            printf("%-10s %8d %12.3f %9.2fx %10s\n", name, threads, p50, p50 > 0.0 ? scalarMs / p50 : 0.0,
+                identical ? "yes" : "NO");
+            fflush(stdout);
+            allIdentical = allIdentical && identical;
+            };
+
+        const CullKernel kernels[] = { CullScalar, CullSSE2, CullAVX2 };
+        for (CullKernel kernel : kernels)
+        {
+            if (!cullKernelSupported(kernel))
+            {
+                printf("%-10s %8s\n", cullKernelName(kernel), "not supported");
+                continue;
+            }
+            LightClusters clusters;
+            FrameProfiler::RollingStats times(repetitions);
+            for (int r = 0; r < repetitions; ++r)
+            {
+                clusters.Assign(lights, view, projection, serial, kernel);
+                times.Add(clusters.GetStats().assignMs);
+            }
+            report(cullKernelName(kernel), 1, times, sameLists(clusters));
+        }
+
+        int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int threads = 1; ; threads = std::min(threads * 2, maxThreads))
+        {
+            ThreadPool pool(threads);
+            LightClusters clusters;
+            FrameProfiler::RollingStats times(repetitions);
+            for (int r = 0; r < repetitions; ++r)
+            {
+                clusters.Assign(lights, view, projection, pool);
+                times.Add(clusters.GetStats().assignMs);
+            }
+            report("parallel", threads, times, sameLists(clusters));
+            if (threads == maxThreads)
+                break;
+        }
+
+        // Tiempo de frame: sin luces puntuales (programa sin
+        // CLUSTERED_LIGHTING) y con 1 a 4096
+        std::string vertexSource = loadVertexShader("src/shaders/instanced_vertex_shader.glsl");
+        std::string fragmentSource = loadTextFile("src/shaders/instanced_fragment_shader.glsl");
+        Shader plain(vertexSource, fragmentSource);
+        Shader clustered(vertexSource, injectDefines(fragmentSource, "#define CLUSTERED_LIGHTING\n"));
+        if (plain.GetId() == 0 || clustered.GetId() == 0)
+            return 1;
+        glm::vec3 specular[4] = { glm::vec3(0.3f), glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.5f) };
+        float shininess[4] = { 8.0f, 32.0f, 64.0f, 4.0f };
+        for (Shader* shader : { &plain, &clustered })
+        {
+            shader->Bind();
+            shader->SetVec3(shader->GetUniform("materialSpecular"), specular, 4);
+            shader->SetFloat(shader->GetUniform("materialShininess"), shininess, 4);
+            shader->SetMat4("model", glm::mat4(1.0f));
+            shader->SetMat3("normalMatrix", glm::mat3(1.0f));
+        }
+        ClusterUniforms clusterUniforms = resolveClusterUniforms(clustered);
+
+        Framebuffer target(options.width, options.height);
+        target.Bind();
+        InstancedScene instanced(shapes, scene);
+        FrameUniformBuffer frameUniforms;
+        FrameData frameData{};
+        frameData.view = view;
+        frameData.projection = projection;
+        frameData.viewPos = eye;
+        frameData.lightPos = glm::vec3(distance * 0.4f);
+        frameData.lightAmbient = glm::vec3(0.2f);
+        frameData.lightDiffuse = glm::vec3(0.7f);
+        frameData.lightSpecular = glm::vec3(1.0f);
+        frameUniforms.Update(frameData);
+
+        GLuint query;
+        glGenQueries(1, &query);
+        printf("\nrenderer: %s, %dx%d, objects: %zu\n", glGetString(GL_RENDERER), options.width, options.height,
+            scene.objects.size());
+        printf("%8s %12s %12s %12s %12s %14s\n", "lights", "assign ms", "cpu p50 ms", "gpu p50 ms", "max/cluster",
+            "1 cluster gpu");
+        for (int count = 0; count <= lightCount; count = count == 0 ? 1 : count * 4)
+        {
+            std::vector<PointLight> frameLights = count > 0 ? sceneLights(count) : std::vector<PointLight>();
+            Shader& shader = count > 0 ? clustered : plain;
+            FrameProfiler::RollingStats cpu(measuredFrames), gpu(measuredFrames), assign(measuredFrames);
+            auto measure = [&](LightClusters& clusters) {
+                for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    glBeginQuery(GL_TIME_ELAPSED, query);
+                    glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                    shader.Bind();
+                    if (count > 0)
+                    {
+                        clusters.Assign(frameLights, view, projection);
+                        clusters.Upload(frameLights);
+                        clusters.Apply(shader, clusterUniforms, options.width, options.height);
+                    }
+                    instanced.Draw();
+                    glEndQuery(GL_TIME_ELAPSED);
+                    glFinish();
+
+                    GLuint64 gpuNs = 0;
+                    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                    if (frame >= warmupFrames)
+                    {
+                        cpu.Add(elapsedMs(start));
+                        gpu.Add(gpuNs / 1.0e6);
+                        assign.Add(count > 0 ? clusters.GetStats().assignMs : 0.0);
+                    }
+                }
+                };
+
+            LightClusters clusters;
+            measure(clusters);
+            double assignMs = assign.Percentile(50), cpuMs = cpu.Percentile(50), gpuMs = gpu.Percentile(50);
+            char unclustered[32] = "-";
+            if (count > 0 && count <= maxUnclusteredLights)
+            {
+                LightClusters single(1, 1, 1);
+                measure(single);
+                snprintf(unclustered, sizeof(unclustered), "%.3f", gpu.Percentile(50));
+            }
+            printf("%8d %12.3f %12.3f %12.3f %12zu %14s\n", count, assignMs, cpuMs, gpuMs,
+                count > 0 ? clusters.GetStats().maxPerCluster : 0, unclustered);
+            fflush(stdout);
+        }
+        frameUniforms.EndFrame();
+
+        glDeleteQueries(1, &query);
+        for (Shape& shape : shapes)
+            destroyShape(shape);
+        return allIdentical ? 0 : 1;
+    }
+
+    // ---------------------------------------------------
+    // Forward (clustered) frente a deferred con 1000 y 10000 objetos y
+    // de 0 a 4096 luces. El forward paga las luces por cada fragmento
+    // dibujado, también los que luego se tapan; el deferred paga la
+    // geometría una vez y cada luz por los píxeles que cubre. La
+    // diferencia entre las dos imágenes debe quedarse en la precisión del
+    // G-buffer (normal de 10 bits, posición desde la profundidad).
+    // ---------------------------------------------------
+    int runDeferredBenchmark(const AppOptions& options)
+    {
+        const int warmupFrames = 2;
+        const int measuredFrames = 5;
+        const int objectCounts[] = { 1000, 10000 };
+        const int lightCounts[] = { 0, 64, 512, 4096 };
+
+        std::vector<Shape> shapes = { createCube(), createSphere(24, 24), createPyramid(), createTorus(32, 16, 1.0f, 0.3f) };
+        std::vector<glm::vec3> palette = { glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+        glm::vec3 specular[4] = { glm::vec3(0.3f), glm::vec3(0.7f), glm::vec3(1.0f), glm::vec3(0.5f) };
+        float shininess[4] = { 8.0f, 32.0f, 64.0f, 4.0f };
+
+        std::string vertexSource = loadVertexShader("src/shaders/instanced_vertex_shader.glsl");
+        std::string fragmentSource = loadTextFile("src/shaders/instanced_fragment_shader.glsl");
+        Shader plain(vertexSource, fragmentSource);
+        Shader clustered(vertexSource, injectDefines(fragmentSource, "#define CLUSTERED_LIGHTING\n"));
+        Shader gbuffer(vertexSource, injectDefines(fragmentSource, "#define DEFERRED_GBUFFER\n"));
+        DeferredRenderer deferred;
+        if (plain.GetId() == 0 || clustered.GetId() == 0 || gbuffer.GetId() == 0 || !deferred.IsValid())
+            return 1;
+        for (Shader* shader : { &plain, &clustered, &gbuffer })
+        {
+            shader->Bind();
+            shader->SetVec3(shader->GetUniform("materialSpecular"), specular, 4);
+            shader->SetFloat(shader->GetUniform("materialShininess"), shininess, 4);
+            shader->SetMat4("model", glm::mat4(1.0f));
+            shader->SetMat3("normalMatrix", glm::mat3(1.0f));
+        }
+        ClusterUniforms clusterUniforms = resolveClusterUniforms(clustered);
+
+        Framebuffer target(options.width, options.height);
+        FrameUniformBuffer frameUniforms;
+        GLuint query;
+        glGenQueries(1, &query);
+        std::vector<unsigned char> forwardPixels(static_cast<std::size_t>(options.width) * options.height * 4);
+        std::vector<unsigned char> deferredPixels(forwardPixels.size());
+
+        printf("renderer: %s, %dx%d\n", glGetString(GL_RENDERER), options.width, options.height);
+        printf("%8s %8s %-9s %12s %12s %10s %10s\n", "objects", "lights", "path", "cpu p50 ms", "gpu p50 ms",
+            "max diff", "mean diff");
+        for (int objectCount : objectCounts)
+        {
+            Scene scene = generateScene(objectCount, static_cast<int>(shapes.size()), palette, 4, 1234u);
+            InstancedScene instanced(shapes, scene);
+
+            // La misma cámara y las mismas luces que --scene n --lights m
+            float distance = std::max(5.0f, scene.radius * 2.5f);
+            FrameData frameData{};
+            frameData.viewPos = glm::vec3(0.0f, 0.0f, distance);
+            frameData.view = glm::lookAt(frameData.viewPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            frameData.projection = glm::perspective(glm::radians(45.0f),
+                (float)options.width / (float)options.height, 0.1f, distance + scene.radius + 10.0f);
+            frameData.lightPos = glm::vec3(distance * 0.4f);
+            frameData.lightAmbient = glm::vec3(0.2f);
+            frameData.lightDiffuse = glm::vec3(0.7f);
+            frameData.lightSpecular = glm::vec3(1.0f);
+            frameUniforms.Update(frameData);
+
+            for (int lightCount : lightCounts)
+            {
+                std::vector<PointLight> lights = lightCount > 0
+                    ? generateLights(lightCount, scene.radius, scene.radius * std::cbrt(8.0f / lightCount), 99u)
+                    : std::vector<PointLight>();
+                LightClusters clusters;
+
+                for (int path = 0; path < 2; ++path)
+                {
+                    bool isDeferred = path == 1;
+                    FrameProfiler::RollingStats cpu(measuredFrames), gpu(measuredFrames);
+                    for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame)
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        glBeginQuery(GL_TIME_ELAPSED, query);
+                        if (isDeferred)
+                            deferred.BeginGeometry(options.width, options.height);
+                        else
+                            target.Bind();
+                        glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
+                        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                        if (isDeferred)
+                        {
+                            gbuffer.Bind();
+                            instanced.Draw();
+                            deferred.Light(lights, frameData.view, frameData.projection, target.GetId());
+                        }
+                        else if (lightCount > 0)
+                        {
+                            clustered.Bind();
+                            clusters.Assign(lights, frameData.view, frameData.projection);
+                            clusters.Upload(lights);
+                            clusters.Apply(clustered, clusterUniforms, options.width, options.height);
+                            instanced.Draw();
+                        }
+                        else
+                        {
+                            plain.Bind();
+                            instanced.Draw();
+                        }
+                        glEndQuery(GL_TIME_ELAPSED);
+                        glFinish();
+
+                        GLuint64 gpuNs = 0;
+                        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpuNs);
+                        if (frame >= warmupFrames)
+                        {
+                            cpu.Add(elapsedMs(start));
+                            gpu.Add(gpuNs / 1.0e6);
+                        }
+                    }
+
+                    std::vector<unsigned char>& pixels = isDeferred ? deferredPixels : forwardPixels;
+                    cachedBindFramebuffer(GL_READ_FRAMEBUFFER, target.GetId());
+                    glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                    char maxDiff[16] = "-", meanDiff[16] = "-";
+                    if (isDeferred)
+                    {
+                        int largest = 0;
+                        double total = 0.0;
+                        for (std::size_t i = 0; i < pixels.size(); ++i)
+                        {
+                            int difference = std::abs(static_cast<int>(pixels[i]) - forwardPixels[i]);
+                            largest = std::max(largest, difference);
+                            total += difference;
+                        }
+                        snprintf(maxDiff, sizeof(maxDiff), "%d", largest);
+                        snprintf(meanDiff, sizeof(meanDiff), "%.4f", total / pixels.size());
+                    }
+                    printf("%8d %8d %-9s %12.3f %12.3f %10s %10s\n", objectCount, lightCount,
+                        isDeferred ? "deferred" : "forward", cpu.Percentile(50), gpu.Percentile(50), maxDiff, meanDiff);
+                    fflush(stdout);
+                }
+            }
+            frameUniforms.EndFrame();
+        }
+
+        glDeleteQueries(1, &query);
+        for (Shape& shape : shapes)
+            destroyShape(shape);
+        return 0;
+    }
+
+    const Benchmark benchmarks[] = {
+        { "shader-cache", "program creation with a cold vs warm binary cache", true, runShaderCacheBenchmark },
+        { "instancing", "frame time of the instanced scene from 1 to 1M instances", true, runInstancingBenchmark },
+        { "normal-matrix", "per-vertex inverse() vs a CPU normal matrix uniform", true, runNormalMatrixBenchmark },
+        { "mesh-generation", "sphere/torus generation scaling from 1 to N threads", false, runMeshGenerationBenchmark },
+        { "sincos", "SIMD sincos accuracy vs libm and throughput per kernel", false, runSinCosBenchmark },
+        { "vertex-format", "quantization error and size of every vertex layout", false, runVertexFormatBenchmark },
+        { "mesh-optimizer", "ACMR/ATVR of every shape before and after optimization", false, runMeshOptimizerBenchmark },
+        { "mesh-file", "load a ~100 MB mesh with mmap vs generating it", true, runMeshFileBenchmark },
+        { "obj-loader", "OBJ loading throughput (MB/s) from 1 to N threads", false, runObjLoaderBenchmark },
+        { "stream-buffer", "per-frame instance data: glBufferSubData vs fenced ring buffer", true, runStreamBufferBenchmark },
+        { "render-queue", "draws and state changes of mixed scenes before/after the sorted queue", true, runRenderQueueBenchmark },
+        { "frustum-culling", "SIMD frustum culling of 1M objects, serial kernels and 1 to N threads", false, runFrustumCullingBenchmark },
+        { "bvh", "BVH build from 1 to N threads, refit/append, hierarchical culling and ray picking", false, runBvhBenchmark },
+        { "occlusion", "frame time of a dense scene with hardware occlusion queries vs frustum only", true, runOcclusionBenchmark },
+        { "clustered-lighting", "CPU light assignment per kernel and thread count, frame time from 0 to 4096 lights", true, runClusteredLightingBenchmark },
+        { "deferred", "forward clustered vs deferred shading from 1000 to 10000 objects and 0 to 4096 lights", true, runDeferredBenchmark },
+    };
+}
+
+const Benchmark* findBenchmark(const std::string& name)
+{
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (name == benchmark.name)
+            return &benchmark;
+    }
+    return nullptr;
+}
+
+void listBenchmarks()
+{
+    for (const Benchmark& benchmark : benchmarks)
+        printf("  %-16s %s\n", benchmark.name, benchmark.description);
+}
@@ -0,0 +1,20 @@
+//src/Benchmark.h
+#pragma once
+#include <string>
+#include "Options.h"
+
+// ---------------------------------------------------
+// Benchmarks integrados: opengltriangle --bench <nombre>
+// Los que necesitan OpenGL se ejecutan con el contexto ya creado;
+// el resto se ejecuta antes de abrir ninguna ventana.
+// ---------------------------------------------------
+struct Benchmark {
+    const char* name;
+    const char* description;
+    bool needsGL;
+    int (*run)(const AppOptions& options);
+};
+
+// nullptr si no existe ningún benchmark con ese nombre
+const Benchmark* findBenchmark(const std::string& name);
+void listBenchmarks();
@@ -0,0 +1,635 @@
+// src/Bvh.cpp
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "Bvh.h"
+
+namespace {
+    const int kBins = 16;
+    // Hasta kMinLeafSize objetos siempre es hoja; hasta kMaxLeafSize,
+    // si el SAH no encuentra una división más barata
+    const std::size_t kMinLeafSize = 2;
+    const std::size_t kMaxLeafSize = 4;
+    // Coste de visitar un nodo frente al de probar un objeto
+    const float kTraversalCost = 1.0f;
+    // Por debajo de esta profundidad se parte por la mitad del tramo:
+    // acota la altura del árbol y la pila de los recorridos
+    const int kMaxSahDepth = 48;
+    const int kStackSize = 128;
+    const int kMaxAppends = 8;
+    // Tramos con más objetos: el binning se reparte entre los hilos
+    const std::size_t kParallelBinning = 65536;
+    const std::size_t kBinningChunk = 16384;
+    // Los subárboles de las tareas no bajan de este tamaño
+    const std::size_t kMinTaskSize = 4096;
+
+    const float kInfinity = std::numeric_limits<float>::infinity();
+
+    BvhBox emptyBox()
+    {
+        return BvhBox{ glm::vec3(kInfinity), glm::vec3(-kInfinity) };
+    }
+
+    void grow(BvhBox& box, const BvhBox& other)
+    {
+        box.min = glm::min(box.min, other.min);
+        box.max = glm::max(box.max, other.max);
+    }
+
+    void grow(BvhBox& box, const glm::vec3& point)
+    {
+        box.min = glm::min(box.min, point);
+        box.max = glm::max(box.max, point);
+    }
+
+    // Mitad del área de la superficie (0 si está vacía)
+    float halfArea(const BvhBox& box)
+    {
+        glm::vec3 size = box.max - box.min;
+        if (size.x < 0.0f)
+            return 0.0f;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    glm::vec3 centroidOf(const BvhBox& box)
+    {
+        return 0.5f * (box.min + box.max);
+    }
+
+    BvhBox nodeBox(const BvhNode& node)
+    {
+        return BvhBox{ glm::vec3(node.boundsMin[0], node.boundsMin[1], node.boundsMin[2]),
+            glm::vec3(node.boundsMax[0], node.boundsMax[1], node.boundsMax[2]) };
+    }
+
+    BvhNode makeNode(const BvhBox& box)
+    {
+        return BvhNode{ { box.min.x, box.min.y, box.min.z }, 0, { box.max.x, box.max.y, box.max.z }, 0 };
+    }
+
+    int binIndex(float value, float minimum, float scale, int binCount)
+    {
+        return std::min(static_cast<int>((value - minimum) * scale), binCount - 1);
+    }
+
+    struct Bin {
+        BvhBox bounds;
+        std::uint32_t count;
+    };
+
+    struct Bins {
+        Bin bins[3][kBins];
+
+        void Clear(int binCount)
+        {
+            for (auto& axis : bins)
+                for (int b = 0; b < binCount; ++b)
+                    axis[b] = Bin{ emptyBox(), 0 };
+        }
+    };
+
+    // Con pocos objetos no hacen falta tantos planos candidatos
+    int binCountFor(std::size_t count)
+    {
+        return static_cast<int>(std::min<std::size_t>(kBins, std::max<std::size_t>(4, count)));
+    }
+
+    // Objeto durante la construcción: caja y centroide van junto al índice
+    // para que las particiones lean y muevan memoria seguida
+    struct Reference {
+        BvhBox box;
+        glm::vec3 centroid;
+        std::uint32_t object;
+    };
+
+    // Tramo [begin, end) de indices con su caja y la de sus centroides
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+        BvhBox bounds;
+        BvhBox centroids;
+        int depth;
+    };
+
+    // ---------------------------------------------------
+    // Construcción de un tramo de indices: las ramas de arriba se dividen
+    // en el hilo que llama (con el binning repartido) hasta quedar en
+    // tareas; cada tarea construye su subárbol en orden en profundidad y
+    // al final se copian todos en su sitio.
+    // ---------------------------------------------------
+    class Builder {
+    public:
+        Builder(const std::vector<BvhBox>& boxes, std::vector<std::uint32_t>& indices, ThreadPool& pool)
+            : boxes(boxes), indices(indices), pool(pool), base(0)
+        {
+        }
+
+        void Run(std::size_t begin, std::size_t end, std::vector<BvhNode>& out)
+        {
+            base = begin;
+            references.resize(end - begin);
+            Range root{ begin, end, emptyBox(), emptyBox(), 0 };
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const BvhBox& box = boxes[indices[i]];
+                Reference& reference = references[i - base];
+                reference = Reference{ box, centroidOf(box), indices[i] };
+                grow(root.bounds, box);
+                grow(root.centroids, reference.centroid);
+            }
+
+            const std::size_t taskSize = std::max(kMinTaskSize,
+                (end - begin) / (static_cast<std::size_t>(pool.GetThreadCount()) * 8));
+            int rootTop = BuildTop(root, taskSize);
+
+            taskNodes.resize(tasks.size());
+            pool.ParallelFor(static_cast<int>(tasks.size()), 1, [&](int first, int last) {
+                for (int task = first; task < last; ++task)
+                    BuildSubtree(tasks[task], taskNodes[task]);
+                });
+
+            out.clear();
+            Emit(rootTop, out);
+            for (std::size_t i = begin; i < end; ++i)
+                indices[i] = references[i - base].object;
+        }
+
+    private:
+        struct TopNode {
+            BvhBox bounds;
+            int left;
+            int right;
+            int task; // >= 0: el subárbol lo construye esa tarea
+        };
+
+        void ComputeBins(const Range& range, int binCount, Bins& result, bool parallel) const
+        {
+            glm::vec3 extent = range.centroids.max - range.centroids.min;
+            glm::vec3 scale(0.0f);
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (extent[axis] > 0.0f)
+                    scale[axis] = binCount / extent[axis];
+            }
+
+            auto binChunk = [&](std::size_t first, std::size_t last, Bins& bins) {
+                bins.Clear(binCount);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    const Reference& reference = references[i - base];
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        int b = binIndex(reference.centroid[axis], range.centroids.min[axis], scale[axis], binCount);
+                        grow(bins.bins[axis][b].bounds, reference.box);
+                        ++bins.bins[axis][b].count;
+                    }
+                }
+                };
+
+            const std::size_t count = range.end - range.begin;
+            if (!parallel || count < kParallelBinning)
+            {
+                binChunk(range.begin, range.end, result);
+                return;
+            }
+
+            // Bins por bloque fijo y suma en orden: mínimos, máximos y
+            // cuentas no dependen de cómo se repartan los bloques
+            const std::size_t chunks = (count + kBinningChunk - 1) / kBinningChunk;
+            std::vector<Bins> partial(chunks);
+            pool.ParallelFor(static_cast<int>(chunks), 1, [&](int first, int last) {
+                for (int chunk = first; chunk < last; ++chunk)
+                {
+                    std::size_t begin = range.begin + static_cast<std::size_t>(chunk) * kBinningChunk;
+                    binChunk(begin, std::min(begin + kBinningChunk, range.end), partial[chunk]);
+                }
+                });
+            result = partial[0];
+            for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    for (int b = 0; b < binCount; ++b)
+                    {
+                        Bin& bin = result.bins[axis][b];
+                        const Bin& other = partial[chunk].bins[axis][b];
+                        grow(bin.bounds, other.bounds);
+                        bin.count += other.count;
+                    }
+                }
+            }
+        }
+
+        // Divide el tramo en left y right; false si debe quedar como hoja
+        bool Split(const Range& range, Range& left, Range& right, bool parallel)
+        {
+            const std::size_t count = range.end - range.begin;
+            if (count <= kMinLeafSize)
+                return false;
+
+            glm::vec3 extent = range.centroids.max - range.centroids.min;
+            if (range.depth < kMaxSahDepth && std::max(extent.x, std::max(extent.y, extent.z)) > 0.0f)
+            {
+                const int binCount = binCountFor(count);
+                Bins bins;
+                ComputeBins(range, binCount, bins, parallel);
+
+                // Coste de cada plano entre bins: área * objetos a cada lado
+                float bestCost = kInfinity;
+                int bestAxis = -1;
+                int bestBin = 0;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    if (extent[axis] <= 0.0f)
+                        continue;
+                    const Bin* axisBins = bins.bins[axis];
+                    float rightArea[kBins];
+                    std::uint32_t rightCount[kBins];
+                    BvhBox accumulated = emptyBox();
+                    std::uint32_t accumulatedCount = 0;
+                    for (int b = binCount - 1; b > 0; --b)
+                    {
+                        grow(accumulated, axisBins[b].bounds);
+                        accumulatedCount += axisBins[b].count;
+                        rightArea[b] = halfArea(accumulated);
+                        rightCount[b] = accumulatedCount;
+                    }
+                    accumulated = emptyBox();
+                    accumulatedCount = 0;
+                    for (int b = 1; b < binCount; ++b)
+                    {
+                        grow(accumulated, axisBins[b - 1].bounds);
+                        accumulatedCount += axisBins[b - 1].count;
+                        if (accumulatedCount == 0 || rightCount[b] == 0)
+                            continue;
+                        float cost = halfArea(accumulated) * accumulatedCount + rightArea[b] * rightCount[b];
+                        if (cost < bestCost)
+                        {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestBin = b;
+                        }
+                    }
+                }
+
+                if (bestAxis >= 0)
+                {
+                    float parentArea = halfArea(range.bounds);
+                    float splitCost = kTraversalCost + (parentArea > 0.0f ? bestCost / parentArea : 0.0f);
+                    if (count <= kMaxLeafSize && splitCost >= static_cast<float>(count))
+                        return false;
+
+                    left = Range{ range.begin, range.begin, emptyBox(), emptyBox(), range.depth + 1 };
+                    right = Range{ range.end, range.end, emptyBox(), emptyBox(), range.depth + 1 };
+                    for (int b = 0; b < binCount; ++b)
+                        grow(b < bestBin ? left.bounds : right.bounds, bins.bins[bestAxis][b].bounds);
+
+                    // Partición en una pasada que junta de paso las cajas
+                    // de centroides de cada lado
+                    const float minimum = range.centroids.min[bestAxis];
+                    const float scale = binCount / extent[bestAxis];
+                    while (left.end < right.begin)
+                    {
+                        Reference& reference = references[left.end - base];
+                        if (binIndex(reference.centroid[bestAxis], minimum, scale, binCount) < bestBin)
+                        {
+                            grow(left.centroids, reference.centroid);
+                            ++left.end;
+                        }
+                        else
+                        {
+                            grow(right.centroids, reference.centroid);
+                            std::swap(reference, references[--right.begin - base]);
+                        }
+                    }
+                    return true;
+                }
+            }
+
+            if (count <= kMaxLeafSize)
+                return false;
+
+            // Centroides iguales o demasiado profundo: mitad del tramo
+            left = Range{ range.begin, range.begin + count / 2, emptyBox(), emptyBox(), range.depth + 1 };
+            right = Range{ left.end, range.end, emptyBox(), emptyBox(), range.depth + 1 };
+            for (Range* side : { &left, &right })
+            {
+                for (std::size_t i = side->begin; i < side->end; ++i)
+                {
+                    grow(side->bounds, references[i - base].box);
+                    grow(side->centroids, references[i - base].centroid);
+                }
+            }
+            return true;
+        }
+
+        int BuildTop(const Range& range, std::size_t taskSize)
+        {
+            int index = static_cast<int>(top.size());
+            top.push_back(TopNode{ range.bounds, -1, -1, -1 });
+
+            Range left, right;
+            if (range.end - range.begin <= taskSize || !Split(range, left, right, true))
+            {
+                top[index].task = static_cast<int>(tasks.size());
+                tasks.push_back(range);
+                return index;
+            }
+            int leftTop = BuildTop(left, taskSize);
+            int rightTop = BuildTop(right, taskSize);
+            top[index].left = leftTop;
+            top[index].right = rightTop;
+            return index;
+        }
+
+        void BuildSubtree(const Range& range, std::vector<BvhNode>& out)
+        {
+            const std::size_t index = out.size();
+            out.push_back(makeNode(range.bounds));
+
+            Range left, right;
+            if (!Split(range, left, right, false))
+            {
+                out[index].rightOrFirst = static_cast<std::uint32_t>(range.begin);
+                out[index].count = static_cast<std::uint32_t>(range.end - range.begin);
+                return;
+            }
+            BuildSubtree(left, out);
+            out[index].rightOrFirst = static_cast<std::uint32_t>(out.size());
+            BuildSubtree(right, out);
+        }
+
+        // Nodos de arriba en orden en profundidad; los de cada tarea se
+        // copian desplazando sus índices de hijo derecho
+        void Emit(int topIndex, std::vector<BvhNode>& out) const
+        {
+            const TopNode& node = top[topIndex];
+            if (node.task >= 0)
+            {
+                const std::uint32_t base = static_cast<std::uint32_t>(out.size());
+                for (BvhNode subtreeNode : taskNodes[node.task])
+                {
+                    if (subtreeNode.count == 0)
+                        subtreeNode.rightOrFirst += base;
+                    out.push_back(subtreeNode);
+                }
+                return;
+            }
+            const std::size_t index = out.size();
+            out.push_back(makeNode(node.bounds));
+            Emit(node.left, out);
+            out[index].rightOrFirst = static_cast<std::uint32_t>(out.size());
+            Emit(node.right, out);
+        }
+
+        const std::vector<BvhBox>& boxes;
+        std::vector<std::uint32_t>& indices;
+        ThreadPool& pool;
+        std::vector<Reference> references; // posiciones [base, base + size) de indices
+        std::size_t base;
+        std::vector<TopNode> top;
+        std::vector<Range> tasks;
+        std::vector<std::vector<BvhNode>> taskNodes;
+    };
+}
+
+std::vector<BvhBox> boxesFromBounds(const CullBounds& bounds)
+{
+    std::vector<BvhBox> boxes(bounds.Size());
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        glm::vec3 center(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]);
+        glm::vec3 extent(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]);
+        boxes[i] = BvhBox{ center - extent, center + extent };
+    }
+    return boxes;
+}
+
+float rayBoxDistance(const BvhBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection)
+{
+    // Slabs: intervalo del rayo dentro de cada par de planos
+    glm::vec3 t0 = (box.min - origin) * inverseDirection;
+    glm::vec3 t1 = (box.max - origin) * inverseDirection;
+    glm::vec3 near = glm::min(t0, t1);
+    glm::vec3 far = glm::max(t0, t1);
+    float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+    float exit = std::min(std::min(far.x, far.y), far.z);
+    return enter <= exit ? enter : kInfinity;
+}
+
+void Bvh::Build(const std::vector<BvhBox>& boxes, ThreadPool& pool)
+{
+    nodes.clear();
+    indices.resize(boxes.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    builtObjects = boxes.size();
+    appendedObjects = 0;
+    appendCount = 0;
+    if (boxes.empty())
+        return;
+
+    Builder builder(boxes, indices, pool);
+    builder.Run(0, boxes.size(), nodes);
+}
+
+void Bvh::Refit(const std::vector<BvhBox>& boxes)
+{
+    // Los hijos van siempre detrás del padre: basta recorrer al revés
+    for (std::size_t i = nodes.size(); i-- > 0; )
+    {
+        BvhNode& node = nodes[i];
+        BvhBox box = emptyBox();
+        if (node.count > 0)
+        {
+            for (std::uint32_t k = 0; k < node.count; ++k)
+                grow(box, boxes[indices[node.rightOrFirst + k]]);
+        }
+        else
+        {
+            grow(box, nodeBox(nodes[i + 1]));
+            grow(box, nodeBox(nodes[node.rightOrFirst]));
+        }
+        node = BvhNode{ { box.min.x, box.min.y, box.min.z }, node.rightOrFirst,
+            { box.max.x, box.max.y, box.max.z }, node.count };
+    }
+}
+
+void Bvh::Append(const std::vector<BvhBox>& boxes, ThreadPool& pool)
+{
+    const std::size_t first = indices.size();
+    if (boxes.size() <= first)
+        return;
+    const std::size_t added = boxes.size() - first;
+    if (nodes.empty() || appendCount >= kMaxAppends || (appendedObjects + added) * 4 > builtObjects)
+    {
+        Build(boxes, pool);
+        return;
+    }
+
+    indices.resize(boxes.size());
+    std::iota(indices.begin() + first, indices.end(), static_cast<std::uint32_t>(first));
+    std::vector<BvhNode> subtree;
+    Builder builder(boxes, indices, pool);
+    builder.Run(first, boxes.size(), subtree);
+
+    // Raíz nueva, el árbol anterior (desplazado un nodo) y el subárbol de
+    // los añadidos: solo se copian nodos, sin volver a evaluar el SAH
+    BvhBox rootBox = nodeBox(nodes[0]);
+    grow(rootBox, nodeBox(subtree[0]));
+    const std::uint32_t subtreeBase = static_cast<std::uint32_t>(1 + nodes.size());
+
+    std::vector<BvhNode> merged;
+    merged.reserve(1 + nodes.size() + subtree.size());
+    merged.push_back(makeNode(rootBox));
+    merged[0].rightOrFirst = subtreeBase;
+    for (BvhNode node : nodes)
+    {
+        if (node.count == 0)
+            node.rightOrFirst += 1;
+        merged.push_back(node);
+    }
+    for (BvhNode node : subtree)
+    {
+        if (node.count == 0)
+            node.rightOrFirst += subtreeBase;
+        merged.push_back(node);
+    }
+    nodes.swap(merged);
+    appendedObjects += added;
+    ++appendCount;
+}
+
+std::size_t Bvh::Cull(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible) const
+{
+    if (nodes.empty())
+        return 0;
+
+    glm::vec3 absNormals[6];
+    for (int p = 0; p < 6; ++p)
+        absNormals[p] = glm::abs(glm::vec3(frustum.planes[p]));
+
+    // Cada entrada lleva los planos que aún cortan a su nodo (bit p)
+    struct Entry {
+        std::uint32_t node;
+        unsigned planes;
+    };
+    Entry stack[kStackSize];
+    int top = 0;
+    stack[top++] = Entry{ 0, 0x3Fu };
+
+    std::size_t count = 0;
+    while (top > 0)
+    {
+        const Entry entry = stack[--top];
+        const BvhNode& node = nodes[entry.node];
+        unsigned planes = entry.planes;
+        if (planes != 0)
+        {
+            BvhBox box = nodeBox(node);
+            glm::vec3 center = 0.5f * (box.min + box.max);
+            glm::vec3 extent = 0.5f * (box.max - box.min);
+            bool outside = false;
+            for (int p = 0; p < 6 && !outside; ++p)
+            {
+                if (!(planes & (1u << p)))
+                    continue;
+                float distance = glm::dot(glm::vec3(frustum.planes[p]), center) + frustum.planes[p].w;
+                float reach = glm::dot(absNormals[p], extent);
+                outside = distance + reach < 0.0f;
+                if (distance - reach >= 0.0f)
+                    planes &= ~(1u << p);
+            }
+            if (outside)
+                continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (std::uint32_t k = 0; k < node.count; ++k)
+            {
+                std::uint32_t object = indices[node.rightOrFirst + k];
+                if (planes == 0 || !isOutsideFrustum(frustum, bounds, object))
+                    visible[count++] = object;
+            }
+            continue;
+        }
+        stack[top++] = Entry{ node.rightOrFirst, planes };
+        stack[top++] = Entry{ entry.node + 1, planes };
+    }
+    return count;
+}
+
+float Bvh::Intersect(const glm::vec3& origin, const glm::vec3& direction, float tMax,
+    const std::function<float(std::uint32_t, float)>& hitObject) const
+{
+    if (nodes.empty())
+        return tMax;
+
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    struct Entry {
+        std::uint32_t node;
+        float distance; // entrada del rayo en la caja del nodo
+    };
+    Entry stack[kStackSize];
+    int top = 0;
+    float rootDistance = rayBoxDistance(nodeBox(nodes[0]), origin, inverseDirection);
+    if (rootDistance < tMax)
+        stack[top++] = Entry{ 0, rootDistance };
+
+    while (top > 0)
+    {
+        const Entry entry = stack[--top];
+        // Un impacto más cercano puede haber dejado atrás este nodo
+        if (entry.distance >= tMax)
+            continue;
+        const BvhNode& node = nodes[entry.node];
+        if (node.count > 0)
+        {
+            for (std::uint32_t k = 0; k < node.count; ++k)
+                tMax = std::min(tMax, hitObject(indices[node.rightOrFirst + k], tMax));
+            continue;
+        }
+
+        Entry nearChild{ entry.node + 1, rayBoxDistance(nodeBox(nodes[entry.node + 1]), origin, inverseDirection) };
+        Entry farChild{ node.rightOrFirst, rayBoxDistance(nodeBox(nodes[node.rightOrFirst]), origin, inverseDirection) };
+        if (farChild.distance < nearChild.distance)
+            std::swap(nearChild, farChild);
+        // El lejano se apila primero: el cercano sale antes y acorta tMax
+        if (farChild.distance < tMax)
+            stack[top++] = farChild;
+        if (nearChild.distance < tMax)
+            stack[top++] = nearChild;
+    }
+    return tMax;
+}
+
+BvhStats Bvh::ComputeStats() const
+{
+    BvhStats stats{ nodes.size(), 0, 0, 0.0f };
+    if (nodes.empty())
+        return stats;
+
+    const float rootArea = halfArea(nodeBox(nodes[0]));
+    double cost = 0.0;
+    std::vector<std::pair<std::uint32_t, int>> stack = { { 0u, 1 } };
+    while (!stack.empty())
+    {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+        const BvhNode& node = nodes[index];
+        stats.depth = std::max(stats.depth, depth);
+        float area = halfArea(nodeBox(node));
+        if (node.count > 0)
+        {
+            ++stats.leaves;
+            cost += static_cast<double>(area) * node.count;
+            continue;
+        }
+        cost += static_cast<double>(area) * kTraversalCost;
+        stack.push_back({ node.rightOrFirst, depth + 1 });
+        stack.push_back({ index + 1, depth + 1 });
+    }
+    stats.sahCost = rootArea > 0.0f ? static_cast<float>(cost / rootArea) : 0.0f;
+    return stats;
+}
@@ -0,0 +1,84 @@
+//src/Bvh.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Culling.h"
+#include "ThreadPool.h"
+
+// Caja alineada de un objeto (o de un nodo) en el espacio del árbol
+struct BvhBox {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Cajas de los volúmenes de culling (centro -/+ semiejes)
+std::vector<BvhBox> boxesFromBounds(const CullBounds& bounds);
+
+// Distancia de entrada del rayo a la caja (0 si empieza dentro) o
+// infinito si no la corta. inverseDirection = 1 / dirección.
+float rayBoxDistance(const BvhBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection);
+
+// ---------------------------------------------------
+// Nodo de 32 bytes: dos por línea de caché. Los nodos van en orden en
+// profundidad, así que el hijo izquierdo de un nodo interior es siempre
+// el siguiente y solo se guarda el derecho. Los objetos de una hoja son
+// un tramo seguido de GetIndices().
+// ---------------------------------------------------
+struct BvhNode {
+    float boundsMin[3];
+    std::uint32_t rightOrFirst; // interior: hijo derecho; hoja: primer índice
+    float boundsMax[3];
+    std::uint32_t count;        // 0 = interior; hoja: número de objetos
+};
+static_assert(sizeof(BvhNode) == 32, "BvhNode must stay 32 bytes");
+
+struct BvhStats {
+    std::size_t nodes;
+    std::size_t leaves;
+    int depth;
+    float sahCost; // coste esperado de un rayo (1 por nodo, 1 por objeto)
+};
+
+// ---------------------------------------------------
+// Jerarquía de volúmenes sobre las cajas de muchos objetos. Se construye
+// con SAH por bins: las ramas grandes reparten el binning entre los
+// hilos y los subárboles restantes se construyen a la vez, uno por
+// tarea. El árbol es el mismo con cualquier número de hilos.
+// ---------------------------------------------------
+class Bvh {
+public:
+    void Build(const std::vector<BvhBox>& boxes, ThreadPool& pool = ThreadPool::Shared());
+    // Los objetos se movieron: recalcula las cajas de abajo arriba sin
+    // cambiar la topología (la calidad baja si se mueven mucho)
+    void Refit(const std::vector<BvhBox>& boxes);
+    // Objetos añadidos al final de boxes: se construye un subárbol solo
+    // para ellos y se cuelga junto al actual bajo una raíz nueva. Si los
+    // añadidos pasan de una cuarta parte se reconstruye entero.
+    void Append(const std::vector<BvhBox>& boxes, ThreadPool& pool = ThreadPool::Shared());
+
+    // Los mismos objetos que cullBounds, en el orden de las hojas. Los
+    // nodos enteros dentro de un plano dejan de probarlo en sus hijos y
+    // los que quedan dentro de todos se aceptan sin pruebas.
+    std::size_t Cull(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible) const;
+
+    // Recorre las hojas que corta el rayo, de la más cercana a la más
+    // lejana. hitObject(objeto, tMax) devuelve la distancia de su impacto
+    // (o tMax si no hay); devuelve la menor de todas o tMax.
+    float Intersect(const glm::vec3& origin, const glm::vec3& direction, float tMax,
+        const std::function<float(std::uint32_t, float)>& hitObject) const;
+
+    std::size_t GetObjectCount() const { return indices.size(); }
+    const std::vector<BvhNode>& GetNodes() const { return nodes; }
+    const std::vector<std::uint32_t>& GetIndices() const { return indices; }
+    BvhStats ComputeStats() const;
+
+private:
+    std::vector<BvhNode> nodes;
+    std::vector<std::uint32_t> indices;
+    std::size_t builtObjects = 0;   // objetos en el último Build
+    std::size_t appendedObjects = 0;
+    int appendCount = 0;
+};
@@ -0,0 +1,545 @@
+// src/ClusteredLighting.cpp
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include "ClusteredLighting.h"
+#include "GLStateCache.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLUSTERS_HAS_SSE2 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Igual que en Culling.cpp: AVX2 con el atributo target en GCC/Clang y
+// elegido en ejecución
+#if defined(CLUSTERS_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CLUSTERS_HAS_AVX2 1
+#define CLUSTERS_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(CLUSTERS_HAS_SSE2) && defined(__AVX2__)
+#define CLUSTERS_HAS_AVX2 1
+#define CLUSTERS_AVX2_TARGET
+#endif
+
+namespace {
+    // Formato de cada texture buffer: luces (posición + alcance, color),
+    // rango por cluster y listas de índices
+    const GLenum kTextureFormats[3] = { GL_RGBA32F, GL_RG32UI, GL_R16UI };
+    const GLuint kTextureUnits[3] = { ClusterLightsUnit, ClusterGridUnit, ClusterIndicesUnit };
+
+    // Distancia de value a [low, high] (<= 0 dentro): la misma operación
+    // en todas las variantes
+    inline float outsideDistance(float value, float low, float high)
+    {
+        return std::max(low - value, value - high);
+    }
+
+    // Posiciones de las esferas (centro en value, radio radius) que
+    // cortan la franja [low, high]
+    std::size_t filterSlabScalar(const float* value, const float* radius, std::size_t begin, std::size_t end,
+        float low, float high, std::uint16_t* kept)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (outsideDistance(value[i], low, high) <= radius[i])
+                kept[count++] = static_cast<std::uint16_t>(i);
+        }
+        return count;
+    }
+
+    // Índices de las esferas que tocan la caja: distancia al cuadrado del
+    // centro a la caja frente al radio al cuadrado
+    struct ClusterBox {
+        float minX, maxX, minY, maxY, minDepth, maxDepth;
+    };
+
+    std::size_t touchBoxScalar(const float* x, const float* y, const float* depth, const float* radius,
+        const std::uint16_t* ids, std::size_t begin, std::size_t end, const ClusterBox& box, std::uint16_t* out)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            float dx = std::max(outsideDistance(x[i], box.minX, box.maxX), 0.0f);
+            float dy = std::max(outsideDistance(y[i], box.minY, box.maxY), 0.0f);
+            float dz = std::max(outsideDistance(depth[i], box.minDepth, box.maxDepth), 0.0f);
+            float distance = dx * dx + dy * dy;
+            distance = distance + dz * dz;
+            if (distance <= radius[i] * radius[i])
+                out[count++] = ids[i];
+        }
+        return count;
+    }
+
+#ifdef CLUSTERS_HAS_SSE2
+    unsigned lowestSetBit(unsigned mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    std::size_t filterSlabSSE2(const float* value, const float* radius, std::size_t count,
+        float low, float high, std::uint16_t* kept)
+    {
+        const __m128 lowV = _mm_set1_ps(low);
+        const __m128 highV = _mm_set1_ps(high);
+        std::size_t total = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 v = _mm_loadu_ps(value + i);
+            __m128 outside = _mm_max_ps(_mm_sub_ps(lowV, v), _mm_sub_ps(v, highV));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(outside, _mm_loadu_ps(radius + i))));
+            while (mask)
+            {
+                kept[total++] = static_cast<std::uint16_t>(i + lowestSetBit(mask));
+                mask &= mask - 1;
+            }
+        }
+        return total + filterSlabScalar(value, radius, i, count, low, high, kept + total);
+    }
+
+    std::size_t touchBoxSSE2(const float* x, const float* y, const float* depth, const float* radius,
+        const std::uint16_t* ids, std::size_t count, const ClusterBox& box, std::uint16_t* out)
+    {
+        const __m128 minX = _mm_set1_ps(box.minX), maxX = _mm_set1_ps(box.maxX);
+        const __m128 minY = _mm_set1_ps(box.minY), maxY = _mm_set1_ps(box.maxY);
+        const __m128 minZ = _mm_set1_ps(box.minDepth), maxZ = _mm_set1_ps(box.maxDepth);
+        const __m128 zero = _mm_setzero_ps();
+        std::size_t total = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            __m128 vz = _mm_loadu_ps(depth + i);
+            __m128 r = _mm_loadu_ps(radius + i);
+            __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, vx), _mm_sub_ps(vx, maxX)), zero);
+            __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, vy), _mm_sub_ps(vy, maxY)), zero);
+            __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, vz), _mm_sub_ps(vz, maxZ)), zero);
+            __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(dz, dz));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(distance, _mm_mul_ps(r, r))));
+            while (mask)
+            {
+                out[total++] = ids[i + lowestSetBit(mask)];
+                mask &= mask - 1;
+            }
+        }
+        return total + touchBoxScalar(x, y, depth, radius, ids, i, count, box, out + total);
+    }
+#endif
+
+#ifdef CLUSTERS_HAS_AVX2
+    CLUSTERS_AVX2_TARGET
+    std::size_t filterSlabAVX2(const float* value, const float* radius, std::size_t count,
+        float low, float high, std::uint16_t* kept)
+    {
+        const __m256 lowV = _mm256_set1_ps(low);
+        const __m256 highV = _mm256_set1_ps(high);
+        std::size_t total = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 v = _mm256_loadu_ps(value + i);
+            __m256 outside = _mm256_max_ps(_mm256_sub_ps(lowV, v), _mm256_sub_ps(v, highV));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(
+                _mm256_cmp_ps(outside, _mm256_loadu_ps(radius + i), _CMP_LE_OQ)));
+            while (mask)
+            {
+                kept[total++] = static_cast<std::uint16_t>(i + lowestSetBit(mask));
+                mask &= mask - 1;
+            }
+        }
+        return total + filterSlabScalar(value, radius, i, count, low, high, kept + total);
+    }
+
+    CLUSTERS_AVX2_TARGET
+    std::size_t touchBoxAVX2(const float* x, const float* y, const float* depth, const float* radius,
+        const std::uint16_t* ids, std::size_t count, const ClusterBox& box, std::uint16_t* out)
+    {
+        const __m256 minX = _mm256_set1_ps(box.minX), maxX = _mm256_set1_ps(box.maxX);
+        const __m256 minY = _mm256_set1_ps(box.minY), maxY = _mm256_set1_ps(box.maxY);
+        const __m256 minZ = _mm256_set1_ps(box.minDepth), maxZ = _mm256_set1_ps(box.maxDepth);
+        const __m256 zero = _mm256_setzero_ps();
+        std::size_t total = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 vx = _mm256_loadu_ps(x + i);
+            __m256 vy = _mm256_loadu_ps(y + i);
+            __m256 vz = _mm256_loadu_ps(depth + i);
+            __m256 r = _mm256_loadu_ps(radius + i);
+            __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minX, vx), _mm256_sub_ps(vx, maxX)), zero);
+            __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minY, vy), _mm256_sub_ps(vy, maxY)), zero);
+            __m256 dz = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minZ, vz), _mm256_sub_ps(vz, maxZ)), zero);
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(dz, dz));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(
+                _mm256_cmp_ps(distance, _mm256_mul_ps(r, r), _CMP_LE_OQ)));
+            while (mask)
+            {
+                out[total++] = ids[i + lowestSetBit(mask)];
+                mask &= mask - 1;
+            }
+        }
+        return total + touchBoxScalar(x, y, depth, radius, ids, i, count, box, out + total);
+    }
+#endif
+
+    std::size_t filterSlab(const float* value, const float* radius, std::size_t count, float low, float high,
+        std::uint16_t* kept, CullKernel kernel)
+    {
+#ifdef CLUSTERS_HAS_AVX2
+        if (kernel == CullAVX2 && cullKernelSupported(CullAVX2))
+            return filterSlabAVX2(value, radius, count, low, high, kept);
+#endif
+#ifdef CLUSTERS_HAS_SSE2
+        if (kernel != CullScalar)
+            return filterSlabSSE2(value, radius, count, low, high, kept);
+#endif
+        return filterSlabScalar(value, radius, 0, count, low, high, kept);
+    }
+
+    std::size_t touchBox(const float* x, const float* y, const float* depth, const float* radius,
+        const std::uint16_t* ids, std::size_t count, const ClusterBox& box, std::uint16_t* out, CullKernel kernel)
+    {
+#ifdef CLUSTERS_HAS_AVX2
+        if (kernel == CullAVX2 && cullKernelSupported(CullAVX2))
+            return touchBoxAVX2(x, y, depth, radius, ids, count, box, out);
+#endif
+#ifdef CLUSTERS_HAS_SSE2
+        if (kernel != CullScalar)
+            return touchBoxSSE2(x, y, depth, radius, ids, count, box, out);
+#endif
+        return touchBoxScalar(x, y, depth, radius, ids, 0, count, box, out);
+    }
+}
+
+std::vector<PointLight> generateLights(int count, float spread, float range, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+
+    std::vector<PointLight> lights;
+    lights.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        // Posición uniforme en la esfera (por rechazo)
+        glm::vec3 position;
+        do
+        {
+            position = glm::vec3(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+        } while (glm::dot(position, position) > 1.0f);
+
+        // Tono al azar con saturación y brillo máximos
+        float hue = unit(rng);
+        glm::vec3 color = glm::clamp(glm::abs(glm::fract(hue + glm::vec3(1.0f, 2.0f / 3.0f, 1.0f / 3.0f)) * 6.0f
+            - 3.0f) - 1.0f, 0.0f, 1.0f);
+
+        lights.push_back(PointLight{ position * spread, range, color });
+    }
+    return lights;
+}
+
+ClusterUniforms resolveClusterUniforms(const Shader& shader)
+{
+    ClusterUniforms uniforms;
+    uniforms.lights = shader.GetUniform("clusterLights");
+    uniforms.grid = shader.GetUniform("clusterGrid");
+    uniforms.indices = shader.GetUniform("clusterIndices");
+    uniforms.tiles = shader.GetUniform("clusterTiles");
+    uniforms.scale = shader.GetUniform("clusterScale");
+    uniforms.bias = shader.GetUniform("clusterBias");
+    return uniforms;
+}
+
+void LightClusters::LightSet::Resize(std::size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    depth.resize(count);
+    radius.resize(count);
+    ids.resize(count);
+}
+
+LightClusters::LightClusters(int tilesX, int tilesY, int slices)
+    : tilesX(tilesX), tilesY(tilesY), slices(slices), sliceData(slices), ranges(2 * tilesX * tilesY * slices)
+{
+    for (Slice& slice : sliceData)
+        slice.counts.resize(tilesX * tilesY);
+}
+
+LightClusters::~LightClusters()
+{
+    if (textures[0] != 0)
+    {
+        cachedDeleteTextures(3, textures);
+        cachedDeleteBuffers(3, buffers);
+    }
+}
+
+void LightClusters::UpdateClusterBoxes(const glm::mat4& projection, float lightsNear, float lightsFar)
+{
+    // Planos cercano y lejano de la propia matriz (perspectiva de OpenGL)
+    nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    projectionX = projection[0][0];
+    projectionY = projection[1][1];
+
+    // Los cortes solo cubren las profundidades que alcanza alguna luz: el
+    // primero se alarga hasta el plano cercano y el último hasta el lejano
+    sliceStart = std::max(lightsNear, nearPlane);
+    sliceEnd = std::min(lightsFar, farPlane);
+    if (!(sliceEnd > sliceStart * 1.001f))
+    {
+        sliceStart = nearPlane;
+        sliceEnd = farPlane;
+    }
+
+    sliceNear.resize(slices);
+    sliceFar.resize(slices);
+    for (int s = 0; s < slices; ++s)
+    {
+        sliceNear[s] = sliceStart * std::pow(sliceEnd / sliceStart, static_cast<float>(s) / slices);
+        sliceFar[s] = sliceStart * std::pow(sliceEnd / sliceStart, static_cast<float>(s + 1) / slices);
+    }
+    sliceNear[0] = nearPlane;
+    sliceFar[slices - 1] = farPlane;
+
+    // En NDC x = P00 * x / profundidad: un borde de baldosa es un plano
+    // y el rango del cluster sale de sus dos profundidades
+    auto tileRange = [&](int tile, int tiles, float scale, float nearDepth, float farDepth, float& low, float& high) {
+        float left = -1.0f + 2.0f * tile / tiles;
+        float right = -1.0f + 2.0f * (tile + 1) / tiles;
+        low = std::min(left * nearDepth, left * farDepth) / scale;
+        high = std::max(right * nearDepth, right * farDepth) / scale;
+        };
+    boxMinX.resize(slices * tilesX);
+    boxMaxX.resize(slices * tilesX);
+    boxMinY.resize(slices * tilesY);
+    boxMaxY.resize(slices * tilesY);
+    for (int s = 0; s < slices; ++s)
+    {
+        for (int column = 0; column < tilesX; ++column)
+            tileRange(column, tilesX, projection[0][0], sliceNear[s], sliceFar[s],
+                boxMinX[s * tilesX + column], boxMaxX[s * tilesX + column]);
+        for (int row = 0; row < tilesY; ++row)
+            tileRange(row, tilesY, projection[1][1], sliceNear[s], sliceFar[s],
+                boxMinY[s * tilesY + row], boxMaxY[s * tilesY + row]);
+    }
+}
+
+void LightClusters::AssignSlice(int s, CullKernel kernel)
+{
+    Slice& slice = sliceData[s];
+    slice.indices.clear();
+
+    // Luces que cruzan el rango de profundidad del corte
+    const std::size_t lightCount = viewLights.ids.size();
+    slice.kept.resize(lightCount);
+    std::size_t candidateCount = filterSlab(viewLights.depth.data(), viewLights.radius.data(), lightCount,
+        sliceNear[s], sliceFar[s], slice.kept.data(), kernel);
+    LightSet& candidates = slice.candidates;
+    candidates.Resize(candidateCount);
+    for (std::size_t i = 0; i < candidateCount; ++i)
+    {
+        std::uint16_t light = slice.kept[i];
+        candidates.x[i] = viewLights.x[light];
+        candidates.y[i] = viewLights.y[light];
+        candidates.depth[i] = viewLights.depth[light];
+        candidates.radius[i] = viewLights.radius[light];
+        candidates.ids[i] = viewLights.ids[light];
+    }
+
+    ClusterBox box;
+    box.minDepth = sliceNear[s];
+    box.maxDepth = sliceFar[s];
+    for (int row = 0; row < tilesY; ++row)
+    {
+        // De ellas, las que cruzan la fila; luego cada cluster de la fila
+        box.minY = boxMinY[s * tilesY + row];
+        box.maxY = boxMaxY[s * tilesY + row];
+        std::size_t rowCount = filterSlab(candidates.y.data(), candidates.radius.data(), candidateCount,
+            box.minY, box.maxY, slice.kept.data(), kernel);
+        LightSet& inRow = slice.row;
+        inRow.Resize(rowCount);
+        for (std::size_t i = 0; i < rowCount; ++i)
+        {
+            std::uint16_t light = slice.kept[i];
+            inRow.x[i] = candidates.x[light];
+            inRow.y[i] = candidates.y[light];
+            inRow.depth[i] = candidates.depth[light];
+            inRow.radius[i] = candidates.radius[light];
+            inRow.ids[i] = candidates.ids[light];
+        }
+
+        for (int column = 0; column < tilesX; ++column)
+        {
+            box.minX = boxMinX[s * tilesX + column];
+            box.maxX = boxMaxX[s * tilesX + column];
+            std::size_t first = slice.indices.size();
+            slice.indices.resize(first + rowCount);
+            std::size_t count = touchBox(inRow.x.data(), inRow.y.data(), inRow.depth.data(), inRow.radius.data(),
+                inRow.ids.data(), rowCount, box, slice.indices.data() + first, kernel);
+            slice.indices.resize(first + count);
+            slice.counts[row * tilesX + column] = static_cast<std::uint32_t>(count);
+        }
+    }
+}
+
+void LightClusters::Assign(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+    ThreadPool& pool, CullKernel kernel)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // Luces en espacio de vista (view es rígida: el alcance no cambia)
+    const std::size_t lightCount = std::min<std::size_t>(lights.size(), kMaxClusteredLights);
+    viewLights.Resize(lightCount);
+    pool.ParallelFor(static_cast<int>(lightCount), 4096, [&](int first, int last) {
+        for (int i = first; i < last; ++i)
+        {
+            glm::vec4 position = view * glm::vec4(lights[i].position, 1.0f);
+            viewLights.x[i] = position.x;
+            viewLights.y[i] = position.y;
+            viewLights.depth[i] = -position.z;
+            viewLights.radius[i] = lights[i].radius;
+            viewLights.ids[i] = static_cast<std::uint16_t>(i);
+        }
+        });
+
+    float lightsNear = std::numeric_limits<float>::max();
+    float lightsFar = 0.0f;
+    for (std::size_t i = 0; i < lightCount; ++i)
+    {
+        lightsNear = std::min(lightsNear, viewLights.depth[i] - viewLights.radius[i]);
+        lightsFar = std::max(lightsFar, viewLights.depth[i] + viewLights.radius[i]);
+    }
+    UpdateClusterBoxes(projection, lightsNear, lightsFar);
+
+    // Un corte por tarea: cada una escribe solo sus propias listas
+    pool.ParallelFor(slices, 1, [&](int first, int last) {
+        for (int s = first; s < last; ++s)
+            AssignSlice(s, kernel);
+        });
+
+    // Las listas se juntan en el orden de los clusters
+    stats = ClusterStats{};
+    std::size_t total = 0;
+    for (const Slice& slice : sliceData)
+        total += slice.indices.size();
+    indices.resize(total);
+    std::vector<std::uint8_t> touched(lightCount, 0);
+    std::size_t offset = 0;
+    const int perSlice = tilesX * tilesY;
+    for (int s = 0; s < slices; ++s)
+    {
+        const Slice& slice = sliceData[s];
+        if (!slice.indices.empty())
+            std::memcpy(indices.data() + offset, slice.indices.data(), slice.indices.size() * sizeof(std::uint16_t));
+        for (std::uint16_t light : slice.indices)
+            touched[light] = 1;
+        for (int c = 0; c < perSlice; ++c)
+        {
+            std::uint32_t count = slice.counts[c];
+            ranges[2 * (s * perSlice + c)] = static_cast<std::uint32_t>(offset);
+            ranges[2 * (s * perSlice + c) + 1] = count;
+            offset += count;
+            stats.activeClusters += count > 0;
+            stats.maxPerCluster = std::max<std::size_t>(stats.maxPerCluster, count);
+        }
+    }
+    stats.indices = total;
+    for (std::uint8_t light : touched)
+        stats.lights += light;
+    stats.assignMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int LightClusters::FindCluster(const glm::vec3& viewPosition) const
+{
+    float depth = -viewPosition.z;
+    float ndcX = projectionX * viewPosition.x / depth;
+    float ndcY = projectionY * viewPosition.y / depth;
+    float logRange = std::log(sliceEnd / sliceStart);
+    int column = static_cast<int>(std::floor((ndcX * 0.5f + 0.5f) * tilesX));
+    int row = static_cast<int>(std::floor((ndcY * 0.5f + 0.5f) * tilesY));
+    int slice = static_cast<int>(std::floor(std::log(depth) * slices / logRange
+        - slices * std::log(sliceStart) / logRange));
+    column = std::min(std::max(column, 0), tilesX - 1);
+    row = std::min(std::max(row, 0), tilesY - 1);
+    slice = std::min(std::max(slice, 0), slices - 1);
+    return (slice * tilesY + row) * tilesX + column;
+}
+
+void LightClusters::Upload(const std::vector<PointLight>& lights)
+{
+    if (textures[0] == 0)
+    {
+        glGenBuffers(3, buffers);
+        glGenTextures(3, textures);
+        for (int i = 0; i < 3; ++i)
+        {
+            cachedBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+            cachedBindTexture(kTextureUnits[i], GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, kTextureFormats[i], buffers[i]);
+        }
+    }
+
+    const std::size_t lightCount = std::min<std::size_t>(lights.size(), kMaxClusteredLights);
+    lightTexels.resize(8 * lightCount);
+    for (std::size_t i = 0; i < lightCount; ++i)
+    {
+        float* texel = &lightTexels[8 * i];
+        texel[0] = lights[i].position.x;
+        texel[1] = lights[i].position.y;
+        texel[2] = lights[i].position.z;
+        texel[3] = lights[i].radius;
+        texel[4] = lights[i].color.r;
+        texel[5] = lights[i].color.g;
+        texel[6] = lights[i].color.b;
+        texel[7] = 0.0f;
+    }
+
+    // Cada subida huérfana el almacén anterior (glBufferData con nullptr):
+    // el driver da memoria nueva y no espera a que la GPU suelte la vieja
+    const void* data[3] = { lightTexels.data(), ranges.data(), indices.data() };
+    const std::size_t bytes[3] = { lightTexels.size() * sizeof(float), ranges.size() * sizeof(std::uint32_t),
+        indices.size() * sizeof(std::uint16_t) };
+    for (int i = 0; i < 3; ++i)
+    {
+        cachedBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+        glBufferData(GL_TEXTURE_BUFFER, std::max<std::size_t>(bytes[i], 16), nullptr, GL_STREAM_DRAW);
+        if (bytes[i] > 0)
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes[i], data[i]);
+    }
+}
+
+void LightClusters::Apply(Shader& shader, const ClusterUniforms& uniforms, int width, int height) const
+{
+    for (int i = 0; i < 3; ++i)
+        cachedBindTexture(kTextureUnits[i], GL_TEXTURE_BUFFER, textures[i]);
+    shader.SetSampler(uniforms.lights, ClusterLightsUnit);
+    shader.SetSampler(uniforms.grid, ClusterGridUnit);
+    shader.SetSampler(uniforms.indices, ClusterIndicesUnit);
+
+    // Cluster de un fragmento: baldosa = gl_FragCoord.xy * escala y
+    // corte = log(profundidad) * escala + bias
+    // (fuera de [sliceStart, sliceEnd] se queda en el primero o el último)
+    float logRange = std::log(sliceEnd / sliceStart);
+    shader.SetVec3(uniforms.tiles, glm::vec3(tilesX, tilesY, slices));
+    shader.SetVec3(uniforms.scale, glm::vec3(static_cast<float>(tilesX) / std::max(width, 1),
+        static_cast<float>(tilesY) / std::max(height, 1), slices / logRange));
+    shader.SetFloat(uniforms.bias, -slices * std::log(sliceStart) / logRange);
+}
@@ -0,0 +1,134 @@
+//src/ClusteredLighting.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Culling.h"
+#include "Shader.h"
+#include "ThreadPool.h"
+
+// Luz puntual con alcance: su aporte cae a 0 a distancia radius
+struct PointLight {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+};
+
+// count luces repartidas al azar dentro de una esfera de radio spread,
+// con alcance range y colores saturados (misma semilla, mismas luces)
+std::vector<PointLight> generateLights(int count, float spread, float range, unsigned int seed);
+
+// Máximo de luces: los índices de los clusters son de 16 bits
+const int kMaxClusteredLights = 65536;
+
+struct ClusterStats {
+    std::size_t lights;         // luces que tocan algún cluster
+    std::size_t indices;        // entradas de todas las listas
+    std::size_t activeClusters; // clusters con alguna luz
+    std::size_t maxPerCluster;
+    double assignMs;
+};
+
+// Handles de los uniforms del reparto en un programa con CLUSTERED_LIGHTING
+struct ClusterUniforms {
+    int lights = -1;
+    int grid = -1;
+    int indices = -1;
+    int tiles = -1;
+    int scale = -1;
+    int bias = -1;
+};
+ClusterUniforms resolveClusterUniforms(const Shader& shader);
+
+// ---------------------------------------------------
+// Clustered forward shading. El frustum de la cámara se divide en una
+// rejilla de tilesX x tilesY baldosas de pantalla por slices cortes en
+// profundidad y cada cluster guarda la lista de luces cuya esfera toca
+// su caja en espacio de vista. Así cada fragmento solo recorre las luces
+// de su cluster. Los cortes son exponenciales (igual de gruesos en
+// log(profundidad)) dentro del rango de profundidad que ocupan las luces
+// en cada frame: con el plano cercano a 0.1 y la escena lejos, cortar
+// todo el frustum dejaría casi todos los cortes vacíos.
+//
+// El reparto es en la CPU: cada corte de profundidad es una tarea del
+// pool, que primero se queda con las luces que cruzan su rango de
+// profundidad y luego prueba esfera contra caja de cada cluster, de 4
+// (SSE2) u 8 (AVX2) luces por instrucción. Todas las variantes hacen
+// las mismas operaciones y dan las mismas listas.
+//
+// Las luces, el rango de cada cluster y las listas van a la GPU en tres
+// texture buffers (GL 3.3 no tiene SSBO), que se leen con texelFetch.
+// ---------------------------------------------------
+class LightClusters {
+public:
+    LightClusters(int tilesX = 16, int tilesY = 9, int slices = 24);
+    ~LightClusters();
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    // Reparte las luces (en el espacio de view) entre los clusters de
+    // view/projection, una perspectiva simétrica como la de glm::perspective
+    void Assign(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+        ThreadPool& pool = ThreadPool::Shared(), CullKernel kernel = bestCullKernel());
+
+    // Sube luces y listas del último Assign a los texture buffers (se
+    // crean en la primera llamada: Assign no necesita contexto GL)
+    void Upload(const std::vector<PointLight>& lights);
+    // Enlaza los buffers en sus unidades (TextureUnitBinding) y fija los
+    // uniforms del programa activo para un framebuffer de width x height
+    void Apply(Shader& shader, const ClusterUniforms& uniforms, int width, int height) const;
+
+    int GetClusterCount() const { return tilesX * tilesY * slices; }
+    // Cluster de un punto en espacio de vista del último Assign (el mismo
+    // que calcula el fragment shader)
+    int FindCluster(const glm::vec3& viewPosition) const;
+    // Por cluster: primer índice en GetIndices() y número de luces
+    const std::vector<std::uint32_t>& GetRanges() const { return ranges; }
+    const std::vector<std::uint16_t>& GetIndices() const { return indices; }
+    const ClusterStats& GetStats() const { return stats; }
+
+private:
+    // Luces en espacio de vista como arrays por componente, con su
+    // índice global
+    struct LightSet {
+        std::vector<float> x, y, depth, radius;
+        std::vector<std::uint16_t> ids;
+        void Resize(std::size_t count);
+    };
+
+    // Trabajo de un corte de profundidad, propio de su tarea
+    struct Slice {
+        LightSet candidates;  // luces que cruzan el corte
+        LightSet row;         // de ellas, las de una fila de baldosas
+        std::vector<std::uint16_t> kept;
+        std::vector<std::uint16_t> indices;
+        std::vector<std::uint32_t> counts; // por cluster del corte
+    };
+
+    void UpdateClusterBoxes(const glm::mat4& projection, float lightsNear, float lightsFar);
+    void AssignSlice(int slice, CullKernel kernel);
+
+    int tilesX, tilesY, slices;
+    float nearPlane = 0.1f, farPlane = 100.0f;
+    float projectionX = 1.0f, projectionY = 1.0f; // P[0][0] y P[1][1]
+    float sliceStart = 0.1f, sliceEnd = 100.0f; // rango cortado en log
+    // Cajas de los clusters en espacio de vista (profundidad positiva):
+    // el rango en x solo depende de la columna y el corte, el de y de la
+    // fila y el corte y el de profundidad del corte
+    std::vector<float> boxMinX, boxMaxX; // [slice * tilesX + columna]
+    std::vector<float> boxMinY, boxMaxY; // [slice * tilesY + fila]
+    std::vector<float> sliceNear, sliceFar;
+
+    LightSet viewLights;
+    std::vector<Slice> sliceData;
+
+    std::vector<std::uint32_t> ranges; // 2 por cluster
+    std::vector<std::uint16_t> indices;
+    std::vector<float> lightTexels;    // 8 floats por luz
+
+    GLuint buffers[3] = { 0, 0, 0 };
+    GLuint textures[3] = { 0, 0, 0 };
+    ClusterStats stats{};
+};
@@ -0,0 +1,307 @@
+// src/Culling.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Culling.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_HAS_SSE2 1
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// AVX2 se compila con el atributo target en GCC/Clang y se elige en
+// ejecución; en MSVC solo si el proyecto ya se compila con /arch:AVX2
+#if defined(CULLING_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define CULLING_HAS_AVX2 1
+#define CULLING_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(CULLING_HAS_SSE2) && defined(__AVX2__)
+#define CULLING_HAS_AVX2 1
+#define CULLING_AVX2_TARGET
+#endif
+
+namespace {
+    // Objetos por bloque en la versión paralela
+    const int kParallelBlock = 16384;
+
+    std::size_t cullScalar(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+        std::size_t begin, std::size_t end)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            if (!isOutsideFrustum(frustum, bounds, i))
+                visible[count++] = static_cast<std::uint32_t>(i);
+        }
+        return count;
+    }
+
+#ifdef CULLING_HAS_SSE2
+    // Posición del bit 1 más bajo (mask != 0)
+    unsigned lowestSetBit(unsigned mask)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    std::size_t cullSSE2(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+        std::size_t begin, std::size_t end)
+    {
+        __m128 a[6], b[6], c[6], d[6], absA[6], absB[6], absC[6];
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& plane = frustum.planes[p];
+            a[p] = _mm_set1_ps(plane.x);
+            b[p] = _mm_set1_ps(plane.y);
+            c[p] = _mm_set1_ps(plane.z);
+            d[p] = _mm_set1_ps(plane.w);
+            absA[p] = _mm_set1_ps(std::fabs(plane.x));
+            absB[p] = _mm_set1_ps(std::fabs(plane.y));
+            absC[p] = _mm_set1_ps(std::fabs(plane.z));
+        }
+        const __m128 zero = _mm_setzero_ps();
+
+        std::size_t count = 0;
+        std::size_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+            __m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+            __m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+            __m128 ex = _mm_loadu_ps(&bounds.extentX[i]);
+            __m128 ey = _mm_loadu_ps(&bounds.extentY[i]);
+            __m128 ez = _mm_loadu_ps(&bounds.extentZ[i]);
+            __m128 radius = _mm_loadu_ps(&bounds.radius[i]);
+
+            __m128 outside = zero;
+            for (int p = 0; p < 6; ++p)
+            {
+                __m128 distance = _mm_add_ps(_mm_mul_ps(a[p], cx), _mm_mul_ps(b[p], cy));
+                distance = _mm_add_ps(distance, _mm_mul_ps(c[p], cz));
+                distance = _mm_add_ps(distance, d[p]);
+                __m128 extent = _mm_add_ps(_mm_mul_ps(absA[p], ex), _mm_mul_ps(absB[p], ey));
+                extent = _mm_add_ps(extent, _mm_mul_ps(absC[p], ez));
+                __m128 reach = _mm_min_ps(extent, radius);
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, reach), zero));
+            }
+
+            // Compactar: un índice por cada bit de la máscara de visibles
+            unsigned mask = ~static_cast<unsigned>(_mm_movemask_ps(outside)) & 0xFu;
+            while (mask)
+            {
+                unsigned lane = lowestSetBit(mask);
+                visible[count++] = static_cast<std::uint32_t>(i + lane);
+                mask &= mask - 1;
+            }
+        }
+        return count + cullScalar(frustum, bounds, visible + count, i, end);
+    }
+#endif
+
+#ifdef CULLING_HAS_AVX2
+    CULLING_AVX2_TARGET
+    std::size_t cullAVX2(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+        std::size_t begin, std::size_t end)
+    {
+        __m256 a[6], b[6], c[6], d[6], absA[6], absB[6], absC[6];
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& plane = frustum.planes[p];
+            a[p] = _mm256_set1_ps(plane.x);
+            b[p] = _mm256_set1_ps(plane.y);
+            c[p] = _mm256_set1_ps(plane.z);
+            d[p] = _mm256_set1_ps(plane.w);
+            absA[p] = _mm256_set1_ps(std::fabs(plane.x));
+            absB[p] = _mm256_set1_ps(std::fabs(plane.y));
+            absC[p] = _mm256_set1_ps(std::fabs(plane.z));
+        }
+        const __m256 zero = _mm256_setzero_ps();
+
+        std::size_t count = 0;
+        std::size_t i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(&bounds.centerX[i]);
+            __m256 cy = _mm256_loadu_ps(&bounds.centerY[i]);
+            __m256 cz = _mm256_loadu_ps(&bounds.centerZ[i]);
+            __m256 ex = _mm256_loadu_ps(&bounds.extentX[i]);
+            __m256 ey = _mm256_loadu_ps(&bounds.extentY[i]);
+            __m256 ez = _mm256_loadu_ps(&bounds.extentZ[i]);
+            __m256 radius = _mm256_loadu_ps(&bounds.radius[i]);
+
+            __m256 outside = zero;
+            for (int p = 0; p < 6; ++p)
+            {
+                __m256 distance = _mm256_add_ps(_mm256_mul_ps(a[p], cx), _mm256_mul_ps(b[p], cy));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(c[p], cz));
+                distance = _mm256_add_ps(distance, d[p]);
+                __m256 extent = _mm256_add_ps(_mm256_mul_ps(absA[p], ex), _mm256_mul_ps(absB[p], ey));
+                extent = _mm256_add_ps(extent, _mm256_mul_ps(absC[p], ez));
+                __m256 reach = _mm256_min_ps(extent, radius);
+                outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_LT_OQ));
+            }
+
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_ps(outside)) & 0xFFu;
+            while (mask)
+            {
+                unsigned lane = lowestSetBit(mask);
+                visible[count++] = static_cast<std::uint32_t>(i + lane);
+                mask &= mask - 1;
+            }
+        }
+        return count + cullScalar(frustum, bounds, visible + count, i, end);
+    }
+#endif
+}
+
+bool cullKernelSupported(CullKernel kernel)
+{
+    switch (kernel)
+    {
+    case CullScalar:
+        return true;
+    case CullSSE2:
+#ifdef CULLING_HAS_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case CullAVX2:
+#if defined(CULLING_HAS_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2") != 0;
+#elif defined(CULLING_HAS_AVX2)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+CullKernel bestCullKernel()
+{
+    static const CullKernel best = cullKernelSupported(CullAVX2) ? CullAVX2
+        : cullKernelSupported(CullSSE2) ? CullSSE2 : CullScalar;
+    return best;
+}
+
+const char* cullKernelName(CullKernel kernel)
+{
+    switch (kernel)
+    {
+    case CullScalar: return "scalar";
+    case CullSSE2: return "sse2";
+    case CullAVX2: return "avx2";
+    }
+    return "?";
+}
+
+Frustum extractFrustum(const glm::mat4& viewProjection)
+{
+    // Gribb-Hartmann: cada plano es la fila 4 más o menos otra fila
+    // (glm guarda por columnas: la fila i es m[0][i], m[1][i], ...)
+    const glm::mat4& m = viewProjection;
+    glm::vec4 rows[4];
+    for (int row = 0; row < 4; ++row)
+        rows[row] = glm::vec4(m[0][row], m[1][row], m[2][row], m[3][row]);
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[3] + rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+    for (glm::vec4& plane : frustum.planes)
+    {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f)
+            plane /= length;
+    }
+    return frustum;
+}
+
+void CullBounds::Reserve(std::size_t count)
+{
+    for (std::vector<float>* component : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ, &radius })
+        component->reserve(count);
+}
+
+void CullBounds::Add(const ShapeBounds& bounds, const glm::mat4& model)
+{
+    // Semiejes de la caja medidos desde el centro de la esfera (por si
+    // algún día no coinciden, se amplía la caja para seguir conteniéndola)
+    glm::vec3 boxCenter = 0.5f * (bounds.boxMin + bounds.boxMax);
+    glm::vec3 half = 0.5f * (bounds.boxMax - bounds.boxMin) + glm::abs(boxCenter - bounds.sphereCenter);
+
+    glm::vec3 center = glm::vec3(model * glm::vec4(bounds.sphereCenter, 1.0f));
+    glm::mat3 linear(model);
+    // Caja transformada (Arvo): cada semieje suma |columna| * semieje
+    glm::vec3 extent = glm::abs(linear[0]) * half.x + glm::abs(linear[1]) * half.y + glm::abs(linear[2]) * half.z;
+    float scale = std::max(glm::length(linear[0]), std::max(glm::length(linear[1]), glm::length(linear[2])));
+
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    extentX.push_back(extent.x);
+    extentY.push_back(extent.y);
+    extentZ.push_back(extent.z);
+    radius.push_back(bounds.sphereRadius * scale);
+}
+
+std::size_t cullBounds(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible)
+{
+    return cullBounds(frustum, bounds, visible, 0, bounds.Size(), bestCullKernel());
+}
+
+std::size_t cullBounds(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+    std::size_t begin, std::size_t end, CullKernel kernel)
+{
+#ifdef CULLING_HAS_AVX2
+    if (kernel == CullAVX2 && cullKernelSupported(CullAVX2))
+        return cullAVX2(frustum, bounds, visible, begin, end);
+#endif
+#ifdef CULLING_HAS_SSE2
+    if (kernel != CullScalar)
+        return cullSSE2(frustum, bounds, visible, begin, end);
+#endif
+    return cullScalar(frustum, bounds, visible, begin, end);
+}
+
+std::size_t cullBoundsParallel(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+    ThreadPool& pool, CullKernel kernel)
+{
+    const std::size_t total = bounds.Size();
+    if (total == 0)
+        return 0;
+
+    // Cada bloque escribe sus visibles a partir de su primer índice...
+    const int blocks = static_cast<int>((total + kParallelBlock - 1) / kParallelBlock);
+    std::vector<std::size_t> counts(blocks);
+    pool.ParallelFor(blocks, 1, [&](int first, int last) {
+        for (int block = first; block < last; ++block)
+        {
+            std::size_t begin = static_cast<std::size_t>(block) * kParallelBlock;
+            std::size_t end = std::min(begin + kParallelBlock, total);
+            counts[block] = cullBounds(frustum, bounds, visible + begin, begin, end, kernel);
+        }
+        });
+
+    // ...y luego se juntan: el destino nunca va por delante del origen
+    std::size_t count = 0;
+    for (int block = 0; block < blocks; ++block)
+    {
+        std::size_t begin = static_cast<std::size_t>(block) * kParallelBlock;
+        if (count != begin)
+            std::memmove(visible + count, visible + begin, counts[block] * sizeof(std::uint32_t));
+        count += counts[block];
+    }
+    return count;
+}
@@ -0,0 +1,76 @@
+//src/Culling.h
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+// ---------------------------------------------------
+// Frustum culling de muchos objetos. Los volúmenes se guardan como
+// estructura de arrays (un array por componente) para probar 4 (SSE2)
+// u 8 (AVX2) objetos por instrucción contra los seis planos. Cada
+// objeto tiene una caja alineada y una esfera con el mismo centro: está
+// fuera si cualquiera de las dos queda entera detrás de algún plano.
+// Las tres variantes hacen las mismas operaciones (sin FMA) y dan la
+// misma lista.
+// ---------------------------------------------------
+enum CullKernel { CullScalar, CullSSE2, CullAVX2 };
+
+// La mejor variante disponible en esta CPU (AVX2 se detecta en ejecución)
+CullKernel bestCullKernel();
+const char* cullKernelName(CullKernel kernel);
+bool cullKernelSupported(CullKernel kernel);
+
+// Planos (a, b, c, d) normalizados con la normal hacia dentro: un punto
+// p está dentro si a*x + b*y + c*z + d >= 0 para los seis
+struct Frustum {
+    glm::vec4 planes[6]; // izquierda, derecha, abajo, arriba, cerca, lejos
+};
+
+// Planos de clip de projection * view (* model): los objetos se prueban
+// en el espacio en el que está expresada la matriz
+Frustum extractFrustum(const glm::mat4& viewProjection);
+
+struct CullBounds {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ; // semiejes de la caja
+    std::vector<float> radius;
+
+    std::size_t Size() const { return radius.size(); }
+    void Reserve(std::size_t count);
+    // Volúmenes de la forma llevados al espacio del padre con model
+    void Add(const ShapeBounds& bounds, const glm::mat4& model);
+};
+
+// Prueba de un solo objeto: la que hacen todas las variantes en cada
+// carril (mismo orden de operaciones)
+inline bool isOutsideFrustum(const Frustum& frustum, const CullBounds& bounds, std::size_t i)
+{
+    bool outside = false;
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        float distance = plane.x * bounds.centerX[i] + plane.y * bounds.centerY[i];
+        distance = distance + plane.z * bounds.centerZ[i];
+        distance = distance + plane.w;
+        float extent = std::fabs(plane.x) * bounds.extentX[i] + std::fabs(plane.y) * bounds.extentY[i];
+        extent = extent + std::fabs(plane.z) * bounds.extentZ[i];
+        float reach = std::min(extent, bounds.radius[i]);
+        outside = outside || distance + reach < 0.0f;
+    }
+    return outside;
+}
+
+// Escribe en visible los índices (crecientes) de los objetos que tocan
+// el frustum y devuelve cuántos son; visible debe tener sitio para todos
+std::size_t cullBounds(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible);
+std::size_t cullBounds(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+    std::size_t begin, std::size_t end, CullKernel kernel);
+
+// Reparte los objetos en bloques entre los hilos del pool y junta las
+// listas de cada bloque en orden (mismo resultado que la versión serie)
+std::size_t cullBoundsParallel(const Frustum& frustum, const CullBounds& bounds, std::uint32_t* visible,
+    ThreadPool& pool = ThreadPool::Shared(), CullKernel kernel = bestCullKernel());
@@ -0,0 +1,217 @@
+// src/DeferredRenderer.cpp
+#include <cmath>
+#include <cstdio>
+#include "DeferredRenderer.h"
+#include "GLStateCache.h"
+
+namespace {
+    // Resolución de la esfera de las luces: pocos triángulos bastan
+    constexpr int kSphereSectors = 16;
+    constexpr int kSphereStacks = 12;
+
+    // Formato de cada textura del G-buffer (albedo, normal, profundidad)
+    const GLenum kInternalFormats[3] = { GL_RGBA8, GL_RGB10_A2, GL_DEPTH_COMPONENT24 };
+    const GLenum kFormats[3] = { GL_RGBA, GL_RGBA, GL_DEPTH_COMPONENT };
+    const GLenum kTypes[3] = { GL_UNSIGNED_BYTE, GL_UNSIGNED_INT_2_10_10_10_REV, GL_UNSIGNED_INT };
+    const GLenum kAttachments[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_DEPTH_ATTACHMENT };
+    const TextureUnitBinding kTextureUnits[3] = { GBufferAlbedoUnit, GBufferNormalUnit, GBufferDepthUnit };
+    const std::size_t kBytesPerPixel = 4 + 4 + 4 + 4 + 4; // G-buffer + color y profundidad de la luz
+
+    std::unique_ptr<Shader> loadLightProgram(const std::string& defines)
+    {
+        return std::make_unique<Shader>(
+            injectDefines(loadTextFile("src/shaders/deferred_light_vertex_shader.glsl"), defines),
+            injectDefines(loadTextFile("src/shaders/deferred_light_fragment_shader.glsl"), defines));
+    }
+}
+
+DeferredRenderer::DeferredRenderer()
+{
+    ambientShader = loadLightProgram("");
+    volumeShader = loadLightProgram("#define LIGHT_VOLUME\n");
+    if (!IsValid())
+    {
+        fprintf(stderr, "Error: could not create the deferred lighting programs\n");
+        return;
+    }
+    uAmbientInverse = ambientShader->GetUniform("inverseViewProjection");
+    uVolumeInverse = volumeShader->GetUniform("inverseViewProjection");
+    uMeshDecode = volumeShader->GetUniform("meshDecode");
+    uVolumeScale = volumeShader->GetUniform("volumeScale");
+    const char* samplers[3] = { "gbufferAlbedo", "gbufferNormal", "gbufferDepth" };
+    for (Shader* shader : { ambientShader.get(), volumeShader.get() })
+    {
+        shader->Bind();
+        for (int i = 0; i < 3; ++i)
+            shader->SetSampler(shader->GetUniform(samplers[i]), kTextureUnits[i]);
+    }
+
+    // Las caras de la esfera quedan dentro de la esfera de radio 1: se
+    // agranda hasta que la distancia mínima al centro (centro de una
+    // cara) sea 1 y ningún punto al alcance de la luz quede fuera
+    const float pi = 3.14159265f;
+    sphere = createSphere(kSphereSectors, kSphereStacks);
+    volumeScale = 1.0f / (std::cos(pi / kSphereSectors) * std::cos(pi / (2.0f * kSphereStacks)));
+
+    // Geometría de la esfera + centro/alcance y color por luz
+    glGenVertexArrays(1, &sphereVAO);
+    glGenBuffers(1, &lightVBO);
+    cachedBindVertexArray(sphereVAO);
+    bindShapeVertices(sphere);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphere.EBO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, lightVBO);
+    glBufferData(GL_ARRAY_BUFFER, 8 * sizeof(float), nullptr, GL_STREAM_DRAW);
+    const GLuint positionLocation = 11; // aLightPosition (Shader.cpp)
+    const GLuint colorLocation = 12;    // aLightColor
+    glVertexAttribPointer(positionLocation, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+    glVertexAttribPointer(colorLocation, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(4 * sizeof(float)));
+    glEnableVertexAttribArray(positionLocation);
+    glEnableVertexAttribArray(colorLocation);
+    glVertexAttribDivisor(positionLocation, 1);
+    glVertexAttribDivisor(colorLocation, 1);
+    cachedBindVertexArray(0);
+
+    glGenVertexArrays(1, &emptyVAO);
+}
+
+DeferredRenderer::~DeferredRenderer()
+{
+    DestroyTargets();
+    cachedDeleteVertexArrays(1, &sphereVAO);
+    cachedDeleteVertexArrays(1, &emptyVAO);
+    cachedDeleteBuffers(1, &lightVBO);
+    destroyShape(sphere);
+}
+
+void DeferredRenderer::CreateTargets(int newWidth, int newHeight)
+{
+    DestroyTargets();
+    width = newWidth;
+    height = newHeight;
+
+    glGenFramebuffers(1, &gbuffer);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, gbuffer);
+    glGenTextures(3, textures);
+    for (int i = 0; i < 3; ++i)
+    {
+        cachedBindTexture(kTextureUnits[i], GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, kInternalFormats[i], width, height, 0, kFormats[i], kTypes[i], nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, kAttachments[i], GL_TEXTURE_2D, textures[i], 0);
+    }
+    glDrawBuffers(2, kAttachments);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        fprintf(stderr, "G-buffer %dx%d is incomplete\n", width, height);
+
+    // La luz no puede probar contra la profundidad del G-buffer mientras
+    // la lee como textura: tiene su propia copia (mismo formato, para
+    // poder copiarla con glBlitFramebuffer)
+    glGenFramebuffers(1, &lightBuffer);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, lightBuffer);
+    glGenRenderbuffers(1, &lightColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, lightColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, lightColor);
+    glGenRenderbuffers(1, &lightDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, lightDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, lightDepth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        fprintf(stderr, "Deferred light buffer %dx%d is incomplete\n", width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    stats.gbufferBytes = static_cast<std::size_t>(width) * height * kBytesPerPixel;
+}
+
+void DeferredRenderer::DestroyTargets()
+{
+    if (gbuffer == 0)
+        return;
+    cachedDeleteFramebuffers(1, &gbuffer);
+    cachedDeleteFramebuffers(1, &lightBuffer);
+    cachedDeleteTextures(3, textures);
+    glDeleteRenderbuffers(1, &lightColor);
+    glDeleteRenderbuffers(1, &lightDepth);
+    gbuffer = lightBuffer = lightColor = lightDepth = 0;
+    textures[0] = textures[1] = textures[2] = 0;
+}
+
+void DeferredRenderer::BeginGeometry(int newWidth, int newHeight)
+{
+    if (gbuffer == 0 || newWidth != width || newHeight != height)
+        CreateTargets(newWidth, newHeight);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, gbuffer);
+    cachedViewport(0, 0, width, height);
+}
+
+void DeferredRenderer::Light(const std::vector<PointLight>& lights, const glm::mat4& view,
+    const glm::mat4& projection, GLuint target)
+{
+    stats.lights = lights.size();
+    glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+
+    // Copia de la profundidad y fondo con el color de limpieza actual
+    cachedBindFramebuffer(GL_READ_FRAMEBUFFER, gbuffer);
+    cachedBindFramebuffer(GL_DRAW_FRAMEBUFFER, lightBuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, lightBuffer);
+    glClear(GL_COLOR_BUFFER_BIT);
+    for (int i = 0; i < 3; ++i)
+        cachedBindTexture(kTextureUnits[i], GL_TEXTURE_2D, textures[i]);
+
+    // Ambiente + luz principal en cada píxel con geometría
+    cachedDisable(GL_DEPTH_TEST);
+    cachedDepthMask(false);
+    ambientShader->Bind();
+    ambientShader->SetMat4(uAmbientInverse, inverseViewProjection);
+    cachedBindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    if (!lights.empty())
+    {
+        // Cada subida huérfana el almacén anterior, como en LightClusters
+        lightData.resize(8 * lights.size());
+        for (std::size_t i = 0; i < lights.size(); ++i)
+        {
+            float* light = &lightData[8 * i];
+            light[0] = lights[i].position.x;
+            light[1] = lights[i].position.y;
+            light[2] = lights[i].position.z;
+            light[3] = lights[i].radius;
+            light[4] = lights[i].color.r;
+            light[5] = lights[i].color.g;
+            light[6] = lights[i].color.b;
+            light[7] = 0.0f;
+        }
+        cachedBindBuffer(GL_ARRAY_BUFFER, lightVBO);
+        glBufferData(GL_ARRAY_BUFFER, lightData.size() * sizeof(float), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, lightData.size() * sizeof(float), lightData.data());
+
+        cachedEnable(GL_DEPTH_TEST);
+        cachedDepthFunc(GL_GEQUAL);
+        cachedEnable(GL_CULL_FACE);
+        cachedCullFace(GL_FRONT);
+        cachedEnable(GL_BLEND);
+        cachedBlendFunc(GL_ONE, GL_ONE);
+        volumeShader->Bind();
+        volumeShader->SetMat4(uVolumeInverse, inverseViewProjection);
+        volumeShader->SetMat4(uMeshDecode, positionDecodeMatrix(sphere));
+        volumeShader->SetFloat(uVolumeScale, volumeScale);
+        cachedBindVertexArray(sphereVAO);
+        glDrawElementsInstanced(GL_TRIANGLES, sphere.indexCount, sphere.indexType, (void*)0,
+            static_cast<GLsizei>(lights.size()));
+
+        cachedDisable(GL_BLEND);
+        cachedCullFace(GL_BACK);
+        cachedDisable(GL_CULL_FACE);
+        cachedDepthFunc(GL_LESS);
+    }
+    cachedEnable(GL_DEPTH_TEST);
+    cachedDepthMask(true);
+
+    cachedBindFramebuffer(GL_READ_FRAMEBUFFER, lightBuffer);
+    cachedBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, target);
+}
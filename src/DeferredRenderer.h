@@ -0,0 +1,78 @@
+//src/DeferredRenderer.h
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "ClusteredLighting.h"
+#include "Mesh.h"
+#include "Shader.h"
+
+// Contadores del último frame
+struct DeferredStats {
+    std::size_t lights;       // esferas de luz dibujadas
+    std::size_t gbufferBytes; // G-buffer + buffer de luz (color y profundidad)
+};
+
+// ---------------------------------------------------
+// Deferred shading, alternativa al forward de fragment_shader.glsl. La
+// pasada de geometría usa los programas de siempre compilados con
+// DEFERRED_GBUFFER: en vez de iluminar escriben un G-buffer de 12 bytes
+// por píxel:
+//   0: RGBA8     albedo + intensidad especular (los materiales son grises)
+//   1: RGB10_A2  normal octaédrica (2 x 10 bits) + brillo / 256
+//   DEPTH24      de la que se reconstruye la posición
+// La luz se acumula en un buffer propio: un triángulo a pantalla
+// completa con la luz ambiente y la principal y luego la esfera de
+// alcance de cada luz puntual (createSphere, una sola llamada
+// instanciada) con blending aditivo. Se dibujan las caras traseras, así
+// que vale con la cámara dentro de una esfera, con GL_GEQUAL contra una
+// copia de la profundidad: solo se sombrean los píxeles cuya superficie
+// queda delante de la cara trasera. El coste depende de los píxeles que
+// cubre cada luz y no de cuántos objetos hay.
+// Al final el resultado se copia al framebuffer de destino.
+// ---------------------------------------------------
+class DeferredRenderer {
+public:
+    DeferredRenderer();
+    ~DeferredRenderer();
+    DeferredRenderer(const DeferredRenderer&) = delete;
+    DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+    bool IsValid() const { return ambientShader && ambientShader->GetId() != 0 && volumeShader->GetId() != 0; }
+
+    // Enlaza el G-buffer de width x height (se reserva de nuevo si cambia
+    // el tamaño). Lo limpia el llamador, como cualquier framebuffer.
+    void BeginGeometry(int width, int height);
+    // Ilumina el G-buffer con FrameData y las luces (en espacio de mundo)
+    // y copia el color a target, que queda enlazado. view y projection
+    // son las de FrameData.
+    void Light(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& projection,
+        GLuint target);
+
+    const DeferredStats& GetStats() const { return stats; }
+
+private:
+    void CreateTargets(int width, int height);
+    void DestroyTargets();
+
+    std::unique_ptr<Shader> ambientShader; // pantalla completa: ambiente + luz principal
+    std::unique_ptr<Shader> volumeShader;  // esferas de las luces puntuales
+    int uAmbientInverse = -1, uVolumeInverse = -1;
+    int uMeshDecode = -1, uVolumeScale = -1;
+
+    Shape sphere{};
+    float volumeScale = 1.0f; // la malla está inscrita en la esfera
+    GLuint sphereVAO = 0;     // esfera + atributos por luz
+    GLuint lightVBO = 0;
+    GLuint emptyVAO = 0;      // el triángulo sale de gl_VertexID
+    std::vector<float> lightData; // 8 floats por luz
+
+    int width = 0, height = 0;
+    GLuint gbuffer = 0;
+    GLuint textures[3] = { 0, 0, 0 }; // albedo, normal, profundidad
+    GLuint lightBuffer = 0;
+    GLuint lightColor = 0, lightDepth = 0; // renderbuffers
+    DeferredStats stats{};
+};
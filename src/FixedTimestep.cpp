@@ -0,0 +1,32 @@
+// src/FixedTimestep.cpp
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(double stepSeconds, int maxStepsPerFrame)
+    : step(stepSeconds), maxStepsPerFrame(maxStepsPerFrame), accumulator(0.0), lastTime(0.0),
+      started(false), stepCount(0), droppedTime(0.0) {
+}
+
+int FixedTimestep::Advance(double now) {
+    if (!started) {
+        started = true;
+        lastTime = now;
+        return 0;
+    }
+
+    double elapsed = now - lastTime;
+    lastTime = now;
+    if (elapsed < 0.0)
+        elapsed = 0.0;
+
+    accumulator += elapsed;
+    double limit = step * maxStepsPerFrame;
+    if (accumulator > limit) {
+        droppedTime += accumulator - limit;
+        accumulator = limit;
+    }
+
+    int steps = static_cast<int>(accumulator / step);
+    accumulator -= steps * step;
+    stepCount += steps;
+    return steps;
+}
@@ -0,0 +1,37 @@
+//src/FixedTimestep.h
+#pragma once
+
+// ---------------------------------------------------
+// Paso fijo de simulación con acumulador: el tiempo real de cada frame
+// se acumula y se consume en pasos de duración constante, de modo que
+// la simulación avanza igual a 30, 60 o 1000 FPS. Lo que sobra (menos
+// de un paso) da la fracción para interpolar entre los dos últimos
+// estados al dibujar.
+// ---------------------------------------------------
+class FixedTimestep {
+public:
+    // maxStepsPerFrame limita la recuperación tras un frame muy largo:
+    // el tiempo que exceda se descarta (la simulación se ralentiza en
+    // vez de entrar en una espiral de pasos cada vez más caros)
+    explicit FixedTimestep(double stepSeconds, int maxStepsPerFrame = 8);
+
+    // Tiempo actual en segundos (glfwGetTime); devuelve cuántos pasos
+    // hay que simular en este frame. El primer frame no simula ninguno.
+    int Advance(double now);
+
+    double GetStep() const { return step; }
+    // Fracción [0, 1) del siguiente paso ya transcurrida
+    float GetAlpha() const { return static_cast<float>(accumulator / step); }
+    unsigned long long GetStepCount() const { return stepCount; }
+    // Tiempo descartado por superar maxStepsPerFrame
+    double GetDroppedTime() const { return droppedTime; }
+
+private:
+    double step;
+    int maxStepsPerFrame;
+    double accumulator;
+    double lastTime;
+    bool started;
+    unsigned long long stepCount;
+    double droppedTime;
+};
@@ -0,0 +1,229 @@
+// src/FrameProfiler.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <glad/glad.h>
+#include "FrameProfiler.h"
+
+namespace {
+    const char* kPhaseNames[FrameProfiler::PhaseCount] = { "input", "uniforms", "draw", "swap" };
+
+    double toMs(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    bool queryAvailable(unsigned int query)
+    {
+        int available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available != 0;
+    }
+
+    unsigned long long queryResult(unsigned int query)
+    {
+        GLuint64 value = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &value);
+        return value;
+    }
+}
+
+// ---------------------------------------------------
+// Ventana móvil
+// ---------------------------------------------------
+FrameProfiler::RollingStats::RollingStats(int capacity)
+    : capacity(capacity), next(0) {
+    samples.reserve(capacity);
+}
+
+void FrameProfiler::RollingStats::Add(double value) {
+    if (static_cast<int>(samples.size()) < capacity)
+        samples.push_back(value);
+    else
+        samples[next] = value;
+    next = (next + 1) % capacity;
+}
+
+double FrameProfiler::RollingStats::Mean() const {
+    if (samples.empty())
+        return 0.0;
+    double sum = 0.0;
+    for (double value : samples)
+        sum += value;
+    return sum / samples.size();
+}
+
+double FrameProfiler::RollingStats::Max() const {
+    return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+}
+
+// Percentil por rango más cercano (p en [0, 100])
+double FrameProfiler::RollingStats::Percentile(double p) const {
+    if (samples.empty())
+        return 0.0;
+    std::vector<double> sorted(samples);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    size_t index = std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+// ---------------------------------------------------
+// Perfilador
+// ---------------------------------------------------
+FrameProfiler::FrameProfiler(bool enabled, int windowSize)
+    : enabled(enabled), frameIndex(0), frameCount(0),
+      cpuFrame(windowSize), gpuFrame(windowSize), droppedGpuFrames(0) {
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        cpuPhases[phase] = RollingStats(windowSize);
+        gpuPhases[phase] = RollingStats(windowSize);
+    }
+
+    for (GpuFrameQueries& frame : gpuFrames) {
+        frame = GpuFrameQueries{};
+        if (enabled) {
+            glGenQueries(1, &frame.elapsed);
+            glGenQueries(PhaseCount * 2, frame.timestamps);
+        }
+    }
+}
+
+FrameProfiler::~FrameProfiler() {
+    if (!enabled)
+        return;
+    for (GpuFrameQueries& frame : gpuFrames) {
+        glDeleteQueries(1, &frame.elapsed);
+        glDeleteQueries(PhaseCount * 2, frame.timestamps);
+    }
+}
+
+void FrameProfiler::BeginFrame() {
+    if (!enabled)
+        return;
+
+    // Las consultas de este hueco se emitieron hace kFramesInFlight frames
+    GpuFrameQueries& frame = gpuFrames[frameIndex % kFramesInFlight];
+    if (frame.pending)
+        CollectGpuResults(frame);
+
+    for (bool& used : frame.phaseUsed)
+        used = false;
+    glBeginQuery(GL_TIME_ELAPSED, frame.elapsed);
+    frameStart = Clock::now();
+}
+
+void FrameProfiler::BeginPhase(Phase phase) {
+    if (!enabled)
+        return;
+    GpuFrameQueries& frame = gpuFrames[frameIndex % kFramesInFlight];
+    glQueryCounter(frame.timestamps[phase * 2], GL_TIMESTAMP);
+    frame.phaseUsed[phase] = true;
+    phaseStart[phase] = Clock::now();
+}
+
+void FrameProfiler::EndPhase(Phase phase) {
+    if (!enabled)
+        return;
+    cpuPhases[phase].Add(toMs(Clock::now() - phaseStart[phase]));
+    GpuFrameQueries& frame = gpuFrames[frameIndex % kFramesInFlight];
+    glQueryCounter(frame.timestamps[phase * 2 + 1], GL_TIMESTAMP);
+}
+
+void FrameProfiler::EndFrame() {
+    if (!enabled)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    cpuFrame.Add(toMs(Clock::now() - frameStart));
+
+    gpuFrames[frameIndex % kFramesInFlight].pending = true;
+    ++frameIndex;
+    ++frameCount;
+}
+
+// Lee los resultados solo si ya están disponibles: nunca bloquea
+void FrameProfiler::CollectGpuResults(GpuFrameQueries& frame) {
+    frame.pending = false;
+
+    bool available = queryAvailable(frame.elapsed);
+    for (int phase = 0; phase < PhaseCount && available; ++phase) {
+        if (frame.phaseUsed[phase])
+            available = queryAvailable(frame.timestamps[phase * 2 + 1]);
+    }
+    if (!available) {
+        ++droppedGpuFrames;
+        return;
+    }
+
+    gpuFrame.Add(queryResult(frame.elapsed) / 1.0e6);
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        if (!frame.phaseUsed[phase])
+            continue;
+        unsigned long long begin = queryResult(frame.timestamps[phase * 2]);
+        unsigned long long end = queryResult(frame.timestamps[phase * 2 + 1]);
+        gpuPhases[phase].Add(end > begin ? (end - begin) / 1.0e6 : 0.0);
+    }
+}
+
+void FrameProfiler::PrintSummary() const {
+    if (!enabled)
+        return;
+
+    auto printRow = [](const std::string& name, const RollingStats& stats) {
+        printf("  %-14s %6d %9.3f %9.3f %9.3f %9.3f %9.3f\n", name.c_str(), stats.Count(),
+            stats.Mean(), stats.Percentile(50), stats.Percentile(95), stats.Percentile(99), stats.Max());
+        };
+
+    printf("Frame profile (%d frames, %llu GPU frames dropped), ms:\n", frameCount, droppedGpuFrames);
+    printf("  %-14s %6s %9s %9s %9s %9s %9s\n", "metric", "n", "mean", "p50", "p95", "p99", "max");
+    printRow("cpu_frame", cpuFrame);
+    for (int phase = 0; phase < PhaseCount; ++phase)
+        printRow(std::string("cpu_") + kPhaseNames[phase], cpuPhases[phase]);
+    printRow("gpu_frame", gpuFrame);
+    for (int phase = 0; phase < PhaseCount; ++phase)
+        printRow(std::string("gpu_") + kPhaseNames[phase], gpuPhases[phase]);
+}
+
+bool FrameProfiler::Save(const std::string& path) const {
+    if (!enabled)
+        return false;
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "Could not write profile: %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<std::pair<std::string, const RollingStats*>> metrics;
+    metrics.emplace_back("cpu_frame", &cpuFrame);
+    for (int phase = 0; phase < PhaseCount; ++phase)
+        metrics.emplace_back(std::string("cpu_") + kPhaseNames[phase], &cpuPhases[phase]);
+    metrics.emplace_back("gpu_frame", &gpuFrame);
+    for (int phase = 0; phase < PhaseCount; ++phase)
+        metrics.emplace_back(std::string("gpu_") + kPhaseNames[phase], &gpuPhases[phase]);
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        fprintf(file, "{\n  \"frames\": %d,\n  \"dropped_gpu_frames\": %llu,\n  \"metrics\": {\n",
+            frameCount, droppedGpuFrames);
+        for (size_t i = 0; i < metrics.size(); ++i) {
+            const RollingStats& stats = *metrics[i].second;
+            fprintf(file, "    \"%s\": { \"samples\": %d, \"mean_ms\": %.4f, \"p50_ms\": %.4f, "
+                "\"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+                metrics[i].first.c_str(), stats.Count(), stats.Mean(), stats.Percentile(50),
+                stats.Percentile(95), stats.Percentile(99), stats.Max(),
+                i + 1 < metrics.size() ? "," : "");
+        }
+        fprintf(file, "  }\n}\n");
+    }
+    else {
+        fprintf(file, "metric,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+        for (const auto& metric : metrics) {
+            const RollingStats& stats = *metric.second;
+            fprintf(file, "%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n", metric.first.c_str(), stats.Count(),
+                stats.Mean(), stats.Percentile(50), stats.Percentile(95), stats.Percentile(99), stats.Max());
+        }
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,78 @@
+//src/FrameProfiler.h
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------
+// Perfilador de frames CPU/GPU sin bloqueos.
+// CPU: steady_clock al inicio/fin de cada fase.
+// GPU: GL_TIMESTAMP en cada frontera de fase y GL_TIME_ELAPSED para el
+// frame completo, en un anillo de consultas que se leen varios frames
+// después (nunca se espera al resultado: si no está listo se descarta).
+// Las estadísticas (p50/p95/p99) se calculan sobre una ventana móvil.
+// ---------------------------------------------------
+class FrameProfiler {
+public:
+    enum Phase { Input, Uniforms, Draw, Swap, PhaseCount };
+
+    explicit FrameProfiler(bool enabled, int windowSize = 1000);
+    ~FrameProfiler();
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    bool IsEnabled() const { return enabled; }
+
+    void BeginFrame();
+    void BeginPhase(Phase phase);
+    void EndPhase(Phase phase);
+    void EndFrame();
+
+    // Resumen por métrica: muestras, media, p50, p95, p99 y máximo (ms)
+    void PrintSummary() const;
+    // Formato según la extensión: .json o CSV en cualquier otro caso
+    bool Save(const std::string& path) const;
+
+    // Frames cuyas consultas de GPU no estaban listas al reutilizarlas
+    unsigned long long GetDroppedGpuFrames() const { return droppedGpuFrames; }
+
+    // Ventana móvil de una métrica en milisegundos
+    class RollingStats {
+    public:
+        explicit RollingStats(int capacity = 1000);
+        void Add(double value);
+        int Count() const { return static_cast<int>(samples.size()); }
+        double Mean() const;
+        double Max() const;
+        double Percentile(double p) const;
+    private:
+        std::vector<double> samples;
+        int capacity;
+        int next;
+    };
+
+private:
+    static const int kFramesInFlight = 4;
+    using Clock = std::chrono::steady_clock;
+
+    struct GpuFrameQueries {
+        unsigned int elapsed;
+        unsigned int timestamps[PhaseCount * 2];
+        bool phaseUsed[PhaseCount];
+        bool pending;
+    };
+
+    void CollectGpuResults(GpuFrameQueries& frame);
+
+    bool enabled;
+    int frameIndex;
+    GpuFrameQueries gpuFrames[kFramesInFlight];
+    Clock::time_point frameStart;
+    Clock::time_point phaseStart[PhaseCount];
+    int frameCount;
+    RollingStats cpuFrame;
+    RollingStats cpuPhases[PhaseCount];
+    RollingStats gpuFrame;
+    RollingStats gpuPhases[PhaseCount];
+    unsigned long long droppedGpuFrames;
+};
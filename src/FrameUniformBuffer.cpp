@@ -0,0 +1,41 @@
+// src/FrameUniformBuffer.cpp
+#include <cstring>
+#include <glad/glad.h>
+#include "FrameUniformBuffer.h"
+#include "GLStateCache.h"
+#include "Shader.h"
+
+namespace {
+    std::size_t uniformOffsetAlignment() {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return alignment > 0 ? static_cast<std::size_t>(alignment) : 256;
+    }
+}
+
+FrameUniformBuffer::FrameUniformBuffer()
+    : stream(sizeof(FrameData), 3, uniformOffsetAlignment()), current(), valid(false), uploads(0), skips(0) {
+}
+
+void FrameUniformBuffer::Update(const FrameData& data) {
+    if (valid && std::memcmp(&current, &data, sizeof(FrameData)) == 0) {
+        ++skips;
+        return;
+    }
+
+    std::size_t offset = 0;
+    if (!stream.Write(&data, sizeof(FrameData), offset))
+        return;
+
+    current = data;
+    valid = true;
+    ++uploads;
+
+    // El enlace es global: sirve a cualquier programa que declare el bloque
+    cachedBindBufferRange(GL_UNIFORM_BUFFER, FrameDataBlock, stream.GetId(), static_cast<GLintptr>(offset),
+        sizeof(FrameData));
+}
+
+void FrameUniformBuffer::EndFrame() {
+    stream.EndFrame();
+}
@@ -0,0 +1,45 @@
+//src/FrameUniformBuffer.h
+#pragma once
+#include <glm/glm.hpp>
+#include "StreamBuffer.h"
+
+// ---------------------------------------------------
+// Estado por frame (cámara + luz) compartido por todos los programas a
+// través del bloque "FrameData" (std140) en el punto de enlace
+// FrameDataBlock. Los vec3 van seguidos de un float de relleno para
+// respetar el alineamiento de 16 bytes de std140.
+// ---------------------------------------------------
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 viewPos;       float pad0;
+    glm::vec3 lightPos;      float pad1;
+    glm::vec3 lightAmbient;  float pad2;
+    glm::vec3 lightDiffuse;  float pad3;
+    glm::vec3 lightSpecular; float pad4;
+};
+static_assert(sizeof(FrameData) == 208, "FrameData must match the std140 layout of the FrameData block");
+
+class FrameUniformBuffer {
+public:
+    FrameUniformBuffer();
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    // Sube el bloque solo si cambió respecto al último frame. Cada subida
+    // va a la región del frame de un StreamBuffer y se enlaza con
+    // glBindBufferRange: nunca espera a que la GPU suelte la anterior.
+    void Update(const FrameData& data);
+    // Después de los draws del frame (fence de la región usada)
+    void EndFrame();
+
+    unsigned long long GetUploadCount() const { return uploads; }
+    unsigned long long GetSkipCount() const { return skips; }
+
+private:
+    StreamBuffer stream;
+    FrameData current;
+    bool valid;
+    unsigned long long uploads;
+    unsigned long long skips;
+};
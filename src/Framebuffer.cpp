@@ -0,0 +1,72 @@
+// src/Framebuffer.cpp
+#include <cstdio>
+#include <vector>
+#include <glad/glad.h>
+#include "Framebuffer.h"
+#include "GLStateCache.h"
+
+Framebuffer::Framebuffer(int width, int height)
+    : id(0), colorBuffer(0), depthBuffer(0), width(width), height(height) {
+    glGenFramebuffers(1, &id);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, id);
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+    if (!IsComplete())
+        fprintf(stderr, "Framebuffer %dx%d is incomplete\n", width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    cachedBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer() {
+    cachedDeleteFramebuffers(1, &id);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glDeleteRenderbuffers(1, &depthBuffer);
+}
+
+void Framebuffer::Bind() const {
+    cachedBindFramebuffer(GL_FRAMEBUFFER, id);
+    cachedViewport(0, 0, width, height);
+}
+
+void Framebuffer::Unbind() const {
+    cachedBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool Framebuffer::IsComplete() const {
+    cachedBindFramebuffer(GL_FRAMEBUFFER, id);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+bool Framebuffer::SavePPM(const std::string& path) const {
+    std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+
+    cachedBindFramebuffer(GL_READ_FRAMEBUFFER, id);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    cachedBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        fprintf(stderr, "Could not write image: %s\n", path.c_str());
+        return false;
+    }
+
+    // OpenGL guarda las filas de abajo hacia arriba; PPM de arriba hacia abajo
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    size_t rowBytes = static_cast<size_t>(width) * 3;
+    for (int y = height - 1; y >= 0; --y)
+        fwrite(&pixels[y * rowBytes], 1, rowBytes, file);
+
+    fclose(file);
+    return true;
+}
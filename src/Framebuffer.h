@@ -0,0 +1,29 @@
+//src/Framebuffer.h
+#pragma once
+#include <string>
+
+// Render target fuera de pantalla: color RGBA8 + profundidad 24 bits.
+// Permite renderizar a cualquier resolución sin ventana visible.
+class Framebuffer {
+private:
+    unsigned int id;
+    unsigned int colorBuffer;
+    unsigned int depthBuffer;
+    int width;
+    int height;
+public:
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    void Bind() const;
+    void Unbind() const;
+    bool IsComplete() const;
+    unsigned int GetId() const { return id; }
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    // Lee el color del framebuffer y lo guarda como PPM binario (P6)
+    bool SavePPM(const std::string& path) const;
+};
@@ -0,0 +1,350 @@
+// src/GLStateCache.cpp
+#include <cstddef>
+#include "GLStateCache.h"
+
+namespace {
+    // Valor "desconocido": ningún nombre ni enum de GL lo usa
+    const GLuint kUnknown = 0xFFFFFFFFu;
+
+    // Destinos con caché; los demás se envían siempre
+    const GLenum kBufferTargets[] = {
+        GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER,
+        GL_COPY_WRITE_BUFFER, GL_TEXTURE_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_PIXEL_PACK_BUFFER,
+        GL_PIXEL_UNPACK_BUFFER
+    };
+    const GLenum kTextureTargets[] = {
+        GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BUFFER
+    };
+    const GLenum kCapabilities[] = { GL_DEPTH_TEST, GL_BLEND, GL_CULL_FACE, GL_SCISSOR_TEST };
+
+    const int kBufferTargetCount = sizeof(kBufferTargets) / sizeof(kBufferTargets[0]);
+    const int kTextureTargetCount = sizeof(kTextureTargets) / sizeof(kTextureTargets[0]);
+    const int kCapabilityCount = sizeof(kCapabilities) / sizeof(kCapabilities[0]);
+    const int kElementArraySlot = 1;
+    const GLuint kTextureUnits = 16;
+    const GLuint kUniformBindings = 16;
+
+    struct IndexedBinding {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    struct CachedState {
+        GLuint program;
+        GLuint vertexArray;
+        GLuint buffers[kBufferTargetCount];
+        IndexedBinding uniformBindings[kUniformBindings];
+        GLuint activeUnit;
+        GLuint textures[kTextureUnits][kTextureTargetCount];
+        GLuint drawFramebuffer;
+        GLuint readFramebuffer;
+        GLuint capabilities[kCapabilityCount]; // 0, 1 o kUnknown
+        GLuint depthFunction;
+        GLuint depthMask;
+        GLuint colorMask;
+        GLuint blendSource;
+        GLuint blendDestination;
+        GLuint cullFace;
+        GLint viewport[4];
+        bool viewportKnown;
+    };
+
+    CachedState unknownState()
+    {
+        CachedState s;
+        s.program = kUnknown;
+        s.vertexArray = kUnknown;
+        for (GLuint& buffer : s.buffers)
+            buffer = kUnknown;
+        for (IndexedBinding& binding : s.uniformBindings)
+            binding = IndexedBinding{ kUnknown, 0, 0 };
+        s.activeUnit = kUnknown;
+        for (auto& unit : s.textures)
+            for (GLuint& texture : unit)
+                texture = kUnknown;
+        s.drawFramebuffer = kUnknown;
+        s.readFramebuffer = kUnknown;
+        for (GLuint& capability : s.capabilities)
+            capability = kUnknown;
+        s.depthFunction = kUnknown;
+        s.depthMask = kUnknown;
+        s.colorMask = kUnknown;
+        s.blendSource = kUnknown;
+        s.blendDestination = kUnknown;
+        s.cullFace = kUnknown;
+        s.viewportKnown = false;
+        return s;
+    }
+
+    thread_local CachedState state = unknownState();
+    thread_local GLStateCounters counters = { 0, 0 };
+
+    // true (y se apunta el valor) si hay que llamar a GL
+    bool change(GLuint& cached, GLuint value)
+    {
+        if (cached == value)
+        {
+            ++counters.elided;
+            return false;
+        }
+        cached = value;
+        ++counters.issued;
+        return true;
+    }
+
+    template <typename T, std::size_t N>
+    int slotOf(const T (&table)[N], GLenum value)
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            if (table[i] == value)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void setCapability(GLenum capability, bool enabled)
+    {
+        int slot = slotOf(kCapabilities, capability);
+        if (slot < 0)
+        {
+            ++counters.issued;
+        }
+        else if (!change(state.capabilities[slot], enabled ? 1u : 0u))
+        {
+            return;
+        }
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+    }
+}
+
+void cachedUseProgram(GLuint program)
+{
+    if (change(state.program, program))
+        glUseProgram(program);
+}
+
+void cachedBindVertexArray(GLuint vertexArray)
+{
+    if (!change(state.vertexArray, vertexArray))
+        return;
+    glBindVertexArray(vertexArray);
+    // El EBO forma parte del VAO: ahora es el que tenga el nuevo
+    state.buffers[kElementArraySlot] = kUnknown;
+}
+
+void cachedBindBuffer(GLenum target, GLuint buffer)
+{
+    int slot = slotOf(kBufferTargets, target);
+    if (slot < 0)
+        ++counters.issued;
+    else if (!change(state.buffers[slot], buffer))
+        return;
+    glBindBuffer(target, buffer);
+}
+
+void cachedBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+    if (target == GL_UNIFORM_BUFFER && index < kUniformBindings)
+    {
+        IndexedBinding& binding = state.uniformBindings[index];
+        if (binding.buffer == buffer && binding.offset == offset && binding.size == size)
+        {
+            ++counters.elided;
+            return;
+        }
+        binding = IndexedBinding{ buffer, offset, size };
+    }
+    ++counters.issued;
+    glBindBufferRange(target, index, buffer, offset, size);
+
+    int slot = slotOf(kBufferTargets, target);
+    if (slot >= 0)
+        state.buffers[slot] = buffer;
+}
+
+void cachedBindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    int slot = slotOf(kTextureTargets, target);
+    if (unit < kTextureUnits && slot >= 0)
+    {
+        if (state.textures[unit][slot] == texture)
+        {
+            ++counters.elided;
+            return;
+        }
+        state.textures[unit][slot] = texture;
+    }
+    if (change(state.activeUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+    ++counters.issued;
+    glBindTexture(target, texture);
+}
+
+void cachedBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+    bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    if ((!draw || state.drawFramebuffer == framebuffer) && (!read || state.readFramebuffer == framebuffer))
+    {
+        ++counters.elided;
+        return;
+    }
+    if (draw)
+        state.drawFramebuffer = framebuffer;
+    if (read)
+        state.readFramebuffer = framebuffer;
+    ++counters.issued;
+    glBindFramebuffer(target, framebuffer);
+}
+
+void cachedEnable(GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void cachedDisable(GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+void cachedDepthFunc(GLenum function)
+{
+    if (change(state.depthFunction, function))
+        glDepthFunc(function);
+}
+
+void cachedDepthMask(bool write)
+{
+    if (change(state.depthMask, write ? 1u : 0u))
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void cachedColorMask(bool write)
+{
+    if (change(state.colorMask, write ? 1u : 0u))
+    {
+        GLboolean value = write ? GL_TRUE : GL_FALSE;
+        glColorMask(value, value, value, value);
+    }
+}
+
+void cachedBlendFunc(GLenum source, GLenum destination)
+{
+    if (state.blendSource == source && state.blendDestination == destination)
+    {
+        ++counters.elided;
+        return;
+    }
+    state.blendSource = source;
+    state.blendDestination = destination;
+    ++counters.issued;
+    glBlendFunc(source, destination);
+}
+
+void cachedCullFace(GLenum face)
+{
+    if (change(state.cullFace, face))
+        glCullFace(face);
+}
+
+void cachedViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    GLint* viewport = state.viewport;
+    if (state.viewportKnown && viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+    {
+        ++counters.elided;
+        return;
+    }
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+    state.viewportKnown = true;
+    ++counters.issued;
+    glViewport(x, y, width, height);
+}
+
+void cachedDeleteBuffers(GLsizei count, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (buffers[i] == 0)
+            continue;
+        for (GLuint& bound : state.buffers)
+        {
+            if (bound == buffers[i])
+                bound = 0;
+        }
+        for (IndexedBinding& binding : state.uniformBindings)
+        {
+            if (binding.buffer == buffers[i])
+                binding = IndexedBinding{ 0, 0, 0 };
+        }
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void cachedDeleteVertexArrays(GLsizei count, const GLuint* vertexArrays)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (vertexArrays[i] != 0 && state.vertexArray == vertexArrays[i])
+        {
+            state.vertexArray = 0;
+            state.buffers[kElementArraySlot] = kUnknown;
+        }
+    }
+    glDeleteVertexArrays(count, vertexArrays);
+}
+
+void cachedDeleteTextures(GLsizei count, const GLuint* textures)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (textures[i] == 0)
+            continue;
+        for (auto& unit : state.textures)
+        {
+            for (GLuint& bound : unit)
+            {
+                if (bound == textures[i])
+                    bound = 0;
+            }
+        }
+    }
+    glDeleteTextures(count, textures);
+}
+
+void cachedDeleteFramebuffers(GLsizei count, const GLuint* framebuffers)
+{
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (framebuffers[i] == 0)
+            continue;
+        if (state.drawFramebuffer == framebuffers[i])
+            state.drawFramebuffer = 0;
+        if (state.readFramebuffer == framebuffers[i])
+            state.readFramebuffer = 0;
+    }
+    glDeleteFramebuffers(count, framebuffers);
+}
+
+void resetGLStateCache()
+{
+    state = unknownState();
+}
+
+void beginGLStateFrame()
+{
+    counters = GLStateCounters{ 0, 0 };
+}
+
+GLStateCounters getGLStateFrameCounters()
+{
+    return counters;
+}
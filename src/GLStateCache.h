@@ -0,0 +1,52 @@
+//src/GLStateCache.h
+#pragma once
+#include <glad/glad.h>
+
+// ---------------------------------------------------
+// Caché del estado de OpenGL. Cada función cached* recuerda el último
+// valor que envió y no llama a GL si el nuevo es el mismo: Bind() de un
+// programa ya activo, el VAO que ya está enlazado, el mismo viewport...
+// Solo funciona si todo el código que cambia ese estado pasa por aquí;
+// tras tocarlo directamente con gl* hay que llamar a resetGLStateCache().
+// El estado es por hilo (cada hilo tiene su propio contexto).
+// ---------------------------------------------------
+
+// Llamadas enviadas a GL frente a las evitadas por no cambiar nada
+struct GLStateCounters {
+    unsigned long long issued;
+    unsigned long long elided;
+};
+
+void cachedUseProgram(GLuint program);
+void cachedBindVertexArray(GLuint vertexArray);
+void cachedBindBuffer(GLenum target, GLuint buffer);
+// Enlace indexado (bloques uniform); también cambia el enlace genérico
+void cachedBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+// Activa la unidad solo si hace falta enlazar algo distinto en ella
+void cachedBindTexture(GLuint unit, GLenum target, GLuint texture);
+// GL_FRAMEBUFFER cambia el de dibujo y el de lectura
+void cachedBindFramebuffer(GLenum target, GLuint framebuffer);
+
+void cachedEnable(GLenum capability);
+void cachedDisable(GLenum capability);
+void cachedDepthFunc(GLenum function);
+void cachedDepthMask(bool write);
+// Los cuatro canales a la vez
+void cachedColorMask(bool write);
+void cachedBlendFunc(GLenum source, GLenum destination);
+void cachedCullFace(GLenum face);
+void cachedViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+// Borrar un objeto enlazado lo desenlaza: la caché debe saberlo porque
+// GL puede reutilizar el nombre para un objeto nuevo
+void cachedDeleteBuffers(GLsizei count, const GLuint* buffers);
+void cachedDeleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+void cachedDeleteTextures(GLsizei count, const GLuint* textures);
+void cachedDeleteFramebuffers(GLsizei count, const GLuint* framebuffers);
+
+// Olvida todo lo conocido: la siguiente llamada de cada tipo se envía
+void resetGLStateCache();
+
+// Contadores por frame: beginGLStateFrame los pone a cero
+void beginGLStateFrame();
+GLStateCounters getGLStateFrameCounters();
@@ -0,0 +1,153 @@
+// src/Lod.cpp
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include "Lod.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+
+namespace {
+    // Longitud máxima en píxeles de una arista de la silueta
+    const float kMaxEdgePixels = 8.0f;
+    const float kHysteresis = 0.15f;
+
+    // Una silueta de n segmentos con radio R px tiene aristas de 2*pi*R/n px
+    float maxRadiusForSegments(int segments)
+    {
+        return kMaxEdgePixels * segments / (2.0f * 3.14159265f);
+    }
+
+    // Sube a la descripción del generador si cambian los generadores o el
+    // optimizador: invalida las mallas guardadas en la cache
+    const char* kGeneratorRevision = "r1";
+
+    // Carga la cadena de la cache de mallas (mmap, sin parseo) o la genera,
+    // la optimiza y la guarda para el siguiente arranque
+    LodChain createCachedLod(const std::string& name, const std::string& description, float boundingRadius,
+        const std::vector<float>& maxRadius, const std::function<MeshData(std::size_t)>& generate)
+    {
+        const VertexLayout& layout = defaultVertexLayout();
+        std::uint64_t tag = meshFileTag(description + " " + kGeneratorRevision);
+
+        std::string path;
+        if (!meshCacheDirectory().empty())
+        {
+            path = meshCacheDirectory() + "/" + name + "_" + positionFormatName(layout.position) + "_" +
+                normalFormatName(layout.normal) + ".mesh";
+            LodChain cached;
+            if (loadMeshFile(path, tag, layout, cached))
+                return cached;
+        }
+
+        std::vector<MeshData> meshes(maxRadius.size());
+        for (std::size_t i = 0; i < meshes.size(); ++i)
+        {
+            meshes[i] = generate(i);
+            optimizeMesh(meshes[i]);
+        }
+        if (!path.empty())
+            saveMeshFile(path, tag, layout, meshes, maxRadius, boundingRadius);
+
+        LodChain chain{};
+        for (const MeshData& mesh : meshes)
+            chain.levels.push_back(createShapeFromVertices(mesh, layout));
+        chain.maxScreenRadius = maxRadius;
+        chain.boundingRadius = boundingRadius;
+        return chain;
+    }
+}
+
+LodChain createSphereLod()
+{
+    // Sectores x stacks; el nivel 2 equivale a la esfera fija anterior
+    const int levels[][2] = { { 128, 96 }, { 64, 48 }, { 32, 24 }, { 16, 12 } };
+
+    std::string description = "sphere";
+    std::vector<float> maxRadius;
+    for (const auto& level : levels)
+    {
+        description += " " + std::to_string(level[0]) + "x" + std::to_string(level[1]);
+        maxRadius.push_back(maxRadiusForSegments(level[0]));
+    }
+    return createCachedLod("sphere", description, 1.0f, maxRadius, [&](std::size_t i) {
+        return generateSphere(levels[i][0], levels[i][1]);
+        });
+}
+
+LodChain createTorusLod(float majorRadius, float minorRadius)
+{
+    // La silueta exterior (anillo mayor) es la que delata las facetas
+    const int levels[][2] = { { 128, 64 }, { 64, 32 }, { 32, 16 }, { 16, 8 } };
+
+    std::string description = "torus " + std::to_string(majorRadius) + " " + std::to_string(minorRadius);
+    std::vector<float> maxRadius;
+    for (const auto& level : levels)
+    {
+        description += " " + std::to_string(level[0]) + "x" + std::to_string(level[1]);
+        maxRadius.push_back(maxRadiusForSegments(level[0]));
+    }
+    return createCachedLod("torus", description, majorRadius + minorRadius, maxRadius, [&](std::size_t i) {
+        return generateTorus(levels[i][0], levels[i][1], majorRadius, minorRadius);
+        });
+}
+
+LodChain createSingleLod(Shape shape, float boundingRadius)
+{
+    LodChain chain{};
+    chain.levels.push_back(shape);
+    chain.maxScreenRadius.push_back(std::numeric_limits<float>::max());
+    chain.boundingRadius = boundingRadius;
+    return chain;
+}
+
+void destroyLodChain(LodChain& chain)
+{
+    for (Shape& shape : chain.levels)
+        destroyShape(shape);
+    chain = LodChain{};
+}
+
+float projectedRadius(const LodChain& chain, const glm::mat4& model, const glm::mat4& view,
+    const glm::mat4& projection, int viewportHeight)
+{
+    glm::vec4 center = view * model * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // La escala más grande de model acota el radio en el mundo
+    float maxScaleSq = std::max({ glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                  glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                  glm::dot(glm::vec3(model[2]), glm::vec3(model[2])) });
+    float radius = chain.boundingRadius * std::sqrt(maxScaleSq);
+
+    // Cámara dentro de la esfera envolvente: máximo detalle
+    float distance = -center.z;
+    if (distance <= radius)
+        return std::numeric_limits<float>::max();
+
+    // projection[1][1] = 1 / tan(fovy / 2)
+    return radius * projection[1][1] / distance * 0.5f * viewportHeight;
+}
+
+int selectLodLevel(LodChain& chain, float screenRadius)
+{
+    int last = static_cast<int>(chain.levels.size()) - 1;
+    int level = std::min(std::max(chain.currentLevel, 0), last);
+
+    // Más detalle si el nivel actual ya no basta (con margen)
+    while (level > 0 && screenRadius > chain.maxScreenRadius[level] * (1.0f + kHysteresis))
+        --level;
+    // Menos detalle si el siguiente nivel basta con margen
+    while (level < last && screenRadius < chain.maxScreenRadius[level + 1] * (1.0f - kHysteresis))
+        ++level;
+
+    chain.currentLevel = level;
+    return level;
+}
+
+void drawLodLevel(const LodChain& chain, int level, LodStats& stats)
+{
+    drawShape(chain.levels[level]);
+    stats.drawnTriangles += chain.levels[level].indexCount / 3;
+    stats.fullDetailTriangles += chain.levels[0].indexCount / 3;
+}
@@ -0,0 +1,40 @@
+//src/Lod.h
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// ---------------------------------------------------
+// Cadena de niveles de detalle de una forma (0 = más detallado).
+// Cada nivel basta mientras el radio proyectado de la esfera envolvente
+// no supere maxScreenRadius (px): por encima las facetas se notan.
+// ---------------------------------------------------
+struct LodChain {
+    std::vector<Shape> levels;
+    std::vector<float> maxScreenRadius;
+    float boundingRadius;  // radio de la esfera envolvente en espacio del objeto
+    int currentLevel;      // último nivel elegido (para la histéresis)
+};
+
+// Triángulos dibujados frente a los del nivel más detallado
+struct LodStats {
+    unsigned long long drawnTriangles;
+    unsigned long long fullDetailTriangles;
+};
+
+LodChain createSphereLod();
+LodChain createTorusLod(float majorRadius, float minorRadius);
+// Forma sin niveles (cubo, pirámide): siempre el nivel 0
+LodChain createSingleLod(Shape shape, float boundingRadius);
+void destroyLodChain(LodChain& chain);
+
+// Radio en píxeles de la esfera envolvente tras model/view/projection
+float projectedRadius(const LodChain& chain, const glm::mat4& model, const glm::mat4& view,
+    const glm::mat4& projection, int viewportHeight);
+
+// Nivel para ese radio proyectado. Solo cambia cuando el radio se aleja
+// más de un 15% del umbral, para que el nivel no parpadee en el borde.
+int selectLodLevel(LodChain& chain, float screenRadius);
+
+// Dibuja el nivel y acumula los triángulos en stats
+void drawLodLevel(const LodChain& chain, int level, LodStats& stats);
@@ -0,0 +1,34 @@
+//src/MappedFile.h
+#pragma once
+#include <cstddef>
+#include <string>
+
+// ---------------------------------------------------
+// Fichero proyectado en memoria de solo lectura: mmap en POSIX,
+// CreateFileMapping/MapViewOfFile en Windows. Las páginas se leen del
+// disco (o de la cache del sistema) al tocarlas por primera vez.
+// ---------------------------------------------------
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { Open(path); }
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // false si no existe, está vacío o no se puede proyectar
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const unsigned char* Data() const { return data; }
+    std::size_t Size() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
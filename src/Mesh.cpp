@@ -0,0 +1,521 @@
+// src/Mesh.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "SinCos.h"
+
+// ---------------------------------------------------
+// Fusionar vértices idénticos de una lista de triángulos
+// ---------------------------------------------------
+namespace {
+    struct VertexKey {
+        float v[6];
+        bool operator==(const VertexKey& other) const {
+            return std::memcmp(v, other.v, sizeof(v)) == 0;
+        }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& key) const {
+            unsigned int bits[6];
+            std::memcpy(bits, key.v, sizeof(bits));
+            size_t hash = 0;
+            for (unsigned int b : bits)
+                hash = hash * 31u + b;
+            return hash;
+        }
+    };
+}
+
+MeshData weldVertices(const std::vector<float>& soup)
+{
+    MeshData mesh;
+    std::unordered_map<VertexKey, unsigned int, VertexKeyHash> unique;
+
+    size_t count = soup.size() / 6;
+    mesh.indices.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        VertexKey key;
+        std::memcpy(key.v, &soup[i * 6], sizeof(key.v));
+
+        auto it = unique.find(key);
+        if (it == unique.end())
+        {
+            unsigned int index = static_cast<unsigned int>(mesh.VertexCount());
+            mesh.vertices.insert(mesh.vertices.end(), key.v, key.v + 6);
+            it = unique.emplace(key, index).first;
+        }
+        mesh.indices.push_back(it->second);
+    }
+    return mesh;
+}
+
+ShapeBounds computeBounds(const MeshData& mesh)
+{
+    ShapeBounds bounds{};
+    if (mesh.VertexCount() == 0)
+        return bounds;
+
+    bounds.boxMin = glm::vec3(mesh.vertices[0], mesh.vertices[1], mesh.vertices[2]);
+    bounds.boxMax = bounds.boxMin;
+    for (size_t i = 0; i < mesh.VertexCount(); ++i)
+    {
+        glm::vec3 p(mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+        bounds.boxMin = glm::min(bounds.boxMin, p);
+        bounds.boxMax = glm::max(bounds.boxMax, p);
+    }
+
+    // Radio desde el centro de la caja: no es la esfera mínima, pero
+    // comparte centro con la caja y el test de culling usa ambos
+    bounds.sphereCenter = 0.5f * (bounds.boxMin + bounds.boxMax);
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < mesh.VertexCount(); ++i)
+    {
+        glm::vec3 p(mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+        glm::vec3 d = p - bounds.sphereCenter;
+        radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+    }
+    bounds.sphereRadius = std::sqrt(radiusSquared);
+    return bounds;
+}
+
+void normalizeMesh(MeshData& mesh, float radius)
+{
+    if (mesh.VertexCount() == 0)
+        return;
+
+    glm::vec3 minimum(mesh.vertices[0], mesh.vertices[1], mesh.vertices[2]);
+    glm::vec3 maximum = minimum;
+    for (size_t i = 0; i < mesh.VertexCount(); ++i)
+    {
+        glm::vec3 p(mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+        minimum = glm::min(minimum, p);
+        maximum = glm::max(maximum, p);
+    }
+
+    glm::vec3 center = 0.5f * (minimum + maximum);
+    float largest = 0.0f;
+    for (size_t i = 0; i < mesh.VertexCount(); ++i)
+    {
+        glm::vec3 p(mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+        largest = std::max(largest, glm::length(p - center));
+    }
+
+    // Escala uniforme: las normales no cambian
+    float scale = largest > 0.0f ? radius / largest : 1.0f;
+    for (size_t i = 0; i < mesh.VertexCount(); ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+            mesh.vertices[i * 6 + axis] = (mesh.vertices[i * 6 + axis] - center[axis]) * scale;
+    }
+}
+
+// ---------------------------------------------------
+// Crear VAO + VBO + EBO a partir de una malla indexada
+// Entrada: [posx, posy, posz, nx, ny, nz, ...]; en el VBO, con el
+// formato del layout (12 bytes por vértice con snorm16 + octaédrica)
+// ---------------------------------------------------
+Shape createShapeFromVertices(const MeshData& mesh, const VertexLayout& layout)
+{
+    glm::vec3 scale, offset;
+    std::vector<unsigned char> vertices = encodeVertices(mesh.vertices, layout, scale, offset);
+    GLsizei vertexCount = static_cast<GLsizei>(mesh.VertexCount()); // 3 pos + 3 normal
+    GLsizei indexCount = static_cast<GLsizei>(mesh.indices.size());
+    ShapeBounds bounds = computeBounds(mesh);
+
+    if (indexTypeForVertexCount(mesh.VertexCount()) == GL_UNSIGNED_SHORT)
+    {
+        // Índices de 16 bits: la mitad de memoria y de ancho de banda
+        std::vector<unsigned short> indices16(mesh.indices.begin(), mesh.indices.end());
+        return createShapeFromEncoded(vertices.data(), vertexCount, indices16.data(), indexCount,
+            GL_UNSIGNED_SHORT, layout, scale, offset, bounds);
+    }
+    return createShapeFromEncoded(vertices.data(), vertexCount, mesh.indices.data(), indexCount,
+        GL_UNSIGNED_INT, layout, scale, offset, bounds);
+}
+
+Shape createShapeFromEncoded(const void* vertices, GLsizei vertexCount, const void* indices, GLsizei indexCount,
+    GLenum indexType, const VertexLayout& layout, const glm::vec3& positionScale, const glm::vec3& positionOffset,
+    const ShapeBounds& bounds)
+{
+    Shape s{};
+    s.vertexCount = vertexCount;
+    s.indexCount = indexCount;
+    s.indexType = indexType;
+    s.layout = layout;
+    s.positionScale = positionScale;
+    s.positionOffset = positionOffset;
+    s.bounds = bounds;
+
+    glGenVertexArrays(1, &s.VAO);
+    glGenBuffers(1, &s.VBO);
+    glGenBuffers(1, &s.EBO);
+
+    cachedBindVertexArray(s.VAO);
+
+    cachedBindBuffer(GL_ARRAY_BUFFER, s.VBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexCount) * vertexStride(layout), vertices, GL_STATIC_DRAW);
+
+    // El EBO queda asociado al VAO: se enlaza con el VAO activo
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s.EBO);
+    GLsizeiptr indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize, indices, GL_STATIC_DRAW);
+
+    // Posiciones y normales según el layout
+    setupVertexAttributes(layout);
+
+    cachedBindVertexArray(0);
+    cachedBindBuffer(GL_ARRAY_BUFFER, 0);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    return s;
+}
+
+GLenum indexTypeForVertexCount(std::size_t vertexCount)
+{
+    return vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+void bindShapeVertices(const Shape& shape)
+{
+    cachedBindBuffer(GL_ARRAY_BUFFER, shape.VBO);
+    setupVertexAttributes(shape.layout);
+}
+
+glm::mat4 positionDecodeMatrix(const Shape& shape)
+{
+    glm::mat4 decode(1.0f);
+    decode[0][0] = shape.positionScale.x;
+    decode[1][1] = shape.positionScale.y;
+    decode[2][2] = shape.positionScale.z;
+    decode[3] = glm::vec4(shape.positionOffset, 1.0f);
+    return decode;
+}
+
+void drawShape(const Shape& shape)
+{
+    // El VAO se queda enlazado: si el siguiente draw usa la misma forma
+    // no hace falta volver a enlazarlo
+    cachedBindVertexArray(shape.VAO);
+    glDrawElements(GL_TRIANGLES, shape.indexCount, shape.indexType, (void*)0);
+}
+
+void destroyShape(Shape& shape)
+{
+    cachedDeleteVertexArrays(1, &shape.VAO);
+    cachedDeleteBuffers(1, &shape.VBO);
+    cachedDeleteBuffers(1, &shape.EBO);
+    shape = Shape{};
+}
+
+// ---------------------------------------------------
+// Cubo (centrado en el origen)
+// ---------------------------------------------------
+MeshData generateCube()
+{
+    // 36 vértices (12 triángulos), cada uno pos + normal
+    float vertices[] = {
+        // Posición          // Normal
+        // Cara frontal
+        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+         1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+
+         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+        -1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
+
+        // Cara trasera
+        -1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+         1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+         1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+
+         1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+        -1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+        -1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
+
+        // Cara izquierda
+        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f,  1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
+
+        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f, -1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
+
+        // Cara derecha
+         1.0f,  1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f, -1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f,  1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+
+         1.0f, -1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f,  1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
+         1.0f, -1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
+
+         // Cara superior
+         -1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+          1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
+          1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+
+          1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
+         -1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
+         -1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
+
+         // Cara inferior
+         -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
+          1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
+          1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+
+          1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+         -1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
+         -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f
+    };
+
+    std::vector<float> data(vertices, vertices + sizeof(vertices) / sizeof(float));
+    return weldVertices(data); // 24 vértices únicos (4 por cara)
+}
+
+// ---------------------------------------------------
+// Pirámide (base cuadrada)
+// ---------------------------------------------------
+MeshData generatePyramid()
+{
+    // Pirámide centrada, altura 2, base de 2x2
+    std::vector<float> data;
+
+    glm::vec3 top(0.0f, 1.0f, 0.0f);
+    glm::vec3 bl(-1.0f, -1.0f, 1.0f); // bottom-left front
+    glm::vec3 br(1.0f, -1.0f, 1.0f); // bottom-right front
+    glm::vec3 brb(1.0f, -1.0f, -1.0f); // bottom-right back
+    glm::vec3 blb(-1.0f, -1.0f, -1.0f); // bottom-left back
+
+    auto addTriangle = [&](glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
+        glm::vec3 u = p2 - p1;
+        glm::vec3 v = p3 - p1;
+        glm::vec3 n = glm::normalize(glm::cross(u, v));
+        // p1
+        data.push_back(p1.x); data.push_back(p1.y); data.push_back(p1.z);
+        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
+        // p2
+        data.push_back(p2.x); data.push_back(p2.y); data.push_back(p2.z);
+        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
+        // p3
+        data.push_back(p3.x); data.push_back(p3.y); data.push_back(p3.z);
+        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
+        };
+
+    // Lados
+    addTriangle(top, bl, br);    // frente
+    addTriangle(top, br, brb);   // derecha
+    addTriangle(top, brb, blb);  // atrás
+    addTriangle(top, blb, bl);   // izquierda
+
+    // Base (dos triángulos)
+    glm::vec3 nBase(0.0f, -1.0f, 0.0f);
+
+    auto addBaseTri = [&](glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
+        data.push_back(p1.x); data.push_back(p1.y); data.push_back(p1.z);
+        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
+
+        data.push_back(p2.x); data.push_back(p2.y); data.push_back(p2.z);
+        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
+
+        data.push_back(p3.x); data.push_back(p3.y); data.push_back(p3.z);
+        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
+        };
+
+    addBaseTri(bl, br, brb);
+    addBaseTri(brb, blb, bl);
+
+    return weldVertices(data);
+}
+
+
+// ---------------------------------------------------
+// Esfera generada por sectores y stacks
+// Cada anillo interior comparte sus vértices con los cuatro quads
+// vecinos; los polos son un único vértice.
+// El tamaño de la salida se conoce de antemano: se reserva una vez y
+// cada stack escribe su rango de vértices e índices, en paralelo.
+// Los senos/cosenos salen de dos tablas (stacks y sectores): ninguna
+// llamada a sinf/cosf dentro de los bucles.
+// ---------------------------------------------------
+MeshData generateSphere(int sectorCount, int stackCount, ThreadPool& pool)
+{
+    MeshData mesh;
+
+    float radius = 1.0f;
+    float pi = 3.14159265f;
+    float twoPi = 2.0f * pi;
+
+    // Polo norte, (stackCount-1) anillos de sectorCount vértices y polo sur.
+    // El primer y el último stack tienen un triángulo por sector, el resto dos.
+    std::size_t ringVertices = static_cast<std::size_t>(stackCount - 1) * sectorCount;
+    std::size_t triangleCount = stackCount > 1 ? 2 * ringVertices : 0;
+    mesh.vertices.resize((ringVertices + 2) * 6);
+    mesh.indices.resize(triangleCount * 3);
+
+    float* vertices = mesh.vertices.data();
+    unsigned int* indices = mesh.indices.data();
+
+    // Senos y cosenos de cada stack y cada sector, calculados una sola vez
+    std::vector<float> stackSin, stackCos, sectorSin, sectorCos;
+    sinCosTable(pi / 2, -(pi / stackCount), stackCount, stackSin, stackCos);
+    sinCosTable(0.0f, twoPi / sectorCount, sectorCount, sectorSin, sectorCos);
+
+    unsigned int southPole = static_cast<unsigned int>(ringVertices + 1);
+    const float poles[12] = { 0.0f, radius, 0.0f, 0.0f, 1.0f, 0.0f,
+                              0.0f, -radius, 0.0f, 0.0f, -1.0f, 0.0f };
+    std::copy(poles, poles + 6, vertices);
+    std::copy(poles + 6, poles + 12, vertices + southPole * 6);
+
+    auto ringVertex = [&](int stack, int sector) -> unsigned int {
+        if (stack == 0) return 0;
+        if (stack == stackCount) return southPole;
+        return 1 + (stack - 1) * sectorCount + (sector % sectorCount);
+        };
+
+    // Como mínimo ~4096 vértices por bloque para que compense despertar hilos
+    int minStacks = std::max(1, 4096 / std::max(sectorCount, 1));
+    pool.ParallelFor(stackCount, minStacks, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            // Anillo superior del stack i (el del stack 0 es el polo)
+            if (i != 0)
+            {
+                float y = radius * stackSin[i];
+                float r = radius * stackCos[i];
+
+                float* out = vertices + ringVertex(i, 0) * 6;
+                for (int j = 0; j < sectorCount; ++j, out += 6)
+                {
+                    // Normal analítica: (cos(stack) cos(sector), sin(stack), cos(stack) sin(sector))
+                    out[0] = r * sectorCos[j]; out[1] = y; out[2] = r * sectorSin[j];
+                    out[3] = stackCos[i] * sectorCos[j]; out[4] = stackSin[i]; out[5] = stackCos[i] * sectorSin[j];
+                }
+            }
+
+            std::size_t firstTriangle = i == 0 ? 0 : sectorCount + static_cast<std::size_t>(i - 1) * 2 * sectorCount;
+            unsigned int* out = indices + firstTriangle * 3;
+            for (int j = 0; j < sectorCount; ++j)
+            {
+                unsigned int p1 = ringVertex(i, j);
+                unsigned int p2 = ringVertex(i, j + 1);
+                unsigned int p3 = ringVertex(i + 1, j);
+                unsigned int p4 = ringVertex(i + 1, j + 1);
+
+                // triángulo 1 (degenerado en el polo norte)
+                if (i != 0) {
+                    *out++ = p1; *out++ = p2; *out++ = p3;
+                }
+                // triángulo 2 (degenerado en el polo sur)
+                if (i != stackCount - 1) {
+                    *out++ = p2; *out++ = p4; *out++ = p3;
+                }
+            }
+        }
+        });
+
+    return mesh;
+}
+
+// ---------------------------------------------------
+// Toro (donut) paramétrico
+// Rejilla numMajor x numMinor cerrada en ambas direcciones; cada anillo
+// mayor escribe sus numMinor vértices y 2*numMinor triángulos, en paralelo.
+// ---------------------------------------------------
+MeshData generateTorus(int numMajor, int numMinor, float majorRadius, float minorRadius, ThreadPool& pool)
+{
+    MeshData mesh;
+
+    float twoPi = 2.0f * 3.14159265f;
+
+    std::size_t vertexCount = static_cast<std::size_t>(numMajor) * numMinor;
+    mesh.vertices.resize(vertexCount * 6);
+    mesh.indices.resize(vertexCount * 6);
+
+    float* vertices = mesh.vertices.data();
+    unsigned int* indices = mesh.indices.data();
+
+    std::vector<float> majorSin, majorCos, minorSin, minorCos;
+    sinCosTable(0.0f, twoPi / numMajor, numMajor, majorSin, majorCos);
+    sinCosTable(0.0f, twoPi / numMinor, numMinor, minorSin, minorCos);
+
+    auto gridVertex = [&](int i, int j) -> unsigned int {
+        return (i % numMajor) * numMinor + (j % numMinor);
+        };
+
+    int minRings = std::max(1, 4096 / std::max(numMinor, 1));
+    pool.ParallelFor(numMajor, minRings, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            float x = majorCos[i];
+            float y = majorSin[i];
+
+            float* out = vertices + static_cast<std::size_t>(i) * numMinor * 6;
+            for (int j = 0; j < numMinor; ++j, out += 6)
+            {
+                float r = minorRadius * minorCos[j] + majorRadius;
+                float z = minorRadius * minorSin[j];
+
+                // Normal analítica: dirección desde el centro del tubo
+                out[0] = r * x; out[1] = r * y; out[2] = z;
+                out[3] = minorCos[j] * x; out[4] = minorCos[j] * y; out[5] = minorSin[j];
+            }
+
+            unsigned int* tri = indices + static_cast<std::size_t>(i) * numMinor * 6;
+            for (int j = 0; j < numMinor; ++j)
+            {
+                unsigned int p1 = gridVertex(i, j);
+                unsigned int p2 = gridVertex(i + 1, j);
+                unsigned int p3 = gridVertex(i, j + 1);
+                unsigned int p4 = gridVertex(i + 1, j + 1);
+
+                // triángulo 1
+                *tri++ = p1; *tri++ = p2; *tri++ = p3;
+                // triángulo 2
+                *tri++ = p2; *tri++ = p4; *tri++ = p3;
+            }
+        }
+        });
+
+    return mesh;
+}
+
+// ---------------------------------------------------
+// Formas listas para dibujar: la malla pasa por el optimizador
+// (cache de vértices, overdraw y orden de lectura) antes de subirse
+// ---------------------------------------------------
+namespace {
+    Shape createOptimizedShape(MeshData mesh)
+    {
+        optimizeMesh(mesh);
+        return createShapeFromVertices(mesh);
+    }
+}
+
+Shape createCube()
+{
+    return createOptimizedShape(generateCube());
+}
+
+Shape createPyramid()
+{
+    return createOptimizedShape(generatePyramid());
+}
+
+Shape createSphere(int sectorCount, int stackCount)
+{
+    return createOptimizedShape(generateSphere(sectorCount, stackCount));
+}
+
+Shape createTorus(int numMajor, int numMinor, float majorRadius, float minorRadius)
+{
+    return createOptimizedShape(generateTorus(numMajor, numMinor, majorRadius, minorRadius));
+}
@@ -0,0 +1,87 @@
+//src/Mesh.h
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "ThreadPool.h"
+#include "VertexFormat.h"
+
+// ---------------------------------------------------
+// Malla en CPU: vértices intercalados [px, py, pz, nx, ny, nz, ...]
+// más una lista de índices (3 por triángulo)
+// ---------------------------------------------------
+struct MeshData {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+
+    std::size_t VertexCount() const { return vertices.size() / 6; }
+};
+
+// Volúmenes envolventes en espacio del objeto (posiciones sin
+// cuantizar). La esfera está centrada en el centro de la caja.
+struct ShapeBounds {
+    glm::vec3 boxMin;
+    glm::vec3 boxMax;
+    glm::vec3 sphereCenter;
+    float sphereRadius;
+};
+
+// ---------------------------------------------------
+// Forma lista para dibujar (VAO + buffers + número de índices)
+// ---------------------------------------------------
+struct Shape {
+    GLuint VAO;
+    GLuint VBO;
+    GLuint EBO;
+    GLsizei vertexCount;
+    GLsizei indexCount;
+    GLenum indexType; // GL_UNSIGNED_SHORT o GL_UNSIGNED_INT según vertexCount
+    VertexLayout layout;
+    glm::vec3 positionScale;  // posición = cuantizada * scale + offset
+    glm::vec3 positionOffset;
+    ShapeBounds bounds;       // calculados al generar la malla (culling)
+};
+
+// Convierte una lista de triángulos sueltos (3 vértices por triángulo)
+// en malla indexada, fusionando los vértices idénticos
+MeshData weldVertices(const std::vector<float>& soup);
+
+ShapeBounds computeBounds(const MeshData& mesh);
+
+// Centra la caja envolvente en el origen y escala la malla para que
+// quepa en una esfera de ese radio (modelos cargados de fichero)
+void normalizeMesh(MeshData& mesh, float radius);
+
+// Sube la malla a GPU con el formato de vértice indicado; los índices
+// se guardan en 16 bits si caben
+Shape createShapeFromVertices(const MeshData& mesh, const VertexLayout& layout = defaultVertexLayout());
+// Sube vértices ya codificados e índices de 16 o 32 bits tal cual, sin
+// copias intermedias (por ejemplo, desde un fichero proyectado en memoria).
+// Los volúmenes se calcularon al generar la malla original.
+Shape createShapeFromEncoded(const void* vertices, GLsizei vertexCount, const void* indices, GLsizei indexCount,
+    GLenum indexType, const VertexLayout& layout, const glm::vec3& positionScale, const glm::vec3& positionOffset,
+    const ShapeBounds& bounds);
+// GL_UNSIGNED_SHORT si todos los índices caben en 16 bits
+GLenum indexTypeForVertexCount(std::size_t vertexCount);
+// Enlaza el VBO de la forma y configura aPos/aNormal en el VAO activo
+void bindShapeVertices(const Shape& shape);
+// Matriz que lleva las posiciones cuantizadas al espacio del objeto:
+// se multiplica a la derecha de la matriz modelo
+glm::mat4 positionDecodeMatrix(const Shape& shape);
+void drawShape(const Shape& shape);
+void destroyShape(Shape& shape);
+
+// Generadores de geometría. Esfera y toro reservan la salida exacta y
+// reparten stacks/anillos entre los hilos del pool; el resultado es
+// idéntico bit a bit con cualquier número de hilos.
+MeshData generateCube();
+MeshData generatePyramid();
+MeshData generateSphere(int sectorCount, int stackCount, ThreadPool& pool = ThreadPool::Shared());
+MeshData generateTorus(int numMajor, int numMinor, float majorRadius, float minorRadius,
+    ThreadPool& pool = ThreadPool::Shared());
+
+Shape createCube();
+Shape createPyramid();
+Shape createSphere(int sectorCount, int stackCount);
+Shape createTorus(int numMajor, int numMinor, float majorRadius, float minorRadius);
@@ -0,0 +1,220 @@
+// src/MeshFile.cpp
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "MappedFile.h"
+#include "MeshFile.h"
+
+namespace {
+    const std::uint32_t kMeshFileVersion = 2;
+    const std::uint64_t kBlobAlignment = 64;
+
+    std::string cacheDirectory;
+
+    std::uint64_t alignUp(std::uint64_t value)
+    {
+        return (value + kBlobAlignment - 1) & ~(kBlobAlignment - 1);
+    }
+
+    std::uint64_t indexSize(std::uint32_t indexType)
+    {
+        return indexType == GL_UNSIGNED_SHORT ? sizeof(unsigned short) : sizeof(unsigned int);
+    }
+
+    // bytes a partir de offset caben en un fichero de size bytes. Sin
+    // sumar offset + bytes: un offset corrupto cerca de 2^64 desbordaría
+    bool fitsInFile(std::uint64_t offset, std::uint64_t bytes, std::uint64_t size)
+    {
+        return offset <= size && bytes <= size - offset;
+    }
+}
+
+void setMeshCacheDirectory(const std::string& directory)
+{
+    cacheDirectory = directory;
+}
+
+const std::string& meshCacheDirectory()
+{
+    return cacheDirectory;
+}
+
+std::uint64_t meshFileTag(const std::string& description)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : description)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool saveMeshFile(const std::string& path, std::uint64_t tag, const VertexLayout& layout,
+    const std::vector<MeshData>& levels, const std::vector<float>& maxScreenRadius, float boundingRadius)
+{
+    MeshFileHeader header{};
+    std::memcpy(header.magic, "SMSH", 4);
+    header.version = kMeshFileVersion;
+    header.tag = tag;
+    header.positionFormat = layout.position;
+    header.normalFormat = layout.normal;
+    header.vertexStride = static_cast<std::uint32_t>(vertexStride(layout));
+    header.levelCount = static_cast<std::uint32_t>(levels.size());
+    header.boundingRadius = boundingRadius;
+
+    // Caja envolvente del nivel más detallado
+    if (!levels.empty() && levels[0].VertexCount() > 0)
+    {
+        const std::vector<float>& v = levels[0].vertices;
+        for (int axis = 0; axis < 3; ++axis)
+            header.boundsMin[axis] = header.boundsMax[axis] = v[axis];
+        for (std::size_t i = 0; i < levels[0].VertexCount(); ++i)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                header.boundsMin[axis] = std::min(header.boundsMin[axis], v[i * 6 + axis]);
+                header.boundsMax[axis] = std::max(header.boundsMax[axis], v[i * 6 + axis]);
+            }
+        }
+    }
+
+    // Codificar todo y calcular los desplazamientos antes de escribir
+    std::vector<MeshFileLevel> table(levels.size());
+    std::vector<std::vector<unsigned char>> vertexBlobs(levels.size());
+    std::vector<std::vector<unsigned char>> indexBlobs(levels.size());
+    std::uint64_t offset = alignUp(sizeof(MeshFileHeader) + table.size() * sizeof(MeshFileLevel));
+    for (std::size_t i = 0; i < levels.size(); ++i)
+    {
+        const MeshData& mesh = levels[i];
+        MeshFileLevel& level = table[i];
+
+        glm::vec3 scale, positionOffset;
+        vertexBlobs[i] = encodeVertices(mesh.vertices, layout, scale, positionOffset);
+        std::memcpy(level.positionScale, &scale[0], sizeof(level.positionScale));
+        std::memcpy(level.positionOffset, &positionOffset[0], sizeof(level.positionOffset));
+
+        ShapeBounds bounds = computeBounds(mesh);
+        std::memcpy(level.boxMin, &bounds.boxMin[0], sizeof(level.boxMin));
+        std::memcpy(level.boxMax, &bounds.boxMax[0], sizeof(level.boxMax));
+        std::memcpy(level.sphereCenter, &bounds.sphereCenter[0], sizeof(level.sphereCenter));
+        level.sphereRadius = bounds.sphereRadius;
+
+        level.indexType = indexTypeForVertexCount(mesh.VertexCount());
+        indexBlobs[i].resize(mesh.indices.size() * indexSize(level.indexType));
+        if (level.indexType == GL_UNSIGNED_SHORT)
+        {
+            unsigned short* out = reinterpret_cast<unsigned short*>(indexBlobs[i].data());
+            for (std::size_t k = 0; k < mesh.indices.size(); ++k)
+                out[k] = static_cast<unsigned short>(mesh.indices[k]);
+        }
+        else
+        {
+            std::memcpy(indexBlobs[i].data(), mesh.indices.data(), indexBlobs[i].size());
+        }
+
+        level.vertexCount = static_cast<std::uint32_t>(mesh.VertexCount());
+        level.indexCount = static_cast<std::uint32_t>(mesh.indices.size());
+        level.maxScreenRadius = i < maxScreenRadius.size() ? maxScreenRadius[i] : 0.0f;
+        level.vertexOffset = offset;
+        offset = alignUp(offset + vertexBlobs[i].size());
+        level.indexOffset = offset;
+        offset = alignUp(offset + indexBlobs[i].size());
+    }
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            fprintf(stderr, "Could not write mesh file: %s\n", path.c_str());
+            return false;
+        }
+
+        static const char padding[kBlobAlignment] = {};
+        auto padTo = [&](std::uint64_t position) {
+            std::uint64_t current = static_cast<std::uint64_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(position - current));
+            };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(MeshFileLevel));
+        for (std::size_t i = 0; i < levels.size(); ++i)
+        {
+            padTo(table[i].vertexOffset);
+            file.write(reinterpret_cast<const char*>(vertexBlobs[i].data()), vertexBlobs[i].size());
+            padTo(table[i].indexOffset);
+            file.write(reinterpret_cast<const char*>(indexBlobs[i].data()), indexBlobs[i].size());
+        }
+        if (!file)
+        {
+            fprintf(stderr, "Could not write mesh file: %s\n", path.c_str());
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+bool loadMeshFile(const std::string& path, std::uint64_t tag, const VertexLayout& layout, LodChain& chain)
+{
+    MappedFile file;
+    if (!file.Open(path) || file.Size() < sizeof(MeshFileHeader))
+        return false;
+
+    MeshFileHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, "SMSH", 4) != 0 || header.version != kMeshFileVersion || header.tag != tag ||
+        header.positionFormat != static_cast<std::uint32_t>(layout.position) ||
+        header.normalFormat != static_cast<std::uint32_t>(layout.normal) ||
+        header.vertexStride != vertexStride(layout) || header.levelCount == 0)
+        return false;
+
+    std::uint64_t tableEnd = sizeof(MeshFileHeader) + static_cast<std::uint64_t>(header.levelCount) * sizeof(MeshFileLevel);
+    if (tableEnd > file.Size())
+        return false;
+
+    // Validar toda la tabla antes de crear ningún objeto GL
+    std::vector<MeshFileLevel> table(header.levelCount);
+    std::memcpy(table.data(), file.Data() + sizeof(MeshFileHeader), table.size() * sizeof(MeshFileLevel));
+    for (const MeshFileLevel& level : table)
+    {
+        if (level.indexType != GL_UNSIGNED_SHORT && level.indexType != GL_UNSIGNED_INT)
+            return false;
+        // Cuentas de 32 bits por tamaños pequeños: los productos no desbordan
+        std::uint64_t vertexBytes = static_cast<std::uint64_t>(level.vertexCount) * header.vertexStride;
+        std::uint64_t indexBytes = level.indexCount * indexSize(level.indexType);
+        if (level.vertexOffset < tableEnd || level.indexOffset < tableEnd ||
+            !fitsInFile(level.vertexOffset, vertexBytes, file.Size()) ||
+            !fitsInFile(level.indexOffset, indexBytes, file.Size()))
+            return false;
+    }
+
+    // Los punteros proyectados van directos a glBufferData
+    chain = LodChain{};
+    for (const MeshFileLevel& level : table)
+    {
+        glm::vec3 scale, offset;
+        std::memcpy(&scale[0], level.positionScale, sizeof(level.positionScale));
+        std::memcpy(&offset[0], level.positionOffset, sizeof(level.positionOffset));
+        ShapeBounds bounds;
+        std::memcpy(&bounds.boxMin[0], level.boxMin, sizeof(level.boxMin));
+        std::memcpy(&bounds.boxMax[0], level.boxMax, sizeof(level.boxMax));
+        std::memcpy(&bounds.sphereCenter[0], level.sphereCenter, sizeof(level.sphereCenter));
+        bounds.sphereRadius = level.sphereRadius;
+        chain.levels.push_back(createShapeFromEncoded(file.Data() + level.vertexOffset,
+            static_cast<GLsizei>(level.vertexCount), file.Data() + level.indexOffset,
+            static_cast<GLsizei>(level.indexCount), level.indexType, layout, scale, offset, bounds));
+        chain.maxScreenRadius.push_back(level.maxScreenRadius);
+    }
+    chain.boundingRadius = header.boundingRadius;
+    chain.currentLevel = 0;
+    return true;
+}
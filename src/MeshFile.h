@@ -0,0 +1,60 @@
+//src/MeshFile.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Lod.h"
+#include "Mesh.h"
+
+// ---------------------------------------------------
+// Formato binario de mallas (.mesh), pensado para cargarse con mmap:
+//   cabecera | tabla de niveles (LOD) | bloques de vértices e índices
+// Los bloques ya están en el formato del VBO/EBO (VertexLayout, índices
+// de 16 o 32 bits) y alineados a 64 bytes, así que se pasan tal cual a
+// glBufferData: sin parseo ni trabajo por vértice. Little-endian.
+// ---------------------------------------------------
+struct MeshFileHeader {
+    char magic[4];               // "SMSH"
+    std::uint32_t version;
+    std::uint64_t tag;           // hash de la descripción del generador
+    std::uint32_t positionFormat;
+    std::uint32_t normalFormat;
+    std::uint32_t vertexStride;
+    std::uint32_t levelCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundingRadius;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader layout changed");
+
+struct MeshFileLevel {
+    std::uint64_t vertexOffset;  // bytes desde el inicio del fichero
+    std::uint64_t indexOffset;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::uint32_t indexType;     // GL_UNSIGNED_SHORT o GL_UNSIGNED_INT
+    float maxScreenRadius;
+    float positionScale[3];
+    float positionOffset[3];
+    float boxMin[3];             // volúmenes del nivel (ShapeBounds)
+    float boxMax[3];
+    float sphereCenter[3];
+    float sphereRadius;
+};
+static_assert(sizeof(MeshFileLevel) == 96, "MeshFileLevel layout changed");
+
+// Directorio de la cache de mallas generadas ("" = desactivada)
+void setMeshCacheDirectory(const std::string& directory);
+const std::string& meshCacheDirectory();
+
+// FNV-1a de la descripción: si cambian los parámetros del generador, el
+// fichero deja de ser válido
+std::uint64_t meshFileTag(const std::string& description);
+
+// Se escribe en un temporal y se renombra
+bool saveMeshFile(const std::string& path, std::uint64_t tag, const VertexLayout& layout,
+    const std::vector<MeshData>& levels, const std::vector<float>& maxScreenRadius, float boundingRadius);
+
+// false si no existe, está corrupto o no coincide el tag o el layout
+bool loadMeshFile(const std::string& path, std::uint64_t tag, const VertexLayout& layout, LodChain& chain);
@@ -0,0 +1,295 @@
+// src/MeshOptimizer.cpp
+#include <algorithm>
+#include <numeric>
+#include <glm/glm.hpp>
+#include "MeshOptimizer.h"
+
+namespace {
+    // Relación ACMR local / global por debajo de la cual se corta un cluster
+    const float kOverdrawClusterThreshold = 1.05f;
+
+    // Triángulos de cada vértice en formato CSR (offsets + lista)
+    struct Adjacency {
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> triangles;
+    };
+
+    Adjacency buildAdjacency(const MeshData& mesh)
+    {
+        std::size_t vertexCount = mesh.VertexCount();
+        std::size_t triangleCount = mesh.indices.size() / 3;
+
+        Adjacency adjacency;
+        adjacency.offsets.assign(vertexCount + 1, 0);
+        for (unsigned int index : mesh.indices)
+            ++adjacency.offsets[index + 1];
+        std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+        adjacency.triangles.resize(mesh.indices.size());
+        std::vector<unsigned int> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (std::size_t t = 0; t < triangleCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                adjacency.triangles[cursor[mesh.indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+        return adjacency;
+    }
+
+    // Tipsify: abanica alrededor de un vértice en cache y salta al
+    // siguiente vértice que seguirá en cache. Devuelve el nuevo orden de
+    // triángulos y, en clusterStarts, dónde hubo que saltar sin vecinos.
+    std::vector<unsigned int> tipsify(const MeshData& mesh, int cacheSize, std::vector<std::size_t>& clusterStarts)
+    {
+        int vertexCount = static_cast<int>(mesh.VertexCount());
+        std::size_t triangleCount = mesh.indices.size() / 3;
+        Adjacency adjacency = buildAdjacency(mesh);
+
+        std::vector<int> liveTriangles(vertexCount);
+        for (int v = 0; v < vertexCount; ++v)
+            liveTriangles[v] = static_cast<int>(adjacency.offsets[v + 1] - adjacency.offsets[v]);
+
+        std::vector<int> cacheTime(vertexCount, 0);
+        std::vector<char> emitted(triangleCount, 0);
+        std::vector<unsigned int> deadEnd;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> order;
+        order.reserve(triangleCount);
+        deadEnd.reserve(mesh.indices.size());
+
+        int time = cacheSize + 1;
+        int cursor = 0;
+        int fanning = vertexCount > 0 ? 0 : -1;
+        clusterStarts.assign(1, 0);
+
+        while (fanning >= 0)
+        {
+            candidates.clear();
+            for (unsigned int a = adjacency.offsets[fanning]; a < adjacency.offsets[fanning + 1]; ++a)
+            {
+                unsigned int t = adjacency.triangles[a];
+                if (emitted[t])
+                    continue;
+                for (int k = 0; k < 3; ++k)
+                {
+                    unsigned int v = mesh.indices[t * 3 + k];
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --liveTriangles[v];
+                    if (time - cacheTime[v] > cacheSize)
+                        cacheTime[v] = time++;
+                }
+                emitted[t] = 1;
+                order.push_back(t);
+            }
+
+            // Candidato que seguirá en cache tras abanicarlo y más antiguo
+            int next = -1, best = -1;
+            for (unsigned int v : candidates)
+            {
+                if (liveTriangles[v] <= 0)
+                    continue;
+                int priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                    priority = time - cacheTime[v];
+                if (priority > best)
+                {
+                    best = priority;
+                    next = static_cast<int>(v);
+                }
+            }
+
+            if (next == -1)
+            {
+                // Callejón sin salida: último vértice usado con triángulos
+                // pendientes o, si no queda ninguno, el siguiente en orden
+                while (!deadEnd.empty() && next == -1)
+                {
+                    unsigned int v = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (liveTriangles[v] > 0)
+                        next = static_cast<int>(v);
+                }
+                if (next == -1)
+                {
+                    while (cursor < vertexCount && liveTriangles[cursor] <= 0)
+                        ++cursor;
+                    if (cursor < vertexCount)
+                        next = cursor;
+                }
+                if (next != -1 && order.size() > clusterStarts.back())
+                    clusterStarts.push_back(order.size());
+            }
+            fanning = next;
+        }
+        return order;
+    }
+
+    // Fallos de una cache FIFO al recorrer los triángulos en ese orden
+    std::size_t countCacheMisses(const std::vector<unsigned int>& indices, std::size_t first, std::size_t last,
+        int cacheSize, std::vector<int>& stamp, int& clock)
+    {
+        std::size_t misses = 0;
+        for (std::size_t i = first * 3; i < last * 3; ++i)
+        {
+            unsigned int v = indices[i];
+            if (clock - stamp[v] >= cacheSize || stamp[v] < 0)
+            {
+                stamp[v] = clock++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    // Corta los clusters duros de Tipsify donde la cache ya se ha
+    // amortizado (ACMR local cerca del global): más clusters = más
+    // libertad para ordenar, sin perder mucha localidad
+    std::vector<std::size_t> splitClusters(const MeshData& mesh, const std::vector<std::size_t>& hardStarts,
+        int cacheSize, float acmr)
+    {
+        std::size_t triangleCount = mesh.indices.size() / 3;
+        std::vector<int> stamp(mesh.VertexCount(), -1);
+        int clock = 0;
+
+        std::vector<std::size_t> starts;
+        for (std::size_t c = 0; c < hardStarts.size(); ++c)
+        {
+            std::size_t end = c + 1 < hardStarts.size() ? hardStarts[c + 1] : triangleCount;
+            std::size_t start = hardStarts[c];
+            starts.push_back(start);
+
+            std::size_t misses = 0;
+            clock += cacheSize; // vacía la cache al empezar el cluster
+            for (std::size_t t = start; t < end; ++t)
+            {
+                misses += countCacheMisses(mesh.indices, t, t + 1, cacheSize, stamp, clock);
+                std::size_t triangles = t + 1 - start;
+                if (t + 1 < end && triangles >= 8 &&
+                    static_cast<float>(misses) / triangles <= acmr * kOverdrawClusterThreshold)
+                {
+                    starts.push_back(t + 1);
+                    start = t + 1;
+                    misses = 0;
+                    clock += cacheSize;
+                }
+            }
+        }
+        return starts;
+    }
+}
+
+VertexCacheStats analyzeVertexCache(const MeshData& mesh, int cacheSize)
+{
+    VertexCacheStats stats{ 0.0f, 0.0f };
+    std::size_t triangleCount = mesh.indices.size() / 3;
+    if (triangleCount == 0 || mesh.VertexCount() == 0)
+        return stats;
+
+    std::vector<int> stamp(mesh.VertexCount(), -1);
+    int clock = 0;
+    std::size_t misses = countCacheMisses(mesh.indices, 0, triangleCount, cacheSize, stamp, clock);
+
+    stats.acmr = static_cast<float>(misses) / triangleCount;
+    stats.atvr = static_cast<float>(misses) / mesh.VertexCount();
+    return stats;
+}
+
+void optimizeVertexCache(MeshData& mesh, bool reduceOverdraw, int cacheSize)
+{
+    std::size_t triangleCount = mesh.indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    std::vector<std::size_t> clusterStarts;
+    std::vector<unsigned int> order = tipsify(mesh, cacheSize, clusterStarts);
+
+    std::vector<unsigned int> indices(mesh.indices.size());
+    for (std::size_t t = 0; t < triangleCount; ++t)
+        std::copy_n(&mesh.indices[order[t] * 3], 3, &indices[t * 3]);
+    mesh.indices.swap(indices);
+
+    if (!reduceOverdraw)
+        return;
+
+    // Cada cluster se ordena por lo que mira hacia fuera respecto al
+    // centro de la malla: los más externos se dibujan antes y tapan al
+    // resto (Sander et al., "Fast Triangle Reordering ... Overdraw")
+    float acmr = analyzeVertexCache(mesh, cacheSize).acmr;
+    std::vector<std::size_t> starts = splitClusters(mesh, clusterStarts, cacheSize, acmr);
+
+    auto position = [&](unsigned int v) {
+        return glm::vec3(mesh.vertices[v * 6], mesh.vertices[v * 6 + 1], mesh.vertices[v * 6 + 2]);
+        };
+
+    glm::vec3 meshCenter(0.0f);
+    for (std::size_t v = 0; v < mesh.VertexCount(); ++v)
+        meshCenter += position(static_cast<unsigned int>(v));
+    meshCenter /= static_cast<float>(mesh.VertexCount());
+
+    std::vector<float> score(starts.size());
+    for (std::size_t c = 0; c < starts.size(); ++c)
+    {
+        std::size_t end = c + 1 < starts.size() ? starts[c + 1] : triangleCount;
+        glm::vec3 center(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (std::size_t t = starts[c]; t < end; ++t)
+        {
+            glm::vec3 a = position(mesh.indices[t * 3]);
+            glm::vec3 b = position(mesh.indices[t * 3 + 1]);
+            glm::vec3 d = position(mesh.indices[t * 3 + 2]);
+            glm::vec3 n = glm::cross(b - a, d - a); // |n| = 2 * área
+            float weight = glm::length(n);
+            center += (a + b + d) * (weight / 3.0f);
+            normal += n;
+            area += weight;
+        }
+        if (area > 0.0f)
+            center /= area;
+        float length = glm::length(normal);
+        score[c] = length > 0.0f ? glm::dot(center - meshCenter, normal / length) : 0.0f;
+    }
+
+    std::vector<std::size_t> clusterOrder(starts.size());
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+        [&](std::size_t a, std::size_t b) { return score[a] > score[b]; });
+
+    indices.resize(mesh.indices.size());
+    std::size_t out = 0;
+    for (std::size_t c : clusterOrder)
+    {
+        std::size_t end = c + 1 < starts.size() ? starts[c + 1] : triangleCount;
+        std::copy(&mesh.indices[starts[c] * 3], &mesh.indices[0] + end * 3, &indices[out]);
+        out += (end - starts[c]) * 3;
+    }
+    mesh.indices.swap(indices);
+}
+
+void optimizeVertexFetch(MeshData& mesh)
+{
+    // Renumera por orden de primer uso en la lista de índices
+    const unsigned int unused = ~0u;
+    std::vector<unsigned int> remap(mesh.VertexCount(), unused);
+    std::vector<float> vertices(mesh.vertices.size());
+
+    unsigned int next = 0;
+    for (unsigned int& index : mesh.indices)
+    {
+        if (remap[index] == unused)
+        {
+            std::copy_n(&mesh.vertices[index * 6], 6, &vertices[next * 6]);
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    // Los vértices que ningún triángulo usa se descartan
+    vertices.resize(next * 6);
+    mesh.vertices.swap(vertices);
+}
+
+void optimizeMesh(MeshData& mesh)
+{
+    optimizeVertexCache(mesh, true);
+    optimizeVertexFetch(mesh);
+}
@@ -0,0 +1,28 @@
+//src/MeshOptimizer.h
+#pragma once
+#include "Mesh.h"
+
+// ---------------------------------------------------
+// Optimización de mallas indexadas antes de subirlas a GPU:
+//  1. Orden de triángulos para la cache post-transformación (Tipsify,
+//     Sander et al. 2007), tiempo lineal.
+//  2. Opcional: reordenación de los clusters de Tipsify para reducir el
+//     overdraw (primero los que miran hacia fuera de la malla).
+//  3. Orden de vértices por primer uso, para leer el VBO secuencialmente.
+// ---------------------------------------------------
+
+// ACMR: vértices transformados por triángulo (0.5 ideal en rejillas)
+// ATVR: vértices transformados por vértice único (1.0 ideal)
+struct VertexCacheStats {
+    float acmr;
+    float atvr;
+};
+
+// Simula una cache FIFO de cacheSize entradas
+VertexCacheStats analyzeVertexCache(const MeshData& mesh, int cacheSize = 16);
+
+void optimizeVertexCache(MeshData& mesh, bool reduceOverdraw, int cacheSize = 16);
+void optimizeVertexFetch(MeshData& mesh);
+
+// Las tres pasadas en orden (con reducción de overdraw)
+void optimizeMesh(MeshData& mesh);
@@ -0,0 +1,499 @@
+// src/ObjLoader.cpp
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MappedFile.h"
+#include "ObjLoader.h"
+
+namespace {
+    // Bloques de tamaño fijo (no uno por hilo): así el orden de los
+    // vértices resultantes es el mismo con cualquier número de hilos
+    const std::size_t kChunkBytes = 1 << 20;
+    // Los pares (posición, normal) se reparten por hash en cubetas que se
+    // deduplican en paralelo, cada una con su propia tabla
+    const int kBucketCount = 256;
+    const std::uint32_t kNoNormal = 0xFFFFFFFFu;
+    const std::uint64_t kEmptyKey = ~0ull;
+
+    struct Corner {
+        std::uint32_t position;
+        std::uint32_t normal;  // kNoNormal si la cara no la indica
+    };
+
+    // De dónde cuenta un índice hasta que se conocen las bases de los bloques
+    enum IndexOrigin {
+        IndexAbsolute,    // 0..n-1 en todo el fichero
+        IndexInChunk,     // negativo dentro del bloque: 0..n-1 del bloque
+        IndexBeforeChunk  // negativo que sale del bloque: distancia antes de su inicio
+    };
+
+    struct PolygonCorner {
+        Corner corner;
+        IndexOrigin positionOrigin;
+        IndexOrigin normalOrigin;
+    };
+
+    // Resultado de parsear un bloque. Los índices negativos de OBJ cuentan
+    // desde el final de la lista: se guardan relativos al bloque y se
+    // corrigen cuando se conoce cuántos vértices hay en los anteriores.
+    struct ObjChunk {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<Corner> corners;  // 3 por triángulo
+        std::vector<std::size_t> relativePositions; // esquinas con IndexInChunk
+        std::vector<std::size_t> relativeNormals;
+        std::vector<std::size_t> earlierPositions;  // esquinas con IndexBeforeChunk
+        std::vector<std::size_t> earlierNormals;
+        std::size_t skippedLines = 0;
+        bool missingNormals = false;
+    };
+
+    bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    const char* skipBlanks(const char* p, const char* end)
+    {
+        while (p < end && isBlank(*p))
+            ++p;
+        return p;
+    }
+
+    bool parseFloat(const char*& p, const char* end, float& value)
+    {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+')
+            ++p; // from_chars no acepta el signo +
+        std::from_chars_result result = std::from_chars(p, end, value);
+        if (result.ec == std::errc::result_out_of_range)
+            value = 0.0f; // subnormales: no cambian la malla
+        else if (result.ec != std::errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    bool parseFloats(const char* p, const char* end, std::vector<float>& out)
+    {
+        float xyz[3];
+        for (float& value : xyz)
+        {
+            if (!parseFloat(p, end, value))
+                return false;
+        }
+        out.insert(out.end(), xyz, xyz + 3);
+        return true;
+    }
+
+    // Índice OBJ (1..n, o -1 = último) → 0..n-1. Los negativos quedan
+    // relativos a localCount; los que van más atrás apuntan a un bloque
+    // anterior y se guardan como distancia antes del inicio del bloque,
+    // sin desbordar el uint32 (que podría acabar en kNoNormal). Al unir
+    // los bloques se comprueba que no salgan del principio del fichero.
+    bool parseIndex(const char*& p, const char* end, std::size_t localCount,
+        std::uint32_t& index, IndexOrigin& origin)
+    {
+        if (p < end && *p == '+')
+            ++p;
+        long long value = 0;
+        std::from_chars_result result = std::from_chars(p, end, value);
+        const long long limit = static_cast<long long>(kNoNormal);
+        if (result.ec != std::errc() || value == 0 || value >= limit || value <= -limit)
+            return false;
+        p = result.ptr;
+        const long long local = static_cast<long long>(localCount);
+        if (value > 0)
+        {
+            origin = IndexAbsolute;
+            index = static_cast<std::uint32_t>(value - 1);
+        }
+        else if (value >= -local)
+        {
+            origin = IndexInChunk;
+            index = static_cast<std::uint32_t>(local + value);
+        }
+        else
+        {
+            origin = IndexBeforeChunk;
+            index = static_cast<std::uint32_t>(-(local + value));
+        }
+        return true;
+    }
+
+    // v, v/t, v//n o v/t/n
+    bool parseCorner(const char*& p, const char* end, const ObjChunk& chunk, PolygonCorner& out)
+    {
+        out.corner.normal = kNoNormal;
+        out.normalOrigin = IndexAbsolute;
+        if (!parseIndex(p, end, chunk.positions.size() / 3, out.corner.position, out.positionOrigin))
+            return false;
+        if (p < end && *p == '/')
+        {
+            ++p;
+            if (p < end && *p != '/')
+            {
+                std::uint32_t texCoord;
+                IndexOrigin origin;
+                if (!parseIndex(p, end, 0, texCoord, origin))
+                    return false;
+            }
+            if (p < end && *p == '/')
+            {
+                ++p;
+                if (!parseIndex(p, end, chunk.normals.size() / 3, out.corner.normal, out.normalOrigin))
+                    return false;
+            }
+        }
+        return p == end || isBlank(*p);
+    }
+
+    bool parseFace(const char* p, const char* end, ObjChunk& chunk, std::vector<PolygonCorner>& polygon)
+    {
+        polygon.clear();
+        for (p = skipBlanks(p, end); p < end; p = skipBlanks(p, end))
+        {
+            PolygonCorner corner;
+            if (!parseCorner(p, end, chunk, corner))
+                return false;
+            polygon.push_back(corner);
+        }
+        if (polygon.size() < 3)
+            return false;
+
+        // Abanico desde la primera esquina
+        for (std::size_t i = 1; i + 1 < polygon.size(); ++i)
+        {
+            for (std::size_t k : { std::size_t(0), i, i + 1 })
+            {
+                if (polygon[k].positionOrigin == IndexInChunk)
+                    chunk.relativePositions.push_back(chunk.corners.size());
+                else if (polygon[k].positionOrigin == IndexBeforeChunk)
+                    chunk.earlierPositions.push_back(chunk.corners.size());
+                if (polygon[k].normalOrigin == IndexInChunk)
+                    chunk.relativeNormals.push_back(chunk.corners.size());
+                else if (polygon[k].normalOrigin == IndexBeforeChunk)
+                    chunk.earlierNormals.push_back(chunk.corners.size());
+                chunk.missingNormals = chunk.missingNormals || polygon[k].corner.normal == kNoNormal;
+                chunk.corners.push_back(polygon[k].corner);
+            }
+        }
+        return true;
+    }
+
+    void parseChunk(const char* p, const char* end, ObjChunk& chunk)
+    {
+        std::vector<PolygonCorner> polygon;
+        while (p < end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!lineEnd)
+                lineEnd = end;
+            const char* next = lineEnd < end ? lineEnd + 1 : end;
+            if (lineEnd > p && lineEnd[-1] == '\r')
+                --lineEnd;
+
+            p = skipBlanks(p, lineEnd);
+            std::ptrdiff_t length = lineEnd - p;
+            bool ok = true;
+            if (length >= 2 && p[0] == 'v' && isBlank(p[1]))
+                ok = parseFloats(p + 2, lineEnd, chunk.positions);
+            else if (length >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2]))
+                ok = parseFloats(p + 3, lineEnd, chunk.normals);
+            else if (length >= 2 && p[0] == 'f' && isBlank(p[1]))
+                ok = parseFace(p + 2, lineEnd, chunk, polygon);
+            // vt, o, g, s, usemtl, comentarios...: no cambian la malla
+
+            if (!ok)
+                ++chunk.skippedLines;
+            p = next;
+        }
+    }
+
+    std::uint64_t mixKey(std::uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+        key *= 0xC4CEB9FE1A85EC53ull;
+        key ^= key >> 33;
+        return key;
+    }
+
+    int bucketOf(std::uint64_t key)
+    {
+        return static_cast<int>(mixKey(key) >> 56);
+    }
+
+    // Normales suaves (media ponderada por área) para las caras sin vn
+    std::vector<glm::vec3> smoothNormals(const std::vector<ObjChunk>& chunks, const std::vector<float>& positions)
+    {
+        std::vector<glm::vec3> normals(positions.size() / 3, glm::vec3(0.0f));
+        auto position = [&](std::size_t index) {
+            return glm::vec3(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+            };
+        for (const ObjChunk& chunk : chunks)
+        {
+            for (std::size_t i = 0; i + 2 < chunk.corners.size(); i += 3)
+            {
+                const Corner* c = &chunk.corners[i];
+                glm::vec3 p0 = position(c[0].position);
+                glm::vec3 faceNormal = glm::cross(position(c[1].position) - p0, position(c[2].position) - p0);
+                for (int k = 0; k < 3; ++k)
+                    normals[c[k].position] += faceNormal;
+            }
+        }
+        for (glm::vec3& n : normals)
+        {
+            float length = glm::length(n);
+            n = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        return normals;
+    }
+}
+
+bool loadObj(const std::string& path, MeshData& mesh, ThreadPool& pool, ObjLoadStats* stats)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        fprintf(stderr, "Could not open OBJ file %s\n", path.c_str());
+        return false;
+    }
+    const char* text = reinterpret_cast<const char*>(file.Data());
+    const std::size_t size = file.Size();
+
+    // 1. Cortar en bloques que empiezan siempre al principio de una línea
+    const int chunkCount = static_cast<int>((size + kChunkBytes - 1) / kChunkBytes);
+    std::vector<std::size_t> starts(chunkCount + 1, size);
+    starts[0] = 0;
+    for (int c = 1; c < chunkCount; ++c)
+    {
+        std::size_t from = std::max(c * kChunkBytes, starts[c - 1]);
+        const void* newline = from < size ? std::memchr(text + from, '\n', size - from) : nullptr;
+        starts[c] = newline ? static_cast<const char*>(newline) - text + 1 : size;
+    }
+
+    // 2. Parsear los bloques en paralelo
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool.ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c)
+            parseChunk(text + starts[c], text + starts[c + 1], chunks[c]);
+        });
+
+    // 3. Posición de cada bloque en las listas globales
+    std::vector<std::size_t> positionBase(chunkCount + 1, 0);
+    std::vector<std::size_t> normalBase(chunkCount + 1, 0);
+    std::vector<std::size_t> cornerBase(chunkCount + 1, 0);
+    std::size_t skippedLines = 0;
+    bool missingNormals = false;
+    for (int c = 0; c < chunkCount; ++c)
+    {
+        positionBase[c + 1] = positionBase[c] + chunks[c].positions.size() / 3;
+        normalBase[c + 1] = normalBase[c] + chunks[c].normals.size() / 3;
+        cornerBase[c + 1] = cornerBase[c] + chunks[c].corners.size();
+        skippedLines += chunks[c].skippedLines;
+        missingNormals = missingNormals || chunks[c].missingNormals;
+    }
+    const std::size_t positionCount = positionBase[chunkCount];
+    const std::size_t normalCount = normalBase[chunkCount];
+    const std::size_t cornerCount = cornerBase[chunkCount];
+
+    if (cornerCount == 0)
+    {
+        fprintf(stderr, "OBJ file %s has no faces\n", path.c_str());
+        return false;
+    }
+    if (positionCount >= kNoNormal || normalCount >= kNoNormal || cornerCount >= kNoNormal)
+    {
+        fprintf(stderr, "OBJ file %s is too large (more than 2^32 vertices or corners)\n", path.c_str());
+        return false;
+    }
+
+    // 4. Unir posiciones y normales, resolver los índices relativos y
+    //    comprobar que todas las caras apuntan a vértices existentes
+    std::vector<float> positions(positionCount * 3);
+    std::vector<float> normals(normalCount * 3);
+    std::vector<char> invalid(chunkCount, 0);
+    pool.ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c)
+        {
+            ObjChunk& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + positionBase[c] * 3);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + normalBase[c] * 3);
+            std::vector<float>().swap(chunk.positions);
+            std::vector<float>().swap(chunk.normals);
+
+            for (std::size_t i : chunk.relativePositions)
+                chunk.corners[i].position += static_cast<std::uint32_t>(positionBase[c]);
+            for (std::size_t i : chunk.relativeNormals)
+                chunk.corners[i].normal += static_cast<std::uint32_t>(normalBase[c]);
+            // Índices negativos que salen del bloque: si también salen del
+            // principio del fichero la cara no es válida
+            for (std::size_t i : chunk.earlierPositions)
+            {
+                std::uint32_t& position = chunk.corners[i].position;
+                invalid[c] |= position > positionBase[c];
+                position = static_cast<std::uint32_t>(positionBase[c] - position);
+            }
+            for (std::size_t i : chunk.earlierNormals)
+            {
+                std::uint32_t& normal = chunk.corners[i].normal;
+                invalid[c] |= normal > normalBase[c];
+                normal = static_cast<std::uint32_t>(normalBase[c] - normal);
+            }
+
+            for (const Corner& corner : chunk.corners)
+            {
+                if (corner.position >= positionCount || (corner.normal != kNoNormal && corner.normal >= normalCount))
+                {
+                    invalid[c] = 1;
+                    break;
+                }
+            }
+        }
+        });
+    if (std::find(invalid.begin(), invalid.end(), 1) != invalid.end())
+    {
+        fprintf(stderr, "OBJ file %s has faces that reference missing vertices\n", path.c_str());
+        return false;
+    }
+
+    std::vector<glm::vec3> generatedNormals;
+    if (missingNormals)
+        generatedNormals = smoothNormals(chunks, positions);
+
+    // 5. Repartir las esquinas por cubetas según el hash del par
+    //    (posición, normal), conservando el orden del fichero
+    auto keyOf = [](const Corner& corner) {
+        return (static_cast<std::uint64_t>(corner.position) << 32) | corner.normal;
+        };
+    std::vector<std::size_t> bucketOffsets(static_cast<std::size_t>(chunkCount) * kBucketCount, 0);
+    pool.ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c)
+        {
+            std::size_t* counts = &bucketOffsets[static_cast<std::size_t>(c) * kBucketCount];
+            for (const Corner& corner : chunks[c].corners)
+                ++counts[bucketOf(keyOf(corner))];
+        }
+        });
+
+    std::vector<std::size_t> bucketStart(kBucketCount + 1, 0);
+    std::size_t running = 0;
+    for (int b = 0; b < kBucketCount; ++b)
+    {
+        bucketStart[b] = running;
+        for (int c = 0; c < chunkCount; ++c)
+        {
+            std::size_t& slot = bucketOffsets[static_cast<std::size_t>(c) * kBucketCount + b];
+            std::size_t count = slot;
+            slot = running;
+            running += count;
+        }
+    }
+    bucketStart[kBucketCount] = running;
+
+    std::vector<std::uint64_t> keys(cornerCount);
+    std::vector<std::uint32_t> owners(cornerCount); // índice global de la esquina
+    pool.ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c)
+        {
+            std::size_t* offsets = &bucketOffsets[static_cast<std::size_t>(c) * kBucketCount];
+            const std::vector<Corner>& corners = chunks[c].corners;
+            for (std::size_t i = 0; i < corners.size(); ++i)
+            {
+                std::uint64_t key = keyOf(corners[i]);
+                std::size_t slot = offsets[bucketOf(key)]++;
+                keys[slot] = key;
+                owners[slot] = static_cast<std::uint32_t>(cornerBase[c] + i);
+            }
+        }
+        });
+    chunks.clear();
+    chunks.shrink_to_fit();
+
+    // 6. Deduplicar cada cubeta: primero índices locales a la cubeta,
+    //    después se les suma el primer vértice de la cubeta
+    mesh.indices.assign(cornerCount, 0);
+    std::vector<std::vector<std::uint64_t>> uniqueKeys(kBucketCount);
+    pool.ParallelFor(kBucketCount, 1, [&](int begin, int end) {
+        std::vector<std::uint64_t> tableKeys;
+        std::vector<std::uint32_t> tableIds;
+        for (int b = begin; b < end; ++b)
+        {
+            std::size_t count = bucketStart[b + 1] - bucketStart[b];
+            std::size_t capacity = 16;
+            while (capacity < count * 2)
+                capacity *= 2;
+            tableKeys.assign(capacity, kEmptyKey);
+            tableIds.resize(capacity);
+
+            std::vector<std::uint64_t>& bucketKeys = uniqueKeys[b];
+            for (std::size_t e = bucketStart[b]; e < bucketStart[b + 1]; ++e)
+            {
+                std::uint64_t key = keys[e];
+                std::size_t slot = static_cast<std::size_t>(mixKey(key)) & (capacity - 1);
+                while (tableKeys[slot] != kEmptyKey && tableKeys[slot] != key)
+                    slot = (slot + 1) & (capacity - 1);
+                if (tableKeys[slot] == kEmptyKey)
+                {
+                    tableKeys[slot] = key;
+                    tableIds[slot] = static_cast<std::uint32_t>(bucketKeys.size());
+                    bucketKeys.push_back(key);
+                }
+                mesh.indices[owners[e]] = tableIds[slot];
+            }
+        }
+        });
+
+    std::vector<std::size_t> vertexBase(kBucketCount + 1, 0);
+    for (int b = 0; b < kBucketCount; ++b)
+        vertexBase[b + 1] = vertexBase[b] + uniqueKeys[b].size();
+    const std::size_t vertexCount = vertexBase[kBucketCount];
+
+    // 7. Escribir los vértices [pos, normal] y los índices definitivos
+    mesh.vertices.resize(vertexCount * 6);
+    pool.ParallelFor(kBucketCount, 1, [&](int begin, int end) {
+        for (int b = begin; b < end; ++b)
+        {
+            unsigned int base = static_cast<unsigned int>(vertexBase[b]);
+            for (std::size_t e = bucketStart[b]; e < bucketStart[b + 1]; ++e)
+                mesh.indices[owners[e]] += base;
+
+            for (std::size_t j = 0; j < uniqueKeys[b].size(); ++j)
+            {
+                std::size_t position = static_cast<std::size_t>(uniqueKeys[b][j] >> 32);
+                std::uint32_t normal = static_cast<std::uint32_t>(uniqueKeys[b][j]);
+                float* out = &mesh.vertices[(base + j) * 6];
+                std::copy(&positions[position * 3], &positions[position * 3] + 3, out);
+
+                glm::vec3 n = normal == kNoNormal ? generatedNormals[position]
+                    : glm::vec3(normals[normal * 3ull], normals[normal * 3ull + 1], normals[normal * 3ull + 2]);
+                // Los exportadores no siempre normalizan las vn
+                float lengthSquared = glm::dot(n, n);
+                if (std::fabs(lengthSquared - 1.0f) > 1e-4f)
+                    n = lengthSquared > 0.0f ? n / std::sqrt(lengthSquared) : glm::vec3(0.0f, 1.0f, 0.0f);
+                out[3] = n.x;
+                out[4] = n.y;
+                out[5] = n.z;
+            }
+        }
+        });
+
+    if (stats)
+    {
+        stats->bytes = size;
+        stats->positions = positionCount;
+        stats->normals = normalCount;
+        stats->triangles = cornerCount / 3;
+        stats->vertices = vertexCount;
+        stats->skippedLines = skippedLines;
+        stats->generatedNormals = missingNormals;
+    }
+    return true;
+}
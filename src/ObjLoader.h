@@ -0,0 +1,30 @@
+//src/ObjLoader.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+// ---------------------------------------------------
+// Cargador de Wavefront OBJ (v, vn y f; el resto se ignora).
+// El fichero se proyecta con mmap y se corta en bloques de ~1 MB en
+// fronteras de línea que los hilos parsean por separado (std::from_chars).
+// Después se unen los bloques y cada par (posición, normal) distinto se
+// convierte en un vértice de la malla indexada. Los polígonos se
+// triangulan en abanico; si faltan normales se calculan suaves.
+// El resultado no depende del número de hilos.
+// ---------------------------------------------------
+struct ObjLoadStats {
+    std::size_t bytes;
+    std::size_t positions;     // líneas v
+    std::size_t normals;       // líneas vn
+    std::size_t triangles;
+    std::size_t vertices;      // pares (posición, normal) distintos
+    std::size_t skippedLines;  // v, vn o f mal formadas
+    bool generatedNormals;
+};
+
+// false (tras mostrar el error) si no se puede leer, no tiene caras o
+// alguna cara usa un vértice que no existe
+bool loadObj(const std::string& path, MeshData& mesh, ThreadPool& pool = ThreadPool::Shared(),
+    ObjLoadStats* stats = nullptr);
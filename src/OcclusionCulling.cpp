@@ -0,0 +1,148 @@
+// src/OcclusionCulling.cpp
+#include <cstdio>
+#include "OcclusionCulling.h"
+#include "GLStateCache.h"
+
+namespace {
+    // Cajas un 1 % más grandes: una caja justo sobre la superficie del
+    // propio objeto no debe perder la prueba de profundidad por precisión
+    constexpr float kBoxScale = 1.01f;
+    // Los visibles se vuelven a probar uno de cada tantos frames
+    constexpr std::uint32_t kVisibleTestInterval = 4;
+}
+
+OcclusionCuller::OcclusionCuller(std::size_t objectCount)
+    : occluded(objectCount, 0), pending(objectCount, 0), queries(objectCount, 0)
+{
+    shader = std::make_unique<Shader>(loadTextFile("src/shaders/occlusion_box_vertex_shader.glsl"),
+        loadTextFile("src/shaders/occlusion_box_fragment_shader.glsl"));
+    if (shader->GetId() == 0)
+    {
+        fprintf(stderr, "Error: could not create the occlusion box program\n");
+        return;
+    }
+    uViewProjection = shader->GetUniform("viewProjection");
+    uBoxCenter = shader->GetUniform("boxCenter");
+    uBoxExtent = shader->GetUniform("boxExtent");
+
+    // Cubo unidad: 8 esquinas y 12 triángulos (no hay culling de caras)
+    const float corners[] = {
+        -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,   1.0f,  1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+        -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f,   1.0f,  1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,
+    };
+    const GLubyte indices[] = {
+        0, 1, 2, 2, 3, 0,   4, 5, 6, 6, 7, 4,   0, 1, 5, 5, 4, 0,
+        3, 2, 6, 6, 7, 3,   0, 3, 7, 7, 4, 0,   1, 2, 6, 6, 5, 1,
+    };
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    cachedBindVertexArray(VAO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    cachedBindVertexArray(0);
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    for (GLuint query : queries)
+    {
+        if (query != 0)
+            glDeleteQueries(1, &query);
+    }
+    cachedDeleteVertexArrays(1, &VAO);
+    cachedDeleteBuffers(1, &VBO);
+    cachedDeleteBuffers(1, &EBO);
+}
+
+void OcclusionCuller::BeginFrame()
+{
+    stats = OcclusionStats{};
+    ++frame;
+
+    // Solo se leen las respuestas que ya están: leer una sin terminar
+    // bloquearía la CPU hasta que la GPU llegue a ella
+    std::size_t kept = 0;
+    for (std::uint32_t object : pendingList)
+    {
+        GLuint available = 0;
+        glGetQueryObjectuiv(queries[object], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            pendingList[kept++] = object;
+            continue;
+        }
+
+        GLuint anySamples = 0;
+        glGetQueryObjectuiv(queries[object], GL_QUERY_RESULT, &anySamples);
+        if (occluded[object] && anySamples)
+            ++stats.falseNegatives;
+        occluded[object] = anySamples ? 0 : 1;
+        pending[object] = 0;
+    }
+    pendingList.resize(kept);
+    stats.pending = kept;
+}
+
+void OcclusionCuller::Test(const std::uint32_t* objects, std::size_t count, const CullBounds& bounds,
+    const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float nearMargin)
+{
+    if (!IsValid())
+        return;
+
+    shader->Bind();
+    shader->SetMat4(uViewProjection, viewProjection);
+    cachedBindVertexArray(VAO);
+    cachedDepthMask(false);
+    cachedColorMask(false);
+
+    for (std::size_t v = 0; v < count; ++v)
+    {
+        std::uint32_t object = objects[v];
+        if (occluded[object])
+            ++stats.culled;
+        // Con una consulta en vuelo se sigue usando la respuesta anterior
+        if (pending[object])
+            continue;
+        if (!occluded[object] && (object + frame) % kVisibleTestInterval != 0)
+            continue;
+
+        glm::vec3 center(bounds.centerX[object], bounds.centerY[object], bounds.centerZ[object]);
+        glm::vec3 extent(bounds.extentX[object], bounds.extentY[object], bounds.extentZ[object]);
+        extent *= kBoxScale;
+
+        // Cámara dentro de la caja (o casi): la caja quedaría recortada
+        // por el plano cercano y la prueba no vale
+        glm::vec3 offset = glm::abs(cameraPosition - center);
+        if (offset.x <= extent.x + nearMargin && offset.y <= extent.y + nearMargin &&
+            offset.z <= extent.z + nearMargin)
+        {
+            occluded[object] = 0;
+            continue;
+        }
+
+        if (queries[object] == 0)
+            glGenQueries(1, &queries[object]);
+        shader->SetVec3(uBoxCenter, center);
+        shader->SetVec3(uBoxExtent, extent);
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[object]);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, (void*)0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+
+        pending[object] = 1;
+        pendingList.push_back(object);
+        ++stats.tested;
+    }
+
+    cachedColorMask(true);
+    cachedDepthMask(true);
+}
+
+GLuint OcclusionCuller::GetConditionQuery(std::uint32_t object) const
+{
+    return occluded[object] ? queries[object] : 0;
+}
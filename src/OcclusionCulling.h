@@ -0,0 +1,72 @@
+//src/OcclusionCulling.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Culling.h"
+#include "Shader.h"
+
+// Contadores de un frame
+struct OcclusionStats {
+    unsigned long long tested;         // cajas dibujadas con consulta
+    unsigned long long culled;         // objetos tapados según la última respuesta
+    unsigned long long falseNegatives; // tapados cuya nueva consulta dice que se ven
+    unsigned long long pending;        // consultas sin respuesta al empezar el frame
+};
+
+// ---------------------------------------------------
+// Oclusión por hardware sin que la CPU espere a la GPU. Tras dibujar
+// los visibles se dibuja la caja de cada objeto a probar (sin escribir
+// color ni profundidad) dentro de una consulta GL_ANY_SAMPLES_PASSED.
+// Las respuestas solo se leen cuando GL_QUERY_RESULT_AVAILABLE dice que
+// están: mientras tanto vale la del frame anterior. Los objetos tapados
+// se dibujan con glBeginConditionalRender(GL_QUERY_NO_WAIT), así que si
+// su caja vuelve a verse salen ya en ese frame (o se dibujan si la GPU
+// aún no ha respondido): nunca desaparece un objeto visible.
+// Los tapados se prueban cada frame; los visibles, uno de cada cuatro
+// frames, repartidos para que el coste sea uniforme.
+// ---------------------------------------------------
+class OcclusionCuller {
+public:
+    explicit OcclusionCuller(std::size_t objectCount);
+    ~OcclusionCuller();
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    bool IsValid() const { return shader && shader->GetId() != 0; }
+
+    // Recoge las respuestas disponibles y pone a cero los contadores
+    void BeginFrame();
+    bool IsOccluded(std::uint32_t object) const { return occluded[object] != 0; }
+
+    // Prueba los objetos de la lista (visibles por el frustum) contra la
+    // profundidad ya dibujada. viewProjection y cameraPosition están en
+    // el espacio de bounds; con la cámara a menos de nearMargin de una
+    // caja el objeto se da por visible (la caja cortaría el plano cercano).
+    void Test(const std::uint32_t* objects, std::size_t count, const CullBounds& bounds,
+        const glm::mat4& viewProjection, const glm::vec3& cameraPosition, float nearMargin);
+
+    // Consulta para glBeginConditionalRender, 0 si el objeto no está tapado
+    GLuint GetConditionQuery(std::uint32_t object) const;
+
+    const OcclusionStats& GetStats() const { return stats; }
+
+private:
+    std::unique_ptr<Shader> shader;
+    int uViewProjection = -1;
+    int uBoxCenter = -1;
+    int uBoxExtent = -1;
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+
+    std::vector<std::uint8_t> occluded;
+    std::vector<std::uint8_t> pending;
+    std::vector<GLuint> queries;           // 0 = aún no creada
+    std::vector<std::uint32_t> pendingList; // objetos con consulta en vuelo
+    std::uint32_t frame = 0;
+    OcclusionStats stats{};
+};
@@ -0,0 +1,179 @@
+// src/Options.cpp
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include "Options.h"
+
+namespace {
+    bool parseInt(const char* text, int minValue, int& value)
+    {
+        char* end = nullptr;
+        long parsed = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || parsed < minValue)
+            return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Uso: opengltriangle [opciones]\n"
+                     "  --bench <nombre>     ejecuta un benchmark y termina\n"
+                     "  --no-shader-cache    compila siempre los shaders desde el código fuente\n"
+                     "  --no-mesh-cache      genera siempre las mallas (sin mesh_cache/)\n"
+                     "  --no-hot-reload      no recompila los shaders al guardarlos\n"
+                     "  --headless           sin ventana visible: renderiza a un framebuffer\n"
+                     "  --no-vsync           sin sincronización vertical (FPS sin límite)\n"
+                     "  --size <w>x<h>       resolución de render (por defecto 800x600)\n"
+                     "  --frames <n>         termina tras n frames\n"
+                     "  --output <f.ppm>     guarda el último frame (requiere --headless)\n"
+                     "  --shape <0-4>        forma inicial: cubo, esfera, pirámide, toro, modelo OBJ\n"
+                     "  --obj <f.obj>        carga un modelo OBJ como quinta forma (tecla 5)\n"
+                     "  --scene <n>          escena de n objetos dibujada con instancias\n"
+                     "  --occlusion          descarta en la GPU los objetos tapados de la escena\n"
+                     "  --lights <n>         añade n luces puntuales (clustered forward shading)\n"
+                     "  --deferred           empieza con deferred shading (G cambia a forward)\n"
+                     "  --profile <f>        mide CPU/GPU por fase y guarda p50/p95/p99 (.csv o .json)\n"
+                     "  --positions <fmt>    formato de las posiciones: float, half, snorm16 (por defecto)\n"
+                     "  --normals <fmt>      formato de las normales: float, oct (por defecto), packed\n";
+    }
+}
+
+bool parseArguments(int argc, char* argv[], AppOptions& options)
+{
+    bool shapeGiven = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--bench" && hasValue)
+        {
+            options.benchmark = argv[++i];
+        }
+        else if (arg == "--no-shader-cache")
+        {
+            options.useShaderCache = false;
+        }
+        else if (arg == "--no-mesh-cache")
+        {
+            options.useMeshCache = false;
+        }
+        else if (arg == "--no-hot-reload")
+        {
+            options.hotReload = false;
+        }
+        else if (arg == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (arg == "--no-vsync")
+        {
+            options.vsync = false;
+        }
+        else if (arg == "--size" && hasValue)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0)
+            {
+                std::cerr << "Resolución no válida: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            if (!parseInt(argv[++i], 1, options.frames))
+            {
+                std::cerr << "Número de frames no válido: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.outputImage = argv[++i];
+        }
+        else if (arg == "--shape" && hasValue)
+        {
+            if (!parseInt(argv[++i], 0, options.shapeIndex) || options.shapeIndex > 4)
+            {
+                std::cerr << "Forma no válida: " << argv[i] << "\n";
+                return false;
+            }
+            shapeGiven = true;
+        }
+        else if (arg == "--obj" && hasValue)
+        {
+            options.objFile = argv[++i];
+        }
+        else if (arg == "--scene" && hasValue)
+        {
+            if (!parseInt(argv[++i], 1, options.sceneObjects))
+            {
+                std::cerr << "Número de objetos no válido: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--occlusion")
+        {
+            options.occlusionCulling = true;
+        }
+        else if (arg == "--lights" && hasValue)
+        {
+            if (!parseInt(argv[++i], 0, options.pointLights) || options.pointLights > 65536)
+            {
+                std::cerr << "Número de luces no válido (máximo 65536): " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--deferred")
+        {
+            options.deferred = true;
+        }
+        else if (arg == "--profile" && hasValue)
+        {
+            options.profileOutput = argv[++i];
+        }
+        else if (arg == "--positions" && hasValue)
+        {
+            if (!parsePositionFormat(argv[++i], options.vertexLayout.position))
+            {
+                std::cerr << "Formato de posiciones no válido: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else if (arg == "--normals" && hasValue)
+        {
+            if (!parseNormalFormat(argv[++i], options.vertexLayout.normal))
+            {
+                std::cerr << "Formato de normales no válido: " << argv[i] << "\n";
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Argumento desconocido: " << arg << "\n";
+            printUsage();
+            return false;
+        }
+    }
+
+    if (!options.outputImage.empty() && !options.headless)
+    {
+        std::cerr << "--output requiere --headless\n";
+        return false;
+    }
+    if (options.objFile.empty() && options.shapeIndex == 4)
+    {
+        std::cerr << "--shape 4 requiere --obj\n";
+        return false;
+    }
+    if (options.occlusionCulling && options.sceneObjects == 0)
+    {
+        std::cerr << "--occlusion requiere --scene\n";
+        return false;
+    }
+    // Con un modelo cargado se empieza mostrándolo
+    if (!options.objFile.empty() && !shapeGiven)
+        options.shapeIndex = 4;
+    return true;
+}
@@ -0,0 +1,31 @@
+//src/Options.h
+#pragma once
+#include <string>
+#include "VertexFormat.h"
+
+// ---------------------------------------------------
+// Opciones de línea de comandos del visor
+// ---------------------------------------------------
+struct AppOptions {
+    std::string benchmark;      // --bench <nombre>
+    bool useShaderCache = true; // --no-shader-cache
+    bool useMeshCache = true;   // --no-mesh-cache
+    bool hotReload = true;      // --no-hot-reload: no vigilar src/shaders/
+    bool headless = false;      // --headless: sin ventana visible, render a FBO
+    bool vsync = true;          // --no-vsync: sin límite de FPS
+    int width = 800;            // --size <ancho>x<alto>
+    int height = 600;
+    int frames = 0;             // --frames <n>: 0 = hasta cerrar la ventana
+    std::string outputImage;    // --output <fichero.ppm> (último frame, modo headless)
+    int shapeIndex = 0;         // --shape <0-4>
+    std::string objFile;        // --obj <fichero.obj>: modelo como forma 4
+    int sceneObjects = 0;       // --scene <n>: n objetos dibujados con instancias
+    bool occlusionCulling = false; // --occlusion: consultas de oclusión en la escena
+    int pointLights = 0;        // --lights <n>: luces puntuales con clustered shading
+    bool deferred = false;      // --deferred: empieza con deferred shading (tecla G)
+    std::string profileOutput;  // --profile <fichero.csv|json>: tiempos por fase
+    VertexLayout vertexLayout = { PositionSnorm16, NormalOctahedral }; // --positions, --normals
+};
+
+// Devuelve false (tras mostrar el error) si algún argumento no es válido
+bool parseArguments(int argc, char* argv[], AppOptions& options);
@@ -0,0 +1,89 @@
+// src/Picking.cpp
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "Picking.h"
+
+float rayTriangleDistance(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& v0,
+    const glm::vec3& v1, const glm::vec3& v2, float tMax)
+{
+    const float kEpsilon = 1e-12f;
+    glm::vec3 edge1 = v1 - v0;
+    glm::vec3 edge2 = v2 - v0;
+    glm::vec3 p = glm::cross(direction, edge2);
+    float determinant = glm::dot(edge1, p);
+    if (std::fabs(determinant) < kEpsilon)
+        return tMax; // rayo paralelo al triángulo
+
+    float inverseDeterminant = 1.0f / determinant;
+    glm::vec3 s = origin - v0;
+    float u = glm::dot(s, p) * inverseDeterminant;
+    if (u < 0.0f || u > 1.0f)
+        return tMax;
+    glm::vec3 q = glm::cross(s, edge1);
+    float v = glm::dot(direction, q) * inverseDeterminant;
+    if (v < 0.0f || u + v > 1.0f)
+        return tMax;
+
+    float t = glm::dot(edge2, q) * inverseDeterminant;
+    return t > 0.0f && t < tMax ? t : tMax;
+}
+
+void rayToObjectSpace(const glm::mat4& model, glm::vec3& origin, glm::vec3& direction)
+{
+    glm::mat4 inverse = glm::inverse(model);
+    origin = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+    direction = glm::mat3(inverse) * direction;
+}
+
+PickMesh::PickMesh(MeshData mesh)
+    : indices(std::move(mesh.indices))
+{
+    positions.reserve(mesh.VertexCount());
+    for (std::size_t i = 0; i < mesh.VertexCount(); ++i)
+        positions.emplace_back(mesh.vertices[i * 6], mesh.vertices[i * 6 + 1], mesh.vertices[i * 6 + 2]);
+
+    std::vector<BvhBox> boxes(GetTriangleCount());
+    for (std::size_t t = 0; t < boxes.size(); ++t)
+    {
+        const glm::vec3& a = positions[indices[t * 3]];
+        const glm::vec3& b = positions[indices[t * 3 + 1]];
+        const glm::vec3& c = positions[indices[t * 3 + 2]];
+        boxes[t] = BvhBox{ glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)) };
+    }
+    bvh.Build(boxes);
+}
+
+float PickMesh::Intersect(const glm::vec3& origin, const glm::vec3& direction, float tMax) const
+{
+    return bvh.Intersect(origin, direction, tMax, [&](std::uint32_t triangle, float limit) {
+        return rayTriangleDistance(origin, direction, positions[indices[triangle * 3]],
+            positions[indices[triangle * 3 + 1]], positions[indices[triangle * 3 + 2]], limit);
+        });
+}
+
+float PickMesh::IntersectAll(const glm::vec3& origin, const glm::vec3& direction, float tMax) const
+{
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+        tMax = rayTriangleDistance(origin, direction, positions[indices[i]], positions[indices[i + 1]],
+            positions[indices[i + 2]], tMax);
+    return tMax;
+}
+
+PickHit pickObject(const Bvh& bvh, const std::vector<SceneObject>& objects, const std::vector<PickMesh>& meshes,
+    const glm::vec3& origin, const glm::vec3& direction)
+{
+    const float kNoHit = std::numeric_limits<float>::infinity();
+    PickHit hit{ -1, kNoHit };
+    bvh.Intersect(origin, direction, kNoHit, [&](std::uint32_t index, float tMax) {
+        const SceneObject& object = objects[index];
+        glm::vec3 localOrigin = origin;
+        glm::vec3 localDirection = direction;
+        rayToObjectSpace(object.model, localOrigin, localDirection);
+        float distance = meshes[object.shapeType].Intersect(localOrigin, localDirection, tMax);
+        if (distance < tMax)
+            hit = PickHit{ static_cast<int>(index), distance };
+        return distance;
+        });
+    return hit;
+}
@@ -0,0 +1,49 @@
+//src/Picking.h
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Bvh.h"
+#include "Mesh.h"
+#include "Scene.h"
+
+// Distancia del impacto con el triángulo (Möller-Trumbore, por las dos
+// caras) o tMax si no lo corta antes
+float rayTriangleDistance(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& v0,
+    const glm::vec3& v1, const glm::vec3& v2, float tMax);
+
+// Lleva el rayo al espacio del objeto con la inversa de su matriz. La
+// dirección no se normaliza: las distancias t siguen siendo comparables.
+void rayToObjectSpace(const glm::mat4& model, glm::vec3& origin, glm::vec3& direction);
+
+// ---------------------------------------------------
+// Malla en CPU para picking: posiciones y triángulos con su propio BVH
+// (el mismo de la escena, con un triángulo por objeto)
+// ---------------------------------------------------
+class PickMesh {
+public:
+    // Se queda con los índices de mesh (std::move si ya no hace falta)
+    explicit PickMesh(MeshData mesh);
+
+    // Triángulo más cercano: con el BVH o probando todos (referencia)
+    float Intersect(const glm::vec3& origin, const glm::vec3& direction, float tMax) const;
+    float IntersectAll(const glm::vec3& origin, const glm::vec3& direction, float tMax) const;
+
+    std::size_t GetTriangleCount() const { return indices.size() / 3; }
+
+private:
+    std::vector<glm::vec3> positions;
+    std::vector<unsigned int> indices;
+    Bvh bvh;
+};
+
+struct PickHit {
+    int object;     // -1: el rayo no toca ningún objeto
+    float distance; // en unidades de la dirección del rayo
+};
+
+// Objeto más cercano que corta el rayo (en el espacio de la escena). El
+// BVH de la escena da los candidatos y cada uno se prueba contra la malla
+// de su forma (meshes[shapeType]).
+PickHit pickObject(const Bvh& bvh, const std::vector<SceneObject>& objects, const std::vector<PickMesh>& meshes,
+    const glm::vec3& origin, const glm::vec3& direction);
@@ -0,0 +1,311 @@
+// src/RenderQueue.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "GLStateCache.h"
+#include "RenderQueue.h"
+
+namespace {
+    const int kProgramBits = 8;
+    const int kMeshBits = 12;
+    const int kMaterialBits = 8;
+    const int kDepthBits = 32;
+    // Pasada, programa y VAO: lo que obliga a empezar un lote nuevo
+    const int kStateShift = kMaterialBits + kDepthBits;
+    const int kPassShift = kProgramBits + kMeshBits + kStateShift;
+    const std::uint64_t kNoProgram = (1u << kProgramBits) - 1;
+    const std::uint64_t kNoMesh = (1u << kMeshBits) - 1;
+    const std::uint64_t kProgramAndMesh = (1u << (kProgramBits + kMeshBits)) - 1;
+
+    int passOf(std::uint64_t state) { return static_cast<int>(state >> (kProgramBits + kMeshBits)); }
+    int programOf(std::uint64_t state) { return static_cast<int>((state >> kMeshBits) & kNoProgram); }
+    int meshOf(std::uint64_t state) { return static_cast<int>(state & kNoMesh); }
+
+    // Pasada, programa y VAO de una clave (pasada | programa | malla)
+    std::uint64_t stateOf(std::uint64_t key)
+    {
+        const std::uint64_t pass = key >> kPassShift;
+        if (pass == PassTransparent)
+            return (pass << (kProgramBits + kMeshBits)) | ((key >> kMaterialBits) & kProgramAndMesh);
+        return key >> kStateShift;
+    }
+
+    // Cambios de pasada, programa y VAO para pasar del estado a al b
+    unsigned stateChanges(std::uint64_t a, std::uint64_t b)
+    {
+        return (passOf(a) != passOf(b)) + (programOf(a) != programOf(b)) + (meshOf(a) != meshOf(b));
+    }
+
+    // Estado antes del primer draw: pasada opaca (estado por defecto de
+    // GL), ningún programa ni VAO
+    const std::uint64_t kInitialState = (kNoProgram << kMeshBits) | kNoMesh;
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+}
+
+std::uint64_t makeSortKey(RenderPass pass, int program, int mesh, int material, float depth)
+{
+    // Un float positivo ordena igual que sus bits como entero sin signo
+    std::uint32_t depthBits = 0;
+    float clamped = std::max(depth, 0.0f);
+    std::memcpy(&depthBits, &clamped, sizeof(depthBits));
+    const std::uint64_t state = (static_cast<std::uint64_t>(program & kNoProgram) << (kMeshBits + kMaterialBits))
+        | (static_cast<std::uint64_t>(mesh & kNoMesh) << kMaterialBits)
+        | static_cast<std::uint64_t>(material & ((1 << kMaterialBits) - 1));
+
+    // Transparentes: de atrás hacia delante aunque cambie el estado
+    if (pass == PassTransparent)
+        return (static_cast<std::uint64_t>(pass) << kPassShift)
+            | (static_cast<std::uint64_t>(~depthBits) << (kPassShift - kDepthBits)) | state;
+    return (static_cast<std::uint64_t>(pass) << kPassShift) | (state << kDepthBits) | depthBits;
+}
+
+void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+{
+    const std::size_t count = entries.size();
+    if (count < 2)
+        return;
+    scratch.resize(count);
+
+    // Los ocho histogramas en una sola lectura de las claves
+    std::uint32_t histograms[8][256] = {};
+    for (const SortEntry& entry : entries)
+    {
+        for (int digit = 0; digit < 8; ++digit)
+            ++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+    }
+
+    SortEntry* source = entries.data();
+    SortEntry* destination = scratch.data();
+    for (int digit = 0; digit < 8; ++digit)
+    {
+        const int shift = digit * 8;
+        std::uint32_t* histogram = histograms[digit];
+        // Todas las claves tienen este byte igual: la pasada no cambia nada
+        if (histogram[(source[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        std::uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; ++bucket)
+        {
+            std::uint32_t size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += size;
+        }
+        for (std::size_t i = 0; i < count; ++i)
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data())
+        std::copy(source, source + count, entries.data());
+}
+
+RenderQueue::RenderQueue(std::size_t instancesPerRegion)
+    : stream(instancesPerRegion * sizeof(InstanceData)), instancesPerRegion(instancesPerRegion), stats()
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+    for (MeshBinding& mesh : meshes)
+        cachedDeleteVertexArrays(1, &mesh.VAO);
+}
+
+int RenderQueue::AddProgram(const Shader* shader)
+{
+    if (programs.size() >= kNoProgram)
+    {
+        fprintf(stderr, "Render queue: too many programs\n");
+        return -1;
+    }
+    programs.push_back(shader);
+    return static_cast<int>(programs.size()) - 1;
+}
+
+void RenderQueue::SetProgram(int program, const Shader* shader)
+{
+    programs[program] = shader;
+}
+
+int RenderQueue::AddMesh(const Shape& shape)
+{
+    if (meshes.size() >= kNoMesh)
+    {
+        fprintf(stderr, "Render queue: too many meshes\n");
+        return -1;
+    }
+
+    // Geometría de la forma + atributos por instancia en el buffer de
+    // streaming (el offset se ajusta en cada lote)
+    MeshBinding mesh{ shape, 0 };
+    glGenVertexArrays(1, &mesh.VAO);
+    cachedBindVertexArray(mesh.VAO);
+    bindShapeVertices(shape);
+    cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.EBO);
+    cachedBindBuffer(GL_ARRAY_BUFFER, stream.GetId());
+    setupInstanceAttributes(0);
+    cachedBindVertexArray(0);
+
+    meshes.push_back(mesh);
+    return static_cast<int>(meshes.size()) - 1;
+}
+
+void RenderQueue::Begin()
+{
+    items.clear();
+    instances.clear();
+    conditions.clear();
+}
+
+void RenderQueue::Submit(RenderPass pass, int program, int mesh, int material, float depth,
+    const InstanceData* instance, GLuint condition)
+{
+    // Un -1 de AddProgram/AddMesh enmascarado en la clave sería un índice
+    // válido en apariencia y Execute leería fuera de programs/meshes
+    if (program < 0 || static_cast<std::size_t>(program) >= programs.size() ||
+        mesh < 0 || static_cast<std::size_t>(mesh) >= meshes.size())
+    {
+        fprintf(stderr, "Render queue: draw with invalid program %d or mesh %d skipped\n", program, mesh);
+        return;
+    }
+
+    SortEntry entry;
+    entry.key = makeSortKey(pass, program, mesh, material, depth);
+    entry.index = static_cast<std::uint32_t>(instances.size());
+    items.push_back(entry);
+    instances.push_back(instance);
+    conditions.push_back(condition);
+}
+
+void RenderQueue::ApplyPass(RenderPass pass)
+{
+    if (pass == PassTransparent)
+    {
+        cachedEnable(GL_BLEND);
+        cachedBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        cachedDepthMask(false);
+    }
+    else
+    {
+        cachedDisable(GL_BLEND);
+        cachedDepthMask(true);
+    }
+}
+
+void RenderQueue::Prepare()
+{
+    stats = RenderQueueStats{};
+    stats.items = items.size();
+    batches.clear();
+
+    // Lo que costaría dibujarlos en el orden en que llegaron
+    std::uint64_t previous = kInitialState;
+    for (const SortEntry& entry : items)
+    {
+        std::uint64_t state = stateOf(entry.key);
+        stats.unsortedStateChanges += stateChanges(previous, state);
+        previous = state;
+    }
+
+    auto sortStart = std::chrono::steady_clock::now();
+    radixSort(items, scratch);
+    stats.sortMs = elapsedMs(sortStart);
+
+    // Lotes: entradas seguidas con el mismo estado que caben en una región
+    // (las que llevan condición van solas)
+    previous = kInitialState;
+    const std::size_t count = items.size();
+    for (std::size_t first = 0; first < count; )
+    {
+        const std::uint64_t state = stateOf(items[first].key);
+        const GLuint condition = conditions[items[first].index];
+        std::size_t last = first + 1;
+        while (condition == 0 && last < count && stateOf(items[last].key) == state &&
+            conditions[items[last].index] == 0 && last - first < instancesPerRegion)
+            ++last;
+
+        stats.stateChanges += stateChanges(previous, state);
+        stats.conditionalDraws += condition != 0;
+        previous = state;
+        batches.push_back(Batch{ state, first, last - first, condition });
+        first = last;
+    }
+    stats.drawCalls = batches.size();
+}
+
+void RenderQueue::Execute()
+{
+    Prepare();
+    if (batches.empty())
+        return;
+
+    auto submitStart = std::chrono::steady_clock::now();
+    std::uint64_t current = kInitialState;
+    const std::size_t batchCount = batches.size();
+    for (std::size_t first = 0; first < batchCount; )
+    {
+        // Región llena: se cierra con su fence y se sigue en la siguiente
+        if (stream.GetFreeBytes() < batches[first].count * sizeof(InstanceData))
+            stream.EndFrame();
+
+        // Todos los lotes seguidos que caben en la región con un solo Map
+        // (los sueltos de las entradas con condición son muchos y pequeños)
+        const std::size_t freeBytes = stream.GetFreeBytes();
+        std::size_t last = first;
+        std::size_t bytes = 0;
+        while (last < batchCount && bytes + batches[last].count * sizeof(InstanceData) <= freeBytes)
+            bytes += batches[last++].count * sizeof(InstanceData);
+
+        std::size_t offset = 0;
+        InstanceData* target = static_cast<InstanceData*>(stream.Map(bytes, offset));
+        if (!target)
+            break;
+        for (std::size_t b = first; b < last; ++b)
+        {
+            for (std::size_t i = 0; i < batches[b].count; ++i)
+                *target++ = *instances[items[batches[b].first + i].index];
+        }
+        stream.Unmap();
+
+        cachedBindBuffer(GL_ARRAY_BUFFER, stream.GetId());
+        for (std::size_t b = first; b < last; ++b)
+        {
+            const Batch& batch = batches[b];
+            if (batch.state != current)
+            {
+                if (passOf(batch.state) != passOf(current))
+                    ApplyPass(static_cast<RenderPass>(passOf(batch.state)));
+                programs[programOf(batch.state)]->Bind();
+                cachedBindVertexArray(meshes[meshOf(batch.state)].VAO);
+                current = batch.state;
+            }
+
+            const Shape& shape = meshes[meshOf(batch.state)].shape;
+            setupInstanceAttributes(offset);
+            if (batch.condition != 0)
+                glBeginConditionalRender(batch.condition, GL_QUERY_NO_WAIT);
+            glDrawElementsInstanced(GL_TRIANGLES, shape.indexCount, shape.indexType, (void*)0,
+                static_cast<GLsizei>(batch.count));
+            if (batch.condition != 0)
+                glEndConditionalRender();
+            offset += batch.count * sizeof(InstanceData);
+        }
+        first = last;
+    }
+
+    // El resto del código cuenta con el estado de la pasada opaca
+    if (passOf(current) != PassOpaque)
+        ApplyPass(PassOpaque);
+    stats.submitMs = elapsedMs(submitStart);
+}
+
+void RenderQueue::EndFrame()
+{
+    stream.EndFrame();
+}
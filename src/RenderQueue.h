@@ -0,0 +1,120 @@
+//src/RenderQueue.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "Mesh.h"
+#include "Scene.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+// Pasadas en el orden en que se dibujan
+enum RenderPass {
+    PassOpaque,      // de delante hacia atrás (menos sobredibujado)
+    PassTransparent  // de atrás hacia delante, con blending y sin escribir profundidad
+};
+
+// ---------------------------------------------------
+// Clave de ordenación de 64 bits, de más a menos significativo:
+//   opaca:        pass (4) | programa (8) | malla/VAO (12) | material (8) | profundidad (32)
+//   transparente: pass (4) | profundidad invertida (32) | programa | malla | material
+// Los draws opacos con el mismo estado GL (pasada, programa y VAO)
+// quedan seguidos. El material va por instancia (atributo aMaterial),
+// así que solo ordena dentro del lote sin romperlo. Los transparentes
+// tienen que mezclarse de atrás hacia delante: manda la profundidad y
+// solo se juntan en un lote los que quedan seguidos con el mismo estado.
+// ---------------------------------------------------
+std::uint64_t makeSortKey(RenderPass pass, int program, int mesh, int material, float depth);
+
+struct SortEntry {
+    std::uint64_t key;
+    std::uint32_t index;
+};
+
+// Radix sort LSD estable de 8 bits por pasada; se saltan las pasadas en
+// las que todas las claves tienen el mismo byte. scratch se reutiliza.
+void radixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+struct RenderQueueStats {
+    unsigned long long items;
+    unsigned long long drawCalls;
+    unsigned long long stateChanges;   // pasada + programa + VAO tras ordenar
+    unsigned long long unsortedStateChanges; // los mismos cambios en el orden de envío
+    unsigned long long conditionalDraws;     // draws dentro de glBeginConditionalRender
+    double sortMs;
+    double submitMs;                   // copia de instancias + draws (solo Execute)
+};
+
+// ---------------------------------------------------
+// Cola de draws por frame. Cada Submit guarda la clave y la instancia;
+// Execute ordena las claves con radix sort, junta las entradas seguidas
+// que comparten estado en una sola llamada instanciada y sube sus
+// instancias, ya ordenadas, a un StreamBuffer.
+// Sin GL 4.2 no hay baseInstance: antes de cada lote se reapuntan los
+// atributos por instancia del VAO a su tramo del buffer.
+// Una entrada con consulta de condición se dibuja sola, dentro de
+// glBeginConditionalRender(GL_QUERY_NO_WAIT) (oclusión por hardware).
+// ---------------------------------------------------
+class RenderQueue {
+public:
+    // Instancias que caben en cada región del buffer de streaming: un
+    // frame con más se reparte en varias regiones
+    explicit RenderQueue(std::size_t instancesPerRegion = 65536);
+    ~RenderQueue();
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Identificadores para la clave. El programa se puede sustituir
+    // (recarga en caliente) sin cambiar su identificador.
+    int AddProgram(const Shader* shader);
+    void SetProgram(int program, const Shader* shader);
+    int AddMesh(const Shape& shape);
+
+    void Begin();
+    // instance debe seguir siendo válida hasta Execute. Con condition != 0
+    // el draw depende del resultado de esa consulta de oclusión.
+    // Un programa o malla que no existe (p. ej. el -1 de un Add fallido)
+    // se descarta con un aviso.
+    void Submit(RenderPass pass, int program, int mesh, int material, float depth, const InstanceData* instance,
+        GLuint condition = 0);
+    // Ordena y forma los lotes sin llamar a GL (Execute empieza por aquí)
+    void Prepare();
+    // Prepare + una llamada instanciada por lote. Se puede llamar varias
+    // veces por frame: las instancias siguen en la misma región del buffer
+    void Execute();
+    // Fence de la región usada en el frame; una vez por frame, tras el
+    // último Execute
+    void EndFrame();
+
+    std::size_t GetItemCount() const { return items.size(); }
+    // Del último Prepare o Execute
+    const RenderQueueStats& GetStats() const { return stats; }
+
+private:
+    struct MeshBinding {
+        Shape shape;
+        GLuint VAO;
+    };
+
+    // Tramo de entradas ordenadas con el mismo estado
+    struct Batch {
+        std::uint64_t state;
+        std::size_t first;
+        std::size_t count;
+        GLuint condition;
+    };
+
+    void ApplyPass(RenderPass pass);
+
+    std::vector<const Shader*> programs;
+    std::vector<MeshBinding> meshes;
+    std::vector<SortEntry> items;
+    std::vector<SortEntry> scratch;
+    std::vector<const InstanceData*> instances;
+    std::vector<GLuint> conditions; // por entrada, en el orden de envío
+    std::vector<Batch> batches;
+    StreamBuffer stream;
+    std::size_t instancesPerRegion;
+    RenderQueueStats stats;
+};
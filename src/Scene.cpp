@@ -0,0 +1,155 @@
+// src/Scene.cpp
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+#include "GLStateCache.h"
+#include "Scene.h"
+#include "Transform.h"
+
+// ---------------------------------------------------
+// Generación de la escena
+// ---------------------------------------------------
+Scene generateScene(int count, int shapeTypes, const std::vector<glm::vec3>& palette,
+    int materialCount, unsigned int seed)
+{
+    Scene scene;
+    scene.objects.reserve(count);
+
+    // Rejilla cúbica de lado n con separación suficiente para que los
+    // objetos (radio <= ~1.3 con escala 1) no se solapen
+    const float spacing = 3.0f;
+    int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count))));
+    float half = 0.5f * spacing * (side - 1);
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+
+    for (int i = 0; i < count; ++i)
+    {
+        int x = i % side;
+        int y = (i / side) % side;
+        int z = i / (side * side);
+
+        glm::vec3 position(x * spacing - half, y * spacing - half, z * spacing - half);
+        glm::vec3 axis(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+        if (glm::dot(axis, axis) < 1e-4f)
+            axis = glm::vec3(0.0f, 1.0f, 0.0f);
+        float angle = unit(rng) * 6.2831853f;
+        float scale = 0.5f + 0.5f * unit(rng);
+
+        SceneObject object;
+        object.shapeType = static_cast<int>(rng() % shapeTypes);
+        object.model = glm::translate(glm::mat4(1.0f), position);
+        object.model = glm::rotate(object.model, angle, glm::normalize(axis));
+        object.model = glm::scale(object.model, glm::vec3(scale));
+        object.color = palette[rng() % palette.size()];
+        object.material = static_cast<int>(rng() % materialCount);
+        scene.objects.push_back(object);
+    }
+
+    // Medio lado del cubo más el radio de un objeto, en la diagonal
+    scene.radius = (half + spacing * 0.5f) * std::sqrt(3.0f);
+    return scene;
+}
+
+// ---------------------------------------------------
+// Atributos por instancia
+// ---------------------------------------------------
+void setupInstanceAttributes(std::size_t offset)
+{
+    const GLsizei stride = sizeof(InstanceData);
+    for (int column = 0; column < 4; ++column)
+    {
+        GLuint location = 2 + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+            (void*)(offset + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(InstanceData, color)));
+    glEnableVertexAttribArray(6);
+    glVertexAttribDivisor(6, 1);
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, stride, (void*)(offset + offsetof(InstanceData, material)));
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);
+    for (int column = 0; column < 3; ++column)
+    {
+        GLuint location = 8 + column;
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride,
+            (void*)(offset + offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec3)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+// ---------------------------------------------------
+// Escena instanciada
+// ---------------------------------------------------
+InstancedScene::InstancedScene(const std::vector<Shape>& shapes, const Scene& scene)
+{
+    // Agrupar las instancias por tipo de forma
+    std::vector<std::vector<InstanceData>> instances(shapes.size());
+    for (const SceneObject& object : scene.objects)
+    {
+        InstanceData data;
+        // La decodificación de las posiciones cuantizadas va en la propia
+        // matriz de la instancia; la de normales no cambia
+        data.model = object.model * positionDecodeMatrix(shapes[object.shapeType]);
+        data.color = object.color;
+        data.material = static_cast<float>(object.material);
+        data.normalMatrix = computeNormalMatrix(object.model);
+        instances[object.shapeType].push_back(data);
+    }
+
+    for (size_t type = 0; type < shapes.size(); ++type)
+    {
+        if (instances[type].empty())
+            continue;
+
+        Batch batch{};
+        batch.shape = shapes[type];
+        batch.instanceCount = static_cast<GLsizei>(instances[type].size());
+
+        glGenVertexArrays(1, &batch.VAO);
+        glGenBuffers(1, &batch.instanceVBO);
+        cachedBindVertexArray(batch.VAO);
+
+        // Geometría compartida con la forma original (mismo formato de vértice)
+        bindShapeVertices(batch.shape);
+        cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.shape.EBO);
+
+        // Datos por instancia
+        cachedBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instances[type].size() * sizeof(InstanceData),
+            instances[type].data(), GL_STATIC_DRAW);
+
+        setupInstanceAttributes(0);
+
+        cachedBindVertexArray(0);
+        cachedBindBuffer(GL_ARRAY_BUFFER, 0);
+        cachedBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        batches.push_back(batch);
+    }
+}
+
+InstancedScene::~InstancedScene()
+{
+    for (Batch& batch : batches)
+    {
+        cachedDeleteVertexArrays(1, &batch.VAO);
+        cachedDeleteBuffers(1, &batch.instanceVBO);
+    }
+}
+
+void InstancedScene::Draw() const
+{
+    for (const Batch& batch : batches)
+    {
+        cachedBindVertexArray(batch.VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, batch.shape.indexCount, batch.shape.indexType,
+            (void*)0, batch.instanceCount);
+    }
+}
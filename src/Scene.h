@@ -0,0 +1,64 @@
+//src/Scene.h
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Mesh.h"
+
+// ---------------------------------------------------
+// Escena con muchos objetos de los cuatro tipos de forma
+// ---------------------------------------------------
+struct SceneObject {
+    int shapeType;   // 0 = cubo, 1 = esfera, 2 = pirámide, 3 = toro, 4 = OBJ
+    glm::mat4 model;
+    glm::vec3 color;
+    int material;
+};
+
+struct Scene {
+    std::vector<SceneObject> objects;
+    float radius;    // radio de una esfera centrada en el origen que la contiene
+};
+
+// Datos por instancia tal y como se guardan en el VBO de instancias
+// (localizaciones fijadas en Shader.cpp)
+struct InstanceData {
+    glm::mat4 model; // atributos 2..5
+    glm::vec3 color; // atributo 6
+    float material;  // atributo 7
+    glm::mat3 normalMatrix; // atributos 8..10, calculada una vez por instancia
+};
+
+// Atributos 2..10 leídos de un array de InstanceData que empieza en
+// offset del GL_ARRAY_BUFFER enlazado, con divisor 1 (VAO enlazado)
+void setupInstanceAttributes(std::size_t offset);
+
+// Rejilla de objetos con tipo, rotación, escala, color y material
+// aleatorios (reproducible con la misma semilla)
+Scene generateScene(int count, int shapeTypes, const std::vector<glm::vec3>& palette,
+    int materialCount, unsigned int seed);
+
+// ---------------------------------------------------
+// Dibuja la escena con una llamada instanciada por tipo de forma.
+// Cada lote tiene su propio VAO: reutiliza el VBO/EBO de la forma y
+// añade el VBO de instancias con glVertexAttribDivisor(1).
+// ---------------------------------------------------
+class InstancedScene {
+public:
+    InstancedScene(const std::vector<Shape>& shapes, const Scene& scene);
+    ~InstancedScene();
+    InstancedScene(const InstancedScene&) = delete;
+    InstancedScene& operator=(const InstancedScene&) = delete;
+
+    void Draw() const;
+    int GetDrawCalls() const { return static_cast<int>(batches.size()); }
+
+private:
+    struct Batch {
+        GLuint VAO;
+        GLuint instanceVBO;
+        Shape shape;
+        GLsizei instanceCount;
+    };
+    std::vector<Batch> batches;
+};
@@ -1,18 +1,139 @@
 // src/Shader.cpp
 #include <string>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <vector>
 #include <glad/glad.h>
+#include <glm/gtc/type_ptr.hpp>
+#include "GLStateCache.h"
 #include "Shader.h"
 
-Shader::Shader(const std::string& vertexSource, const std::string& fragmentSource) {
-    unsigned int vertexShaderId = CreateShader(GL_VERTEX_SHADER, vertexSource);
-    unsigned int fragmentShaderId = CreateShader(GL_FRAGMENT_SHADER, fragmentSource);
+namespace {
+    // FNV-1a: suficiente para las pocas decenas de nombres de un programa
+    unsigned int HashName(const char* name, size_t length) {
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(name[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    // Atributos con localizacion fija (sustituyen a "layout" en el shader)
+    struct AttributeBinding {
+        unsigned int location;
+        const char* name;
+    };
+    const AttributeBinding kAttributeBindings[] = {
+        { 0, "aPos" },
+        { 1, "aNormal" },
+        // Por instancia (ver Scene.h): la mat4 ocupa las localizaciones 2..5
+        { 2, "aModel" },
+        { 6, "aColor" },
+        { 7, "aMaterial" },
+        { 8, "aNormalMatrix" }, // mat3: localizaciones 8..10
+        // Por luz en los volumenes del deferred shading (DeferredRenderer.h)
+        { 11, "aLightPosition" },
+        { 12, "aLightColor" },
+    };
+
+    // Bloques uniform compartidos y su punto de enlace
+    struct UniformBlockBindingName {
+        UniformBlockBinding binding;
+        const char* name;
+    };
+    const UniformBlockBindingName kUniformBlockBindings[] = {
+        { FrameDataBlock, "FrameData" },
+    };
 
-    if (vertexShaderId != 0 && fragmentShaderId != 0) {
-        id = CreateProgram(vertexShaderId, fragmentShaderId);
+    // Cabecera de cada fichero de la cache de binarios
+    struct ProgramBinaryHeader {
+        char magic[4];          // "SPBC"
+        std::uint32_t version;
+        std::uint32_t format;   // GLenum devuelto por glGetProgramBinary
+        std::uint32_t length;
+    };
+    const std::uint32_t kProgramBinaryVersion = 1;
+
+    std::string binaryCacheDirectory;
+
+    std::uint64_t HashBytes(std::uint64_t hash, const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
     }
-    else {
-        fprintf(stderr, "Could not create shader program\n");
-        id = 0;
+
+    std::uint64_t HashString(std::uint64_t hash, const char* text) {
+        // El terminador separa campos consecutivos ("ab"+"c" != "a"+"bc")
+        return HashBytes(hash, text, text ? std::strlen(text) + 1 : 0);
+    }
+
+    bool ProgramBinarySupported() {
+        if (glProgramBinary == nullptr || glGetProgramBinary == nullptr)
+            return false;
+        int formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }
+}
+
+std::string loadTextFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "Could not open file: %s\n", path.c_str());
+        return "";
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+std::string injectDefines(const std::string& source, const std::string& defines)
+{
+    if (defines.empty())
+        return source;
+    size_t lineEnd = source.find('\n');
+    if (lineEnd == std::string::npos)
+        return source + "\n" + defines;
+    return source.substr(0, lineEnd + 1) + defines + source.substr(lineEnd + 1);
+}
+
+void Shader::SetBinaryCacheDirectory(const std::string& directory) {
+    binaryCacheDirectory = directory;
+}
+
+Shader::Shader(const std::string& vertexSource, const std::string& fragmentSource)
+    : id(0), loadedFromCache(false) {
+    std::string cachePath = BinaryCachePath(vertexSource, fragmentSource);
+    if (!cachePath.empty()) {
+        id = LoadProgramBinary(cachePath);
+        loadedFromCache = id != 0;
+    }
+
+    if (id == 0) {
+        unsigned int vertexShaderId = CreateShader(GL_VERTEX_SHADER, vertexSource);
+        unsigned int fragmentShaderId = CreateShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+        if (vertexShaderId != 0 && fragmentShaderId != 0) {
+            id = CreateProgram(vertexShaderId, fragmentShaderId);
+            if (id != 0 && !cachePath.empty())
+                SaveProgramBinary(cachePath);
+        }
+        else {
+            fprintf(stderr, "Could not create shader program\n");
+        }
+    }
+
+    if (id != 0) {
+        ReflectUniforms();
+        BindUniformBlocks();
     }
 }
 
@@ -22,11 +143,144 @@ Shader::~Shader() {
 }
 
 void Shader::Bind() const {
-    glUseProgram(id);
+    cachedUseProgram(id);
 }
 
 void Shader::Unbind() const {
-    glUseProgram(0);
+    cachedUseProgram(0);
+}
+
+int Shader::GetUniform(const std::string& name) const {
+    if (uniformTable.empty())
+        return -1;
+
+    unsigned int mask = static_cast<unsigned int>(uniformTable.size()) - 1;
+    unsigned int slot = HashName(name.data(), name.size()) & mask;
+    while (uniformTable[slot] != -1) {
+        int index = uniformTable[slot];
+        if (uniforms[index].name == name)
+            return index;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+void Shader::SetMat4(int uniform, const glm::mat4& value) {
+    if (UpdateShadow(uniform, GL_FLOAT_MAT4, glm::value_ptr(value), 16))
+        glUniformMatrix4fv(uniforms[uniform].location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetMat3(int uniform, const glm::mat3& value) {
+    if (UpdateShadow(uniform, GL_FLOAT_MAT3, glm::value_ptr(value), 9))
+        glUniformMatrix3fv(uniforms[uniform].location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetVec3(int uniform, const glm::vec3& value) {
+    if (UpdateShadow(uniform, GL_FLOAT_VEC3, glm::value_ptr(value), 3))
+        glUniform3fv(uniforms[uniform].location, 1, glm::value_ptr(value));
+}
+
+void Shader::SetFloat(int uniform, float value) {
+    if (UpdateShadow(uniform, GL_FLOAT, &value, 1))
+        glUniform1f(uniforms[uniform].location, value);
+}
+
+void Shader::SetVec3(int uniform, const glm::vec3* values, int count) {
+    if (UpdateShadow(uniform, GL_FLOAT_VEC3, glm::value_ptr(values[0]), count * 3))
+        glUniform3fv(uniforms[uniform].location, count, glm::value_ptr(values[0]));
+}
+
+void Shader::SetFloat(int uniform, const float* values, int count) {
+    if (UpdateShadow(uniform, GL_FLOAT, values, count))
+        glUniform1fv(uniforms[uniform].location, count, values);
+}
+
+void Shader::SetSampler(int uniform, int unit) {
+    if (uniform < 0 || uniform >= static_cast<int>(uniforms.size()))
+        return;
+    // La sombra guarda la unidad como float, con el tipo del sampler
+    float value = static_cast<float>(unit);
+    if (UpdateShadow(uniform, uniforms[uniform].type, &value, 1))
+        glUniform1i(uniforms[uniform].location, unit);
+}
+
+// Devuelve true si hay que llamar a glUniform*; false si el valor ya estaba en GPU
+bool Shader::UpdateShadow(int uniform, unsigned int type, const float* value, int floatCount) {
+    if (uniform < 0 || uniform >= static_cast<int>(uniforms.size()))
+        return false;
+
+    UniformInfo& info = uniforms[uniform];
+    if (info.type != type) {
+        fprintf(stderr, "Uniform '%s' set with the wrong type\n", info.name.c_str());
+        return false;
+    }
+
+    size_t bytes = floatCount * sizeof(float);
+    if (info.shadow.size() == static_cast<size_t>(floatCount) && std::memcmp(info.shadow.data(), value, bytes) == 0) {
+        ++stats.skipped;
+        return false;
+    }
+
+    info.shadow.assign(value, value + floatCount);
+    ++stats.uploaded;
+    return true;
+}
+
+void Shader::ReflectUniforms() {
+    int count = 0;
+    int maxLength = 0;
+    glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<char> nameBuffer(maxLength > 0 ? maxLength : 1);
+    for (int i = 0; i < count; ++i) {
+        int length = 0;
+        int size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(id, i, maxLength, &length, &size, &type, nameBuffer.data());
+
+        // Los miembros de bloques uniform no tienen localizacion propia
+        int location = glGetUniformLocation(id, nameBuffer.data());
+        if (location < 0)
+            continue;
+
+        // "luces[0]" se registra como "luces"
+        std::string name(nameBuffer.data(), length);
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+
+        UniformInfo info{};
+        info.name = name;
+        info.location = location;
+        info.type = type;
+        info.size = size;
+        uniforms.push_back(info);
+    }
+
+    // Tabla con factor de carga <= 0.5 y capacidad potencia de dos
+    size_t capacity = 1;
+    while (capacity < uniforms.size() * 2)
+        capacity *= 2;
+    uniformTable.assign(capacity, -1);
+
+    unsigned int mask = static_cast<unsigned int>(capacity) - 1;
+    for (size_t i = 0; i < uniforms.size(); ++i) {
+        const std::string& name = uniforms[i].name;
+        unsigned int slot = HashName(name.data(), name.size()) & mask;
+        while (uniformTable[slot] != -1)
+            slot = (slot + 1) & mask;
+        uniformTable[slot] = static_cast<int>(i);
+    }
+}
+
+// El enlace bloque -> punto de enlace no forma parte del binario del
+// programa: se fija siempre, tanto al compilar como al cargar de la cache
+void Shader::BindUniformBlocks() {
+    for (const UniformBlockBindingName& block : kUniformBlockBindings) {
+        unsigned int index = glGetUniformBlockIndex(id, block.name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(id, index, block.binding);
+    }
 }
 
 unsigned int Shader::CreateShader(unsigned int shaderType, const std::string& shaderSource) {
@@ -75,8 +329,12 @@ unsigned int Shader::CreateProgram(unsigned int vertexShaderId, unsigned int fra
     //  aPos    -> location 0
     //  aNormal -> location 1
     // Esto sustituye al uso de "lay" en el shader.
-    glBindAttribLocation(programId, 0, "aPos");
-    glBindAttribLocation(programId, 1, "aNormal");
+    for (const AttributeBinding& binding : kAttributeBindings)
+        glBindAttribLocation(programId, binding.location, binding.name);
+
+    // Permite recuperar el binario enlazado para la cache en disco
+    if (!binaryCacheDirectory.empty() && glProgramParameteri != nullptr)
+        glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
     bool linked = LinkProgram(programId);
 
@@ -108,3 +366,93 @@ bool Shader::LinkProgram(unsigned int programId) {
 
     return linked;
 }
+
+// La clave cubre todo lo que invalida un binario: fuentes, atributos
+// enlazados y el driver (GL_RENDERER / GL_VERSION)
+std::string Shader::BinaryCachePath(const std::string& vertexSource, const std::string& fragmentSource) const {
+    if (binaryCacheDirectory.empty() || !ProgramBinarySupported())
+        return "";
+
+    std::uint64_t hash = 14695981039346656037ull;
+    hash = HashString(hash, vertexSource.c_str());
+    hash = HashString(hash, fragmentSource.c_str());
+    for (const AttributeBinding& binding : kAttributeBindings) {
+        hash = HashBytes(hash, &binding.location, sizeof(binding.location));
+        hash = HashString(hash, binding.name);
+    }
+    hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    hash = HashString(hash, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(binaryCacheDirectory) / name).string();
+}
+
+unsigned int Shader::LoadProgramBinary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    ProgramBinaryHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, "SPBC", 4) != 0 || header.version != kProgramBinaryVersion)
+        return 0;
+
+    // La longitud viene del disco: un fichero corrupto o cortado no debe
+    // reservar mas de lo que queda en el (se compila desde el codigo)
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error || fileSize < sizeof(header) || header.length > fileSize - sizeof(header))
+        return 0;
+
+    std::vector<char> binary(header.length);
+    file.read(binary.data(), binary.size());
+    if (!file)
+        return 0;
+
+    unsigned int programId = glCreateProgram();
+    glProgramBinary(programId, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // El driver puede rechazar el binario (actualizacion, otro formato...):
+    // en ese caso se vuelve a compilar desde el codigo fuente
+    int status = 0;
+    glGetProgramiv(programId, GL_LINK_STATUS, &status);
+    if (status == 0) {
+        glDeleteProgram(programId);
+        return 0;
+    }
+    return programId;
+}
+
+void Shader::SaveProgramBinary(const std::string& path) const {
+    int length = 0;
+    glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ProgramBinaryHeader header{};
+    std::memcpy(header.magic, "SPBC", 4);
+    header.version = kProgramBinaryVersion;
+    header.length = static_cast<std::uint32_t>(length);
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(id, length, nullptr, &format, binary.data());
+    header.format = format;
+
+    std::error_code error;
+    std::filesystem::create_directories(binaryCacheDirectory, error);
+
+    // Se escribe en un temporal y se renombra: nunca queda un binario a medias
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            fprintf(stderr, "Could not write program binary: %s\n", path.c_str());
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+    }
+    std::filesystem::rename(tempPath, path, error);
+}
@@ -2,20 +2,95 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Lee un fichero de texto completo (cadena vacia si no existe)
+std::string loadTextFile(const std::string& path);
+
+// Inserta las lineas #define justo despues de la directiva #version
+std::string injectDefines(const std::string& source, const std::string& defines);
+
+// Puntos de enlace fijos de los bloques uniform compartidos entre programas
+enum UniformBlockBinding : unsigned int {
+    FrameDataBlock = 0, // camara + luz (FrameUniformBuffer.h)
+};
+
+// Unidades de textura fijas de los samplers compartidos entre programas
+enum TextureUnitBinding : unsigned int {
+    ClusterLightsUnit = 0,  // luces puntuales (ClusteredLighting.h)
+    ClusterGridUnit = 1,    // primer indice y numero de luces por cluster
+    ClusterIndicesUnit = 2, // indices de luz de todos los clusters
+    GBufferAlbedoUnit = 3,  // G-buffer del deferred shading (DeferredRenderer.h)
+    GBufferNormalUnit = 4,
+    GBufferDepthUnit = 5,
+};
+
+// Contadores de subidas de uniforms (acumulados hasta ResetUniformStats)
+struct UniformStats {
+    unsigned long long uploaded = 0;
+    unsigned long long skipped = 0;
+};
 
 class Shader {
 private:
     unsigned int id;
+    bool loadedFromCache;
+
+    // Uniform activo descubierto con glGetActiveUniform al enlazar.
+    // "shadow" guarda el ultimo valor enviado para omitir subidas repetidas.
+    struct UniformInfo {
+        std::string name;
+        int location;
+        unsigned int type;
+        int size;
+        std::vector<float> shadow;
+    };
+    std::vector<UniformInfo> uniforms;
+    std::vector<int> uniformTable; // hash abierto (sondeo lineal) -> indice en uniforms
+    UniformStats stats;
 public:
     Shader(const std::string& vertexSource, const std::string& fragmentSource);
     ~Shader();
     void Bind() const;
     void Unbind() const;
     unsigned int GetId() const { return id; }
+    bool LoadedFromCache() const { return loadedFromCache; }
+
+    // Carpeta de la cache de binarios (glGetProgramBinary); vacia = desactivada
+    static void SetBinaryCacheDirectory(const std::string& directory);
+
+    // Devuelve un handle estable del uniform (o -1 si no esta activo).
+    // Resolverlo una vez fuera del bucle evita cualquier busqueda por frame.
+    int GetUniform(const std::string& name) const;
+
+    // Setters tipados: el programa debe estar enlazado con Bind().
+    // Si el valor coincide con el ultimo enviado no se llama a OpenGL.
+    void SetMat4(int uniform, const glm::mat4& value);
+    void SetMat3(int uniform, const glm::mat3& value);
+    void SetVec3(int uniform, const glm::vec3& value);
+    void SetFloat(int uniform, float value);
+    void SetVec3(int uniform, const glm::vec3* values, int count);
+    void SetFloat(int uniform, const float* values, int count);
+    // Unidad de textura de un sampler (de cualquier tipo)
+    void SetSampler(int uniform, int unit);
+    void SetMat4(const std::string& name, const glm::mat4& value) { SetMat4(GetUniform(name), value); }
+    void SetMat3(const std::string& name, const glm::mat3& value) { SetMat3(GetUniform(name), value); }
+    void SetVec3(const std::string& name, const glm::vec3& value) { SetVec3(GetUniform(name), value); }
+    void SetFloat(const std::string& name, float value) { SetFloat(GetUniform(name), value); }
+
+    const UniformStats& GetUniformStats() const { return stats; }
+    void ResetUniformStats() { stats = UniformStats(); }
 private:
     unsigned int CreateShader(unsigned int shaderType, const std::string& shaderSource);
     void SetShaderSource(unsigned int shaderId, const std::string& shaderSource);
     bool CompileShader(unsigned int shaderId);
     unsigned int CreateProgram(unsigned int vertexShaderId, unsigned int fragmentShaderId);
     bool LinkProgram(unsigned int id);
+    std::string BinaryCachePath(const std::string& vertexSource, const std::string& fragmentSource) const;
+    unsigned int LoadProgramBinary(const std::string& path);
+    void SaveProgramBinary(const std::string& path) const;
+    void ReflectUniforms();
+    void BindUniformBlocks();
+    bool UpdateShadow(int uniform, unsigned int type, const float* value, int floatCount);
 };
\ No newline at end of file
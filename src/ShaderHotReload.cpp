@@ -0,0 +1,232 @@
+// src/ShaderHotReload.cpp
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <GLFW/glfw3.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "ShaderHotReload.h"
+
+namespace {
+    std::string fileName(const std::string& path)
+    {
+        return std::filesystem::path(path).filename().string();
+    }
+}
+
+ShaderHotReload::ShaderHotReload(GLFWwindow* window, const std::string& directory)
+    : context(nullptr), directory(directory), notifyFd(-1), stopping(false), reloads(0), failures(0)
+{
+#ifdef __linux__
+    // Los editores guardan escribiendo el fichero (IN_CLOSE_WRITE) o
+    // renombrando uno temporal encima (IN_MOVED_TO)
+    notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd < 0 || inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        fprintf(stderr, "Could not watch %s for shader changes\n", directory.c_str());
+        return;
+    }
+#endif
+
+    // Ventana oculta de 1x1: solo aporta un contexto que comparte los
+    // objetos (programas, fences) con el de la ventana principal
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    context = glfwCreateWindow(1, 1, "shader hot reload", nullptr, window);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!context)
+    {
+        fprintf(stderr, "Could not create a shared context for shader hot reload\n");
+        return;
+    }
+
+    worker = std::thread(&ShaderHotReload::WorkerLoop, this);
+}
+
+ShaderHotReload::~ShaderHotReload()
+{
+    stopping = true;
+    if (worker.joinable())
+        worker.join();
+
+    for (WatchedProgram& program : programs)
+    {
+        if (program.fence)
+            glDeleteSync(program.fence);
+        program.ready.reset();
+    }
+    if (context)
+        glfwDestroyWindow(context);
+#ifdef __linux__
+    if (notifyFd >= 0)
+        close(notifyFd);
+#endif
+}
+
+int ShaderHotReload::Watch(const std::string& vertexPath, const std::string& fragmentPath,
+    const std::string& vertexDefines, const std::string& fragmentDefines)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    WatchedProgram program;
+    program.vertexPath = vertexPath;
+    program.fragmentPath = fragmentPath;
+    program.vertexDefines = vertexDefines;
+    program.fragmentDefines = fragmentDefines;
+    programs.push_back(std::move(program));
+    return static_cast<int>(programs.size()) - 1;
+}
+
+std::unique_ptr<Shader> ShaderHotReload::TakeReloaded(int program)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (program < 0 || program >= static_cast<int>(programs.size()))
+        return nullptr;
+
+    WatchedProgram& watched = programs[program];
+    if (!watched.ready)
+        return nullptr;
+
+    // Sin esperar: si el contexto del hilo aún no terminó, el cambio
+    // se hace en un frame posterior
+    if (watched.fence)
+    {
+        if (glClientWaitSync(watched.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            return nullptr;
+        glDeleteSync(watched.fence);
+        watched.fence = nullptr;
+    }
+    return std::move(watched.ready);
+}
+
+void ShaderHotReload::WorkerLoop()
+{
+    glfwMakeContextCurrent(context);
+    while (!stopping)
+    {
+        std::vector<std::string> changed = WaitForChanges();
+        if (!changed.empty())
+            Rebuild(changed);
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+std::vector<std::string> ShaderHotReload::WaitForChanges()
+{
+    std::vector<std::string> changed;
+    auto addChange = [&](const std::string& name) {
+        if (std::find(changed.begin(), changed.end(), name) == changed.end())
+            changed.push_back(name);
+        };
+
+#ifdef __linux__
+    // Espera corta para poder ver la petición de parada
+    pollfd descriptor{ notifyFd, POLLIN, 0 };
+    if (poll(&descriptor, 1, 100) <= 0)
+        return changed;
+
+    auto readEvents = [&]() {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(notifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* p = buffer; p < buffer + length; )
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                if (event->len > 0)
+                    addChange(event->name);
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+        };
+    // Un guardado suele generar varios eventos seguidos: se agrupan los
+    // que llegan en los 50 ms siguientes para compilar una sola vez
+    readEvents();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    readEvents();
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const WatchedProgram& program : programs)
+        {
+            paths.push_back(program.vertexPath);
+            paths.push_back(program.fragmentPath);
+        }
+    }
+    for (const std::string& path : paths)
+    {
+        std::error_code error;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        if (error)
+            continue;
+        auto known = timestamps.find(path);
+        if (known == timestamps.end())
+            timestamps.emplace(path, time);
+        else if (known->second != time)
+        {
+            known->second = time;
+            addChange(fileName(path));
+        }
+    }
+#endif
+    return changed;
+}
+
+void ShaderHotReload::Rebuild(const std::vector<std::string>& changedFiles)
+{
+    auto isChanged = [&](const std::string& path) {
+        return std::find(changedFiles.begin(), changedFiles.end(), fileName(path)) != changedFiles.end();
+        };
+
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count = programs.size();
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string vertexPath, fragmentPath, vertexDefines, fragmentDefines;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            vertexPath = programs[i].vertexPath;
+            fragmentPath = programs[i].fragmentPath;
+            vertexDefines = programs[i].vertexDefines;
+            fragmentDefines = programs[i].fragmentDefines;
+        }
+        if (!isChanged(vertexPath) && !isChanged(fragmentPath))
+            continue;
+
+        // Compilar y enlazar aquí, fuera del hilo de render
+        std::string vertexSource = loadTextFile(vertexPath);
+        std::string fragmentSource = loadTextFile(fragmentPath);
+        std::unique_ptr<Shader> shader;
+        if (!vertexSource.empty() && !fragmentSource.empty())
+            shader = std::make_unique<Shader>(injectDefines(vertexSource, vertexDefines),
+                injectDefines(fragmentSource, fragmentDefines));
+        if (!shader || shader->GetId() == 0)
+        {
+            ++failures;
+            fprintf(stderr, "Reloading %s + %s failed, keeping the current program\n",
+                vertexPath.c_str(), fragmentPath.c_str());
+            continue;
+        }
+
+        // El hilo principal solo lo usará cuando esta fence se cumpla
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        WatchedProgram& program = programs[i];
+        if (program.fence)
+            glDeleteSync(program.fence);
+        program.fence = fence;
+        program.ready = std::move(shader); // descarta una versión anterior no usada
+        ++reloads;
+        printf("Reloaded %s + %s\n", vertexPath.c_str(), fragmentPath.c_str());
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,73 @@
+//src/ShaderHotReload.h
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include "Shader.h"
+
+struct GLFWwindow;
+
+// ---------------------------------------------------
+// Recarga de shaders en caliente. Un hilo vigila el directorio
+// (inotify en Linux, fecha de modificación en el resto) y recompila los
+// programas afectados en un contexto oculto compartido con el de la
+// ventana, así que el hilo principal nunca espera al compilador.
+// Un programa nuevo solo se entrega si enlazó bien y la GPU ya terminó
+// de crearlo (fence); si falla se conserva el anterior y se muestra el
+// log de errores.
+// ---------------------------------------------------
+class ShaderHotReload {
+public:
+    // Hay que crearlo en el hilo principal con el contexto de window activo
+    ShaderHotReload(GLFWwindow* window, const std::string& directory);
+    ~ShaderHotReload();
+    ShaderHotReload(const ShaderHotReload&) = delete;
+    ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+    // false si no se pudo crear el contexto compartido o vigilar el directorio
+    bool IsActive() const { return worker.joinable(); }
+
+    // Programa a recompilar cuando cambie alguno de sus dos ficheros; los
+    // defines se insertan en cada shader. Devuelve su identificador.
+    int Watch(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::string& vertexDefines = "", const std::string& fragmentDefines = "");
+
+    // Entre frames: la versión nueva del programa si ya está lista
+    // (nullptr si no hay ninguna). El llamador sustituye la suya.
+    std::unique_ptr<Shader> TakeReloaded(int program);
+
+    unsigned long long GetReloadCount() const { return reloads; }
+    unsigned long long GetFailureCount() const { return failures; }
+
+private:
+    struct WatchedProgram {
+        std::string vertexPath;
+        std::string fragmentPath;
+        std::string vertexDefines;
+        std::string fragmentDefines;
+        std::unique_ptr<Shader> ready;
+        GLsync fence = nullptr;
+    };
+
+    void WorkerLoop();
+    // Espera cambios; devuelve los nombres de fichero modificados
+    std::vector<std::string> WaitForChanges();
+    void Rebuild(const std::vector<std::string>& changedFiles);
+
+    GLFWwindow* context;
+    std::string directory;
+    int notifyFd;                 // inotify (Linux)
+    std::unordered_map<std::string, std::filesystem::file_time_type> timestamps; // resto
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::mutex mutex;
+    std::vector<WatchedProgram> programs;
+    std::atomic<unsigned long long> reloads;
+    std::atomic<unsigned long long> failures;
+};
@@ -0,0 +1,251 @@
+// src/SinCos.cpp
+#include <cstdint>
+#include <cstring>
+#include "SinCos.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SINCOS_HAS_SSE2 1
+#include <immintrin.h>
+#endif
+
+// AVX2 se compila con el atributo target en GCC/Clang y se elige en
+// ejecución; en MSVC solo si el proyecto ya se compila con /arch:AVX2
+#if defined(SINCOS_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define SINCOS_HAS_AVX2 1
+#define SINCOS_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(SINCOS_HAS_SSE2) && defined(__AVX2__)
+#define SINCOS_HAS_AVX2 1
+#define SINCOS_AVX2_TARGET
+#endif
+
+namespace {
+    const float kFourOverPi = 1.27323954473516f;
+    // pi/4 = DP1 + DP2 + DP3 (DP1 y DP2 exactos en float)
+    const float kDP1 = 0.78515625f;
+    const float kDP2 = 2.4187564849853515625e-4f;
+    const float kDP3 = 3.77489497744594108e-8f;
+    const float kSin0 = -1.9515295891e-4f, kSin1 = 8.3321608736e-3f, kSin2 = -1.6666654611e-1f;
+    const float kCos0 = 2.443315711809948e-5f, kCos1 = -1.388731625493765e-3f, kCos2 = 4.166664568298827e-2f;
+
+    float fromBits(std::uint32_t bits) { float f; std::memcpy(&f, &bits, 4); return f; }
+    std::uint32_t toBits(float f) { std::uint32_t bits; std::memcpy(&bits, &f, 4); return bits; }
+
+    void sinCosScalar(float angle, float& s, float& c)
+    {
+        std::uint32_t signSin = toBits(angle) & 0x80000000u;
+        float x = fromBits(toBits(angle) & 0x7fffffffu);
+
+        // Octante redondeado a par: j en {0, 2, 4, 6} módulo 8
+        std::uint32_t j = static_cast<std::uint32_t>(static_cast<std::int32_t>(x * kFourOverPi));
+        j = (j + 1) & ~1u;
+        float y = static_cast<float>(static_cast<std::int32_t>(j));
+
+        signSin ^= (j & 4u) << 29;
+        std::uint32_t signCos = (~(j - 2) & 4u) << 29;
+        bool swap = (j & 2u) != 0;
+
+        x = x - y * kDP1;
+        x = x - y * kDP2;
+        x = x - y * kDP3;
+        float z = x * x;
+
+        float cosPoly = kCos0;
+        cosPoly = cosPoly * z + kCos1;
+        cosPoly = cosPoly * z + kCos2;
+        cosPoly = cosPoly * z;
+        cosPoly = cosPoly * z;
+        cosPoly = cosPoly - z * 0.5f;
+        cosPoly = cosPoly + 1.0f;
+
+        float sinPoly = kSin0;
+        sinPoly = sinPoly * z + kSin1;
+        sinPoly = sinPoly * z + kSin2;
+        sinPoly = sinPoly * z;
+        sinPoly = sinPoly * x;
+        sinPoly = sinPoly + x;
+
+        s = fromBits(toBits(swap ? cosPoly : sinPoly) ^ signSin);
+        c = fromBits(toBits(swap ? sinPoly : cosPoly) ^ signCos);
+    }
+
+#ifdef SINCOS_HAS_SSE2
+    void sinCosSSE2(const float* angles, float* sines, float* cosines, std::size_t count)
+    {
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+        const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2), four = _mm_set1_epi32(4);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 angle = _mm_loadu_ps(angles + i);
+            __m128 signSin = _mm_and_ps(angle, signMask);
+            __m128 x = _mm_andnot_ps(signMask, angle);
+
+            __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(kFourOverPi)));
+            j = _mm_andnot_si128(one, _mm_add_epi32(j, one));
+            __m128 y = _mm_cvtepi32_ps(j);
+
+            signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four), 29)));
+            __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, two), four), 29));
+            __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two), two));
+
+            x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP1)));
+            x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP2)));
+            x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(kDP3)));
+            __m128 z = _mm_mul_ps(x, x);
+
+            __m128 cosPoly = _mm_set1_ps(kCos0);
+            cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(kCos1));
+            cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(kCos2));
+            cosPoly = _mm_mul_ps(cosPoly, z);
+            cosPoly = _mm_mul_ps(cosPoly, z);
+            cosPoly = _mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+            cosPoly = _mm_add_ps(cosPoly, _mm_set1_ps(1.0f));
+
+            __m128 sinPoly = _mm_set1_ps(kSin0);
+            sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(kSin1));
+            sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(kSin2));
+            sinPoly = _mm_mul_ps(sinPoly, z);
+            sinPoly = _mm_mul_ps(sinPoly, x);
+            sinPoly = _mm_add_ps(sinPoly, x);
+
+            __m128 s = _mm_or_ps(_mm_and_ps(swap, cosPoly), _mm_andnot_ps(swap, sinPoly));
+            __m128 c = _mm_or_ps(_mm_and_ps(swap, sinPoly), _mm_andnot_ps(swap, cosPoly));
+            _mm_storeu_ps(sines + i, _mm_xor_ps(s, signSin));
+            _mm_storeu_ps(cosines + i, _mm_xor_ps(c, signCos));
+        }
+        for (; i < count; ++i)
+            sinCosScalar(angles[i], sines[i], cosines[i]);
+    }
+#endif
+
+#ifdef SINCOS_HAS_AVX2
+    SINCOS_AVX2_TARGET
+    void sinCosAVX2(const float* angles, float* sines, float* cosines, std::size_t count)
+    {
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(0x80000000u)));
+        const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2), four = _mm256_set1_epi32(4);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 angle = _mm256_loadu_ps(angles + i);
+            __m256 signSin = _mm256_and_ps(angle, signMask);
+            __m256 x = _mm256_andnot_ps(signMask, angle);
+
+            __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(kFourOverPi)));
+            j = _mm256_andnot_si256(one, _mm256_add_epi32(j, one));
+            __m256 y = _mm256_cvtepi32_ps(j);
+
+            signSin = _mm256_xor_ps(signSin, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, four), 29)));
+            __m256 signCos = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, two), four), 29));
+            __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, two), two));
+
+            x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP1)));
+            x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP2)));
+            x = _mm256_sub_ps(x, _mm256_mul_ps(y, _mm256_set1_ps(kDP3)));
+            __m256 z = _mm256_mul_ps(x, x);
+
+            __m256 cosPoly = _mm256_set1_ps(kCos0);
+            cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(kCos1));
+            cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(kCos2));
+            cosPoly = _mm256_mul_ps(cosPoly, z);
+            cosPoly = _mm256_mul_ps(cosPoly, z);
+            cosPoly = _mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f)));
+            cosPoly = _mm256_add_ps(cosPoly, _mm256_set1_ps(1.0f));
+
+            __m256 sinPoly = _mm256_set1_ps(kSin0);
+            sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(kSin1));
+            sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(kSin2));
+            sinPoly = _mm256_mul_ps(sinPoly, z);
+            sinPoly = _mm256_mul_ps(sinPoly, x);
+            sinPoly = _mm256_add_ps(sinPoly, x);
+
+            __m256 s = _mm256_blendv_ps(sinPoly, cosPoly, swap);
+            __m256 c = _mm256_blendv_ps(cosPoly, sinPoly, swap);
+            _mm256_storeu_ps(sines + i, _mm256_xor_ps(s, signSin));
+            _mm256_storeu_ps(cosines + i, _mm256_xor_ps(c, signCos));
+        }
+        for (; i < count; ++i)
+            sinCosScalar(angles[i], sines[i], cosines[i]);
+    }
+#endif
+}
+
+bool sinCosKernelSupported(SinCosKernel kernel)
+{
+    switch (kernel)
+    {
+    case SinCosScalar:
+        return true;
+    case SinCosSSE2:
+#ifdef SINCOS_HAS_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case SinCosAVX2:
+#if defined(SINCOS_HAS_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2") != 0;
+#elif defined(SINCOS_HAS_AVX2)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+SinCosKernel bestSinCosKernel()
+{
+    static const SinCosKernel best = sinCosKernelSupported(SinCosAVX2) ? SinCosAVX2
+        : sinCosKernelSupported(SinCosSSE2) ? SinCosSSE2 : SinCosScalar;
+    return best;
+}
+
+const char* sinCosKernelName(SinCosKernel kernel)
+{
+    switch (kernel)
+    {
+    case SinCosScalar: return "scalar";
+    case SinCosSSE2: return "sse2";
+    case SinCosAVX2: return "avx2";
+    }
+    return "?";
+}
+
+void sinCos(const float* angles, float* sines, float* cosines, std::size_t count)
+{
+    sinCos(angles, sines, cosines, count, bestSinCosKernel());
+}
+
+void sinCos(const float* angles, float* sines, float* cosines, std::size_t count, SinCosKernel kernel)
+{
+#ifdef SINCOS_HAS_AVX2
+    if (kernel == SinCosAVX2 && sinCosKernelSupported(SinCosAVX2))
+    {
+        sinCosAVX2(angles, sines, cosines, count);
+        return;
+    }
+#endif
+#ifdef SINCOS_HAS_SSE2
+    if (kernel != SinCosScalar)
+    {
+        sinCosSSE2(angles, sines, cosines, count);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i)
+        sinCosScalar(angles[i], sines[i], cosines[i]);
+}
+
+void sinCosTable(float start, float step, int count, std::vector<float>& sines, std::vector<float>& cosines)
+{
+    std::vector<float> angles(count);
+    for (int i = 0; i < count; ++i)
+        angles[i] = start + i * step;
+
+    sines.resize(count);
+    cosines.resize(count);
+    sinCos(angles.data(), sines.data(), cosines.data(), angles.size());
+}
@@ -0,0 +1,23 @@
+//src/SinCos.h
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------
+// sincos vectorizado (algoritmo de Cephes: reducción a [-pi/4, pi/4] en
+// tres pasos y polinomios de grado 7/8). Mismas operaciones en las tres
+// variantes y sin FMA, así que dan el mismo resultado bit a bit.
+// Error absoluto < 1e-6 para |x| <= 8192 (ver --bench sincos).
+// ---------------------------------------------------
+enum SinCosKernel { SinCosScalar, SinCosSSE2, SinCosAVX2 };
+
+// La mejor variante disponible en esta CPU (AVX2 se detecta en ejecución)
+SinCosKernel bestSinCosKernel();
+const char* sinCosKernelName(SinCosKernel kernel);
+bool sinCosKernelSupported(SinCosKernel kernel);
+
+void sinCos(const float* angles, float* sines, float* cosines, std::size_t count);
+void sinCos(const float* angles, float* sines, float* cosines, std::size_t count, SinCosKernel kernel);
+
+// Tabla de senos y cosenos de start + i * step, i = 0 .. count-1
+void sinCosTable(float start, float step, int count, std::vector<float>& sines, std::vector<float>& cosines);
@@ -0,0 +1,235 @@
+// src/StreamBuffer.cpp
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
+
+// El buffer se enlaza a GL_COPY_WRITE_BUFFER para escribirlo: ese punto
+// no forma parte del estado de ningún VAO ni lo usa el dibujo, así que
+// se queda enlazado y las escrituras siguientes no lo vuelven a enlazar
+namespace {
+    const GLbitfield kPersistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+bool streamModeSupported(StreamMode mode)
+{
+    if (mode == StreamPersistent)
+        return GLAD_GL_VERSION_4_4 && glBufferStorage != nullptr;
+    return true;
+}
+
+StreamMode bestStreamMode()
+{
+    return streamModeSupported(StreamPersistent) ? StreamPersistent : StreamUnsynchronized;
+}
+
+const char* streamModeName(StreamMode mode)
+{
+    switch (mode)
+    {
+    case StreamPersistent: return "persistent";
+    case StreamUnsynchronized: return "unsynchronized";
+    case StreamBufferSubData: return "bufferSubData";
+    }
+    return "?";
+}
+
+StreamBuffer::StreamBuffer(std::size_t regionSize, int regionCount, std::size_t alignment, StreamMode mode)
+    : id(0), mode(mode), regionSize(0), regionCount(mode == StreamBufferSubData ? 1 : regionCount),
+      alignment(alignment), persistent(nullptr), region(0), lastRegion(-1), head(0), mappedOffset(0), mappedSize(0),
+      waits(0), bytesWritten(0)
+{
+    if (!streamModeSupported(mode))
+    {
+        fprintf(stderr, "Stream mode %s is not supported, using %s\n", streamModeName(mode),
+            streamModeName(StreamUnsynchronized));
+        this->mode = StreamUnsynchronized;
+    }
+
+    // Cada región empieza alineada para que cualquier offset lo esté
+    this->regionSize = (regionSize + alignment - 1) / alignment * alignment;
+    fences.assign(this->regionCount, nullptr);
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(this->regionSize * this->regionCount);
+
+    glGenBuffers(1, &id);
+    cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+    if (this->mode == StreamPersistent)
+    {
+        glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, kPersistentFlags);
+        persistent = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, kPersistentFlags));
+        if (!persistent)
+            fprintf(stderr, "Could not map the stream buffer persistently\n");
+    }
+    else
+    {
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+        if (this->mode == StreamBufferSubData)
+            staging.resize(this->regionSize);
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (GLsync fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    if (persistent)
+    {
+        cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    cachedDeleteBuffers(1, &id);
+}
+
+void StreamBuffer::WaitForRegion(int index)
+{
+    GLsync& fence = fences[index];
+    if (!fence)
+        return;
+
+    // Primero sin esperar: con varias regiones en vuelo lo normal es que
+    // la GPU ya haya terminado con ella
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        ++waits;
+        do
+        {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED)
+        fprintf(stderr, "glClientWaitSync failed on a stream buffer fence\n");
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+bool StreamBuffer::Reserve(std::size_t size, std::size_t& start) const
+{
+    start = (head + alignment - 1) / alignment * alignment;
+    if (start + size > regionSize)
+    {
+        fprintf(stderr, "Stream buffer region full: %zu bytes requested, %zu free\n", size,
+            regionSize - std::min(start, regionSize));
+        return false;
+    }
+    return true;
+}
+
+void* StreamBuffer::Map(std::size_t size, std::size_t& offset)
+{
+    std::size_t start = 0;
+    if (!Reserve(size, start))
+        return nullptr;
+
+    // Primer uso de la región en este frame: la GPU debe haberla soltado
+    if (head == 0 && mode != StreamBufferSubData)
+        WaitForRegion(region);
+
+    const std::size_t bufferOffset = region * regionSize + start;
+    void* data = nullptr;
+    switch (mode)
+    {
+    case StreamPersistent:
+        data = persistent ? persistent + bufferOffset : nullptr;
+        break;
+    case StreamUnsynchronized:
+        cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        data = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(bufferOffset),
+            static_cast<GLsizeiptr>(size), GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        break;
+    case StreamBufferSubData:
+        data = staging.data() + start;
+        break;
+    }
+    // Si el mapeo falla no se reserva nada: Unmap no tiene qué deshacer
+    if (!data)
+    {
+        fprintf(stderr, "Could not map %zu bytes of the stream buffer\n", size);
+        return nullptr;
+    }
+
+    head = start + size;
+    mappedOffset = bufferOffset;
+    mappedSize = size;
+    bytesWritten += size;
+    offset = mappedOffset;
+    return data;
+}
+
+void StreamBuffer::Unmap()
+{
+    if (mappedSize == 0)
+        return;
+
+    if (mode == StreamUnsynchronized)
+    {
+        cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    else if (mode == StreamBufferSubData)
+    {
+        cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(mappedOffset),
+            static_cast<GLsizeiptr>(mappedSize), staging.data() + mappedOffset);
+    }
+    // StreamPersistent: mapeo coherente, no hay nada que hacer
+    mappedSize = 0;
+}
+
+bool StreamBuffer::Write(const void* data, std::size_t size, std::size_t& offset)
+{
+    if (mode == StreamBufferSubData)
+    {
+        std::size_t start = 0;
+        if (!Reserve(size, start))
+            return false;
+        head = start + size;
+        bytesWritten += size;
+        offset = start;
+        cachedBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(start), static_cast<GLsizeiptr>(size), data);
+        return true;
+    }
+
+    void* target = Map(size, offset);
+    if (!target)
+        return false;
+    std::memcpy(target, data, size);
+    Unmap();
+    return true;
+}
+
+void StreamBuffer::EndFrame()
+{
+    if (mode == StreamBufferSubData)
+    {
+        head = 0;
+        return;
+    }
+
+    // Sin datos nuevos la región no se cambia, pero lo dibujado puede
+    // seguir leyendo la última escrita (un UBO que sigue enlazado): su
+    // fence pasa a ser la de este frame para no reescribirla antes de
+    // tiempo cuando el anillo dé la vuelta
+    if (head == 0)
+    {
+        if (lastRegion >= 0)
+        {
+            GLsync& fence = fences[lastRegion];
+            if (fence)
+                glDeleteSync(fence);
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        return;
+    }
+
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    lastRegion = region;
+    region = (region + 1) % regionCount;
+    head = 0;
+}
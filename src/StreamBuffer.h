@@ -0,0 +1,86 @@
+//src/StreamBuffer.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <glad/glad.h>
+
+// Cómo llegan los datos de la CPU al buffer
+enum StreamMode {
+    StreamPersistent,     // glBufferStorage + mapeo persistente y coherente (GL 4.4)
+    StreamUnsynchronized, // glMapBufferRange con GL_MAP_UNSYNCHRONIZED_BIT
+    StreamBufferSubData   // glBufferSubData sobre la misma zona (referencia)
+};
+
+// Persistente si el contexto lo permite; si no, sin sincronizar.
+// Requiere un contexto activo.
+StreamMode bestStreamMode();
+bool streamModeSupported(StreamMode mode);
+const char* streamModeName(StreamMode mode);
+
+// ---------------------------------------------------
+// Buffer de streaming para datos que cambian cada frame (vértices,
+// instancias, uniforms). Es un anillo de regionCount regiones: cada
+// frame escribe en la suya y EndFrame pone una fence tras sus comandos.
+// Un frame sin datos nuevos renueva la fence de la última región
+// escrita, que puede seguir en uso.
+// Antes de volver a escribir en una región se espera a su fence, así
+// que la CPU nunca pisa datos que la GPU aún está leyendo y, con varias
+// regiones, casi nunca tiene que esperar.
+// Con StreamBufferSubData hay una sola región y el driver sincroniza.
+// ---------------------------------------------------
+class StreamBuffer {
+public:
+    StreamBuffer(std::size_t regionSize, int regionCount = 3, std::size_t alignment = 16,
+        StreamMode mode = bestStreamMode());
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Reserva size bytes en la región del frame y devuelve dónde
+    // escribirlos; offset es su posición dentro del buffer (para
+    // glVertexAttribPointer, glBindBufferRange...). nullptr si no caben o
+    // si el mapeo falla; entonces no hay que llamar a Unmap.
+    void* Map(std::size_t size, std::size_t& offset);
+    // Termina la escritura del último Map
+    void Unmap();
+    // Copia data al buffer (Map + memcpy + Unmap; con StreamBufferSubData
+    // va directo a glBufferSubData). false si no cabe.
+    bool Write(const void* data, std::size_t size, std::size_t& offset);
+    // Llamar después de los draws que usan los datos del frame
+    void EndFrame();
+
+    GLuint GetId() const { return id; }
+    StreamMode GetMode() const { return mode; }
+    std::size_t GetRegionSize() const { return regionSize; }
+    // Bytes que aún caben en la región del frame en un solo Map
+    std::size_t GetFreeBytes() const
+    {
+        return regionSize - std::min((head + alignment - 1) / alignment * alignment, regionSize);
+    }
+
+    // Veces que Map tuvo que esperar a la GPU para reutilizar una región
+    unsigned long long GetWaitCount() const { return waits; }
+    unsigned long long GetBytesWritten() const { return bytesWritten; }
+
+private:
+    // Posición alineada de size bytes en la región actual
+    bool Reserve(std::size_t size, std::size_t& start) const;
+    void WaitForRegion(int index);
+
+    GLuint id;
+    StreamMode mode;
+    std::size_t regionSize;
+    int regionCount;
+    std::size_t alignment;
+    unsigned char* persistent;           // mapeo de todo el buffer (StreamPersistent)
+    std::vector<unsigned char> staging;  // copia para glBufferSubData
+    std::vector<GLsync> fences;          // una por región
+    int region;
+    int lastRegion;                      // última región con datos (-1 = ninguna)
+    std::size_t head;                    // bytes usados en la región actual
+    std::size_t mappedOffset;
+    std::size_t mappedSize;
+    unsigned long long waits;
+    unsigned long long bytesWritten;
+};
@@ -0,0 +1,93 @@
+// src/ThreadPool.cpp
+#include <algorithm>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : job(nullptr), jobCount(0), chunkSize(1), nextChunk(0), busyWorkers(0),
+      generation(0), stopping(false)
+{
+    for (int i = 1; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+void ThreadPool::ParallelFor(int count, int minChunk, const std::function<void(int, int)>& body)
+{
+    if (count <= 0)
+        return;
+
+    // Unos cuatro bloques por hilo para repartir bien la carga
+    int threads = GetThreadCount();
+    int chunk = std::max(std::max(minChunk, 1), (count + threads * 4 - 1) / (threads * 4));
+    if (workers.empty() || chunk >= count)
+    {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobCount = count;
+        chunkSize = chunk;
+        nextChunk.store(0);
+        busyWorkers = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    RunChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::RunChunks()
+{
+    for (;;)
+    {
+        int begin = nextChunk.fetch_add(1) * chunkSize;
+        if (begin >= jobCount)
+            return;
+        (*job)(begin, std::min(begin + chunkSize, jobCount));
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned int seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        RunChunks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0)
+            finished.notify_one();
+    }
+}
@@ -0,0 +1,50 @@
+//src/ThreadPool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------
+// Pool de hilos fijo para bucles paralelos.
+// ParallelFor reparte [0, count) en bloques contiguos que los hilos
+// toman de un contador atómico; el hilo que llama también trabaja y no
+// vuelve hasta que todos los bloques han terminado. Cada bloque debe
+// escribir en un rango propio de la salida (sin sincronización).
+// ---------------------------------------------------
+class ThreadPool {
+public:
+    // threadCount incluye al hilo que llama: 1 = todo en serie
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int GetThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    // body(begin, end) para bloques de al menos minChunk elementos
+    void ParallelFor(int count, int minChunk, const std::function<void(int, int)>& body);
+
+    // Pool compartido con un hilo por núcleo
+    static ThreadPool& Shared();
+
+private:
+    void WorkerLoop();
+    void RunChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex; // un único ParallelFor a la vez
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(int, int)>* job;
+    int jobCount;
+    int chunkSize;
+    std::atomic<int> nextChunk;
+    int busyWorkers;
+    unsigned int generation;
+    bool stopping;
+};
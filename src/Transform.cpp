@@ -0,0 +1,26 @@
+// src/Transform.cpp
+#include <cmath>
+#include "Transform.h"
+
+glm::mat3 computeNormalMatrix(const glm::mat4& model)
+{
+    glm::mat3 linear(model);
+
+    // Columnas ortogonales y de igual longitud => M = s * R y
+    // (M^-1)^T = R / s = M / s^2
+    float lengthSq0 = glm::dot(linear[0], linear[0]);
+    float lengthSq1 = glm::dot(linear[1], linear[1]);
+    float lengthSq2 = glm::dot(linear[2], linear[2]);
+    float tolerance = 1e-4f * lengthSq0;
+
+    bool uniformScale = std::fabs(lengthSq0 - lengthSq1) <= tolerance &&
+                        std::fabs(lengthSq0 - lengthSq2) <= tolerance;
+    bool orthogonal = std::fabs(glm::dot(linear[0], linear[1])) <= tolerance &&
+                      std::fabs(glm::dot(linear[0], linear[2])) <= tolerance &&
+                      std::fabs(glm::dot(linear[1], linear[2])) <= tolerance;
+
+    if (uniformScale && orthogonal && lengthSq0 > 0.0f)
+        return linear * (1.0f / lengthSq0);
+
+    return glm::transpose(glm::inverse(linear));
+}
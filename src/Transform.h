@@ -0,0 +1,8 @@
+//src/Transform.h
+#pragma once
+#include <glm/glm.hpp>
+
+// Matriz de normales (inversa traspuesta de la parte 3x3 del modelo).
+// Para rotación + escala uniforme, el caso de todas las formas del visor,
+// es la propia 3x3 dividida por la escala al cuadrado: sin inversa.
+glm::mat3 computeNormalMatrix(const glm::mat4& model);
@@ -0,0 +1,297 @@
+// src/VertexFormat.cpp
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+#include "VertexFormat.h"
+
+namespace {
+    VertexLayout defaultLayout = { PositionSnorm16, NormalOctahedral };
+
+    std::size_t positionSize(PositionFormat format)
+    {
+        return format == PositionFloat32 ? 3 * sizeof(float) : 4 * sizeof(std::int16_t);
+    }
+
+    std::size_t normalSize(NormalFormat format)
+    {
+        return format == NormalFloat32 ? 3 * sizeof(float) : sizeof(std::uint32_t);
+    }
+
+    float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+    // Proyección sobre el octaedro |x|+|y|+|z| = 1 y plegado del
+    // hemisferio inferior sobre el superior
+    glm::vec2 octahedralEncode(glm::vec3 n)
+    {
+        n /= std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+        glm::vec2 e(n.x, n.y);
+        if (n.z < 0.0f)
+            e = glm::vec2((1.0f - std::fabs(n.y)) * signNotZero(n.x), (1.0f - std::fabs(n.x)) * signNotZero(n.y));
+        return e;
+    }
+
+    glm::vec3 octahedralDecode(glm::vec2 e)
+    {
+        glm::vec3 n(e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y));
+        if (n.z < 0.0f)
+            n = glm::vec3((1.0f - std::fabs(e.y)) * signNotZero(e.x), (1.0f - std::fabs(e.x)) * signNotZero(e.y), n.z);
+        return glm::normalize(n);
+    }
+
+    std::int16_t toSnorm16(float v)
+    {
+        return static_cast<std::int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    // Regla de GL 4.2+: max(c / 32767, -1)
+    float fromSnorm16(std::int16_t c)
+    {
+        return std::max(c / 32767.0f, -1.0f);
+    }
+
+    std::uint32_t packNormal1010102(const glm::vec3& n)
+    {
+        auto component = [](float v) {
+            return static_cast<std::uint32_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 511.0f)) & 0x3ffu;
+            };
+        return component(n.x) | (component(n.y) << 10) | (component(n.z) << 20);
+    }
+
+    glm::vec3 unpackNormal1010102(std::uint32_t packed)
+    {
+        auto component = [&](int shift) {
+            int value = static_cast<int>((packed >> shift) & 0x3ffu);
+            if (value >= 512)
+                value -= 1024;
+            return std::max(value / 511.0f, -1.0f);
+            };
+        return glm::vec3(component(0), component(10), component(20));
+    }
+}
+
+void setDefaultVertexLayout(const VertexLayout& layout)
+{
+    defaultLayout = layout;
+}
+
+const VertexLayout& defaultVertexLayout()
+{
+    return defaultLayout;
+}
+
+bool parsePositionFormat(const std::string& name, PositionFormat& format)
+{
+    if (name == "float") format = PositionFloat32;
+    else if (name == "half") format = PositionHalf;
+    else if (name == "snorm16") format = PositionSnorm16;
+    else return false;
+    return true;
+}
+
+bool parseNormalFormat(const std::string& name, NormalFormat& format)
+{
+    if (name == "float") format = NormalFloat32;
+    else if (name == "oct") format = NormalOctahedral;
+    else if (name == "packed") format = NormalPacked;
+    else return false;
+    return true;
+}
+
+const char* positionFormatName(PositionFormat format)
+{
+    switch (format)
+    {
+    case PositionFloat32: return "float";
+    case PositionHalf: return "half";
+    case PositionSnorm16: return "snorm16";
+    }
+    return "?";
+}
+
+const char* normalFormatName(NormalFormat format)
+{
+    switch (format)
+    {
+    case NormalFloat32: return "float";
+    case NormalOctahedral: return "oct";
+    case NormalPacked: return "packed";
+    }
+    return "?";
+}
+
+std::size_t vertexStride(const VertexLayout& layout)
+{
+    return positionSize(layout.position) + normalSize(layout.normal);
+}
+
+std::vector<unsigned char> encodeVertices(const std::vector<float>& vertices, const VertexLayout& layout,
+    glm::vec3& scale, glm::vec3& offset)
+{
+    std::size_t count = vertices.size() / 6;
+    std::size_t stride = vertexStride(layout);
+    std::vector<unsigned char> encoded(count * stride);
+
+    // Caja envolvente: las posiciones cuantizadas ocupan todo [-1, 1]
+    scale = glm::vec3(1.0f);
+    offset = glm::vec3(0.0f);
+    if (layout.position != PositionFloat32 && count > 0)
+    {
+        glm::vec3 minimum(vertices[0], vertices[1], vertices[2]), maximum = minimum;
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            glm::vec3 p(vertices[i * 6], vertices[i * 6 + 1], vertices[i * 6 + 2]);
+            minimum = glm::min(minimum, p);
+            maximum = glm::max(maximum, p);
+        }
+        offset = 0.5f * (minimum + maximum);
+        scale = 0.5f * (maximum - minimum);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (scale[axis] <= 0.0f)
+                scale[axis] = 1.0f;
+        }
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float* source = &vertices[i * 6];
+        unsigned char* out = &encoded[i * stride];
+
+        glm::vec3 p = (glm::vec3(source[0], source[1], source[2]) - offset) / scale;
+        switch (layout.position)
+        {
+        case PositionFloat32:
+            std::memcpy(out, source, 3 * sizeof(float));
+            break;
+        case PositionHalf:
+        {
+            std::uint16_t half[4] = { glm::packHalf1x16(p.x), glm::packHalf1x16(p.y), glm::packHalf1x16(p.z), 0 };
+            std::memcpy(out, half, sizeof(half));
+            break;
+        }
+        case PositionSnorm16:
+        {
+            std::int16_t snorm[4] = { toSnorm16(p.x), toSnorm16(p.y), toSnorm16(p.z), 0 };
+            std::memcpy(out, snorm, sizeof(snorm));
+            break;
+        }
+        }
+        out += positionSize(layout.position);
+
+        glm::vec3 n(source[3], source[4], source[5]);
+        switch (layout.normal)
+        {
+        case NormalFloat32:
+            std::memcpy(out, source + 3, 3 * sizeof(float));
+            break;
+        case NormalOctahedral:
+        {
+            glm::vec2 e = octahedralEncode(n);
+            std::int16_t snorm[2] = { toSnorm16(e.x), toSnorm16(e.y) };
+            std::memcpy(out, snorm, sizeof(snorm));
+            break;
+        }
+        case NormalPacked:
+        {
+            std::uint32_t packed = packNormal1010102(n);
+            std::memcpy(out, &packed, sizeof(packed));
+            break;
+        }
+        }
+    }
+    return encoded;
+}
+
+void decodeVertex(const unsigned char* vertex, const VertexLayout& layout,
+    const glm::vec3& scale, const glm::vec3& offset, glm::vec3& position, glm::vec3& normal)
+{
+    switch (layout.position)
+    {
+    case PositionFloat32:
+        std::memcpy(&position[0], vertex, 3 * sizeof(float));
+        break;
+    case PositionHalf:
+    {
+        std::uint16_t half[3];
+        std::memcpy(half, vertex, sizeof(half));
+        position = glm::vec3(glm::unpackHalf1x16(half[0]), glm::unpackHalf1x16(half[1]), glm::unpackHalf1x16(half[2]));
+        break;
+    }
+    case PositionSnorm16:
+    {
+        std::int16_t snorm[3];
+        std::memcpy(snorm, vertex, sizeof(snorm));
+        position = glm::vec3(fromSnorm16(snorm[0]), fromSnorm16(snorm[1]), fromSnorm16(snorm[2]));
+        break;
+    }
+    }
+    position = position * scale + offset;
+    vertex += positionSize(layout.position);
+
+    switch (layout.normal)
+    {
+    case NormalFloat32:
+        std::memcpy(&normal[0], vertex, 3 * sizeof(float));
+        break;
+    case NormalOctahedral:
+    {
+        std::int16_t snorm[2];
+        std::memcpy(snorm, vertex, sizeof(snorm));
+        normal = octahedralDecode(glm::vec2(fromSnorm16(snorm[0]), fromSnorm16(snorm[1])));
+        break;
+    }
+    case NormalPacked:
+    {
+        std::uint32_t packed;
+        std::memcpy(&packed, vertex, sizeof(packed));
+        normal = unpackNormal1010102(packed);
+        break;
+    }
+    }
+}
+
+void setupVertexAttributes(const VertexLayout& layout)
+{
+    GLsizei stride = static_cast<GLsizei>(vertexStride(layout));
+
+    // Posiciones
+    switch (layout.position)
+    {
+    case PositionFloat32:
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        break;
+    case PositionHalf:
+        glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)0);
+        break;
+    case PositionSnorm16:
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void*)0);
+        break;
+    }
+    glEnableVertexAttribArray(0);
+
+    // Normales
+    void* normalOffset = (void*)positionSize(layout.position);
+    switch (layout.normal)
+    {
+    case NormalFloat32:
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffset);
+        break;
+    case NormalOctahedral:
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, normalOffset);
+        break;
+    case NormalPacked:
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, normalOffset);
+        break;
+    }
+    glEnableVertexAttribArray(1);
+}
+
+std::string vertexLayoutDefines(const VertexLayout& layout)
+{
+    // Las posiciones y las normales empaquetadas las convierte el propio
+    // glVertexAttribPointer; solo la octaédrica necesita código
+    return layout.normal == NormalOctahedral ? "#define NORMAL_OCTAHEDRAL\n" : "";
+}
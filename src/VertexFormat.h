@@ -0,0 +1,57 @@
+//src/VertexFormat.h
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ---------------------------------------------------
+// Formato de los vértices en el VBO. Las posiciones cuantizadas se
+// guardan normalizadas a [-1, 1] dentro de la caja de la malla; la
+// escala y el desplazamiento para recuperarlas se aplican con la matriz
+// modelo (positionDecodeMatrix en Mesh.h), sin coste en el shader.
+// ---------------------------------------------------
+enum PositionFormat {
+    PositionFloat32,  // 3 x float (12 bytes)
+    PositionHalf,     // 3 x half + relleno (8 bytes)
+    PositionSnorm16,  // 3 x snorm16 + relleno (8 bytes)
+};
+
+enum NormalFormat {
+    NormalFloat32,    // 3 x float (12 bytes)
+    NormalOctahedral, // 2 x snorm16, codificación octaédrica (4 bytes)
+    NormalPacked,     // GL_INT_2_10_10_10_REV normalizado (4 bytes)
+};
+
+struct VertexLayout {
+    PositionFormat position;
+    NormalFormat normal;
+};
+
+// Formato usado por createShapeFromVertices cuando no se indica otro
+void setDefaultVertexLayout(const VertexLayout& layout);
+const VertexLayout& defaultVertexLayout();
+
+// "float", "half", "snorm16" / "float", "oct", "packed"
+bool parsePositionFormat(const std::string& name, PositionFormat& format);
+bool parseNormalFormat(const std::string& name, NormalFormat& format);
+const char* positionFormatName(PositionFormat format);
+const char* normalFormatName(NormalFormat format);
+
+std::size_t vertexStride(const VertexLayout& layout);
+
+// Convierte vértices [px, py, pz, nx, ny, nz, ...] al formato del layout.
+// Devuelve en scale/offset la transformación que recupera las posiciones
+// (p = q * scale + offset; identidad si son float).
+std::vector<unsigned char> encodeVertices(const std::vector<float>& vertices, const VertexLayout& layout,
+    glm::vec3& scale, glm::vec3& offset);
+
+// Decodifica un vértice igual que lo hace la GPU (para medir el error)
+void decodeVertex(const unsigned char* vertex, const VertexLayout& layout,
+    const glm::vec3& scale, const glm::vec3& offset, glm::vec3& position, glm::vec3& normal);
+
+// glVertexAttribPointer de aPos (0) y aNormal (1) con el VBO ya enlazado
+void setupVertexAttributes(const VertexLayout& layout);
+
+// Líneas #define que el vertex shader necesita para decodificar el layout
+std::string vertexLayoutDefines(const VertexLayout& layout);
@@ -6,30 +6,64 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <cmath>
 #include <fstream>
 #include <sstream>
 #include "Shader.h"
-
-
-// ---------------------------------------------------
-// Estructura para una forma (VAO + nmero de vrtices)
-// ---------------------------------------------------
-struct Shape {
-    GLuint VAO;
-    GLsizei vertexCount;
+#include "Mesh.h"
+#include "Benchmark.h"
+#include "Bvh.h"
+#include "Culling.h"
+#include "FixedTimestep.h"
+#include "Framebuffer.h"
+#include "GLStateCache.h"
+#include "Options.h"
+#include "FrameProfiler.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "FrameUniformBuffer.h"
+#include "Transform.h"
+#include "Lod.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
+#include "OcclusionCulling.h"
+#include "Picking.h"
+#include "ShaderHotReload.h"
+
+
+// Estado simulado de la figura (rotación en grados y escala). Avanza a
+// paso fijo; al dibujar se interpola entre el estado anterior y el actual.
+struct SimulationState {
+    float rotX = 0.0f;
+    float rotY = 0.0f;
+    float rotZ = 0.0f;
+    float scale = 1.0f;
 };
+SimulationState previousState;
+SimulationState currentState;
 
-// Variables globales de transformacin
-float rotX = 0.0f;
-float rotY = 0.0f;
-float rotZ = 0.0f;
-float scaleFactor = 1.0f;
+// Paso de la simulación y velocidades (las de antes: 1 grado y 0.01 de
+// escala por frame a 60 FPS, ahora independientes de los FPS)
+const double kSimulationStep = 1.0 / 60.0;
+const float kRotationSpeed = 60.0f; // grados por segundo
+const float kScaleSpeed = 0.6f;     // unidades de escala por segundo
 
-// ndice de forma actual: 0 = cubo, 1 = esfera, 2 = pirmide, 3 = toro
+// Índice de forma actual: 0 = cubo, 1 = esfera, 2 = pirámide, 3 = toro,
+// 4 = modelo OBJ (solo si se cargó con --obj)
 int currentShapeIndex = 0;
+int shapeCount = 4;
+
+// Tamaño actual del área de render (ventana o framebuffer headless)
+int framebufferWidth = 800;
+int framebufferHeight = 600;
 
 // Colores predefinidos
 std::vector<glm::vec3> colors = {
@@ -50,29 +84,52 @@ struct Material {
 std::vector<Material> materials = {
     { glm::vec3(0.3f), 8.0f  }, // mate
     { glm::vec3(0.7f), 32.0f }, // brillante
-    { glm::vec3(1.0f), 64.0f }, // metlico
-    { glm::vec3(0.5f), 4.0f  }  // ms suave
+    { glm::vec3(1.0f), 64.0f }, // metálico
+    { glm::vec3(0.5f), 4.0f  }  // más suave
 };
 int currentMaterialIndex = 0;
 
+// Phong en el fragment shader (forward) o deferred shading (tecla G)
+bool deferredShading = false;
+// false si los programas del deferred no se pudieron crear: G no hace nada
+bool deferredAvailable = true;
+
 // Prototipos
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
+void updateSimulation(GLFWwindow* window, SimulationState& state, float dt);
+SimulationState interpolate(const SimulationState& a, const SimulationState& b, float t);
 
+int main(int argc, char* argv[])
+{
+    // -------------------------------------------
+    // 0. Argumentos de línea de comandos
+    // -------------------------------------------
+    AppOptions options;
+    if (!parseArguments(argc, argv, options))
+        return -1;
 
-// Utilitarios
-std::string loadTextFile(const std::string& path);
+    // Formato de vértice de todas las formas (y defines de los shaders)
+    setDefaultVertexLayout(options.vertexLayout);
 
-Shape createShapeFromVertices(const std::vector<float>& data);
-Shape createCube();
-Shape createPyramid();
-Shape createSphere(int sectorCount, int stackCount);
-Shape createTorus(int numMajor, int numMinor, float majorRadius, float minorRadius);
+    const Benchmark* benchmark = nullptr;
+    if (!options.benchmark.empty())
+    {
+        benchmark = findBenchmark(options.benchmark);
+        if (!benchmark)
+        {
+            std::cerr << "Benchmark desconocido: " << options.benchmark << "\nDisponibles:\n";
+            listBenchmarks();
+            return -1;
+        }
+    }
+
+    // Los benchmarks de CPU no necesitan ventana ni contexto
+    if (benchmark && !benchmark->needsGL)
+        return benchmark->run(options);
 
-int main()
-{
     // -------------------------------------------
-    // 1. Inicializacin de GLFW
+    // 1. Inicialización de GLFW
     // -------------------------------------------
     if (!glfwInit())
     {
@@ -80,13 +137,21 @@ int main()
         return -1;
     }
 
-    // Configurar versin de OpenGL: 3.3 Core
+    // Configurar versión de OpenGL: 3.3 Core
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    // En modo headless la ventana solo aporta el contexto (con GLFW compilado
+    // con GLFW_USE_OSMESA ni siquiera hace falta un servidor gráfico) y el
+    // render va a un framebuffer propio del tamaño pedido
+    if (options.headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    int windowWidth = options.headless ? 64 : options.width;
+    int windowHeight = options.headless ? 64 : options.height;
+
     // Crear ventana
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Explorador de Formas - OpenGL", nullptr, nullptr);
+    GLFWwindow* window = glfwCreateWindow(windowWidth, windowHeight, "Explorador de Formas - OpenGL", nullptr, nullptr);
     if (!window)
     {
         std::cerr << "Error: no se pudo crear la ventana\n";
@@ -95,7 +160,11 @@ int main()
     }
 
     glfwMakeContextCurrent(window);
+    // Sin vsync (--no-vsync) el bucle no se limita al refresco: la
+    // simulación a paso fijo hace que la animación no cambie
+    glfwSwapInterval(options.vsync ? 1 : 0);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
 
     // -------------------------------------------
     // 2. Inicializar GLAD
@@ -106,19 +175,51 @@ int main()
         return -1;
     }
 
-    glEnable(GL_DEPTH_TEST);
+    cachedEnable(GL_DEPTH_TEST);
+
+    std::unique_ptr<Framebuffer> offscreen;
+    if (options.headless)
+    {
+        offscreen = std::make_unique<Framebuffer>(options.width, options.height);
+        if (!offscreen->IsComplete())
+        {
+            glfwTerminate();
+            return -1;
+        }
+        framebufferWidth = options.width;
+        framebufferHeight = options.height;
+    }
+
+    if (benchmark)
+    {
+        int result = benchmark->run(options);
+        offscreen.reset(); // antes de destruir el contexto
+        glfwTerminate();
+        return result;
+    }
 
     // -------------------------------------------
     
     // -------------------------------------------
     // 3. Crear programa de shaders usando la clase Shader
-    std::string vsCode = loadTextFile("src/shaders/vertex_shader.glsl");
-    std::string fsCode = loadTextFile("src/shaders/fragment_shader.glsl");
+    //    (los binarios enlazados se guardan en shader_cache/)
+    Shader::SetBinaryCacheDirectory(options.useShaderCache ? "shader_cache" : "");
+    // Las mallas generadas se guardan en mesh_cache/ y se proyectan con mmap
+    setMeshCacheDirectory(options.useMeshCache ? "mesh_cache" : "");
+    std::string layoutDefines = vertexLayoutDefines(options.vertexLayout);
+    // Con luces puntuales (--lights) los fragment shaders suman además
+    // las luces de su cluster
+    std::string lightingDefines = options.pointLights > 0 ? "#define CLUSTERED_LIGHTING\n" : "";
+    std::string vsCode = injectDefines(loadTextFile("src/shaders/vertex_shader.glsl"), layoutDefines);
+    std::string fsCode = injectDefines(loadTextFile("src/shaders/fragment_shader.glsl"), lightingDefines);
+    // Pasada de geometría del deferred shading: los mismos programas
+    // escriben el G-buffer en vez de iluminar
+    std::string gbufferDefines = "#define DEFERRED_GBUFFER\n";
 
 
 
-    Shader shader(vsCode, fsCode);
-    GLuint shaderProgram = shader.GetId();
+    auto shader = std::make_unique<Shader>(vsCode, fsCode);
+    GLuint shaderProgram = shader->GetId();
 
     if (shaderProgram == 0)
     {
@@ -126,97 +227,642 @@ int main()
         return -1;
     }
 
+    // Programas del modo que no está activo: al cambiar de modo se
+    // intercambian, así que el bucle siempre usa shader (e instancedShader).
+    // Los del deferred se crean la primera vez que se pide (tecla G o
+    // --deferred): una ejecución solo forward no los compila.
+    std::unique_ptr<Shader> inactiveShader;
+    std::unique_ptr<DeferredRenderer> deferredRenderer;
+    deferredShading = options.deferred;
+    bool deferredActive = false;
+
     // -------------------------------------------
-    // 4. Crear las formas (cubo, esfera, pirmide, toro)
+    // 4. Crear las formas (cubo, esfera, pirámide, toro)
+    //    Esfera y toro con varios niveles de detalle: cada frame se
+    //    elige uno según el tamaño en pantalla
     // -------------------------------------------
-    Shape cube = createCube();
-    Shape sphere = createSphere(24, 24);           // resolucin baja, minimalista
-    Shape pyramid = createPyramid();
-    Shape torus = createTorus(32, 16, 1.0f, 0.3f);
+    std::vector<LodChain> lods = {
+        createSingleLod(createCube(), std::sqrt(3.0f)),
+        createSphereLod(),
+        createSingleLod(createPyramid(), std::sqrt(3.0f)),
+        createTorusLod(1.0f, 0.3f)
+    };
+    LodStats lodStats{};
+
+    // Modelo OBJ (--obj): quinta forma, sin niveles de detalle, centrada
+    // y escalada al tamaño de las demás
+    std::unique_ptr<PickMesh> objPickMesh; // solo con --scene
+    if (!options.objFile.empty())
+    {
+        MeshData objMesh;
+        auto loadStart = std::chrono::steady_clock::now();
+        ObjLoadStats objStats{};
+        if (!loadObj(options.objFile, objMesh, ThreadPool::Shared(), &objStats))
+        {
+            std::cerr << "Error: no se pudo cargar el modelo " << options.objFile << "\n";
+            return -1;
+        }
+        std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - loadStart;
+
+        const float objRadius = 1.3f;
+        normalizeMesh(objMesh, objRadius);
+        optimizeMesh(objMesh);
+        lods.push_back(createSingleLod(createShapeFromVertices(objMesh), objRadius));
+        if (options.sceneObjects > 0)
+            objPickMesh = std::make_unique<PickMesh>(std::move(objMesh));
+
+        std::cout << "Modelo OBJ: " << objStats.triangles << " triángulos, " << objStats.vertices
+                  << " vértices (" << objStats.bytes / (1024.0 * 1024.0) << " MB leídos en "
+                  << loadTime.count() << " ms)\n";
+        if (objStats.skippedLines > 0)
+            std::cerr << "Aviso: " << objStats.skippedLines << " líneas mal formadas ignoradas\n";
+        if (objStats.generatedNormals)
+            std::cout << "El modelo no trae todas las normales: se han calculado normales suaves\n";
+    }
+    shapeCount = static_cast<int>(lods.size());
 
-    std::vector<Shape> shapes = { cube, sphere, pyramid, torus };
+    // La escena instanciada usa un nivel intermedio fijo de cada forma
+    std::vector<Shape> shapes;
+    for (const LodChain& chain : lods)
+        shapes.push_back(chain.levels[std::min<size_t>(2, chain.levels.size() - 1)]);
 
     // -------------------------------------------
-    // 5. Configuracin de la luz y cmara
+    // 5. Configuración de la luz y cámara
     // -------------------------------------------
     glm::vec3 lightPos(2.0f, 2.0f, 2.0f);
 
+    // Handles de uniforms resueltos fuera del bucle (y de nuevo solo si el
+    // programa se recarga): el bucle no hace búsquedas
+    int uModel, uNormalMatrix, uObjectColor, uMaterialSpecular, uMaterialShininess;
+    ClusterUniforms shapeClusterUniforms;
+    auto resolveUniforms = [&]() {
+        uModel = shader->GetUniform("model");
+        uNormalMatrix = shader->GetUniform("normalMatrix");
+        uObjectColor = shader->GetUniform("objectColor");
+        uMaterialSpecular = shader->GetUniform("materialSpecular");
+        uMaterialShininess = shader->GetUniform("materialShininess");
+        shapeClusterUniforms = resolveClusterUniforms(*shader);
+        };
+    resolveUniforms();
+
+    // Escena grande (--scene <n>): cada frame se envían todos los objetos
+    // a la cola de render, que los ordena y los junta en una llamada
+    // instanciada por tipo de forma
+    std::unique_ptr<Shader> instancedShader;
+    std::unique_ptr<Shader> inactiveInstancedShader;
+    std::unique_ptr<RenderQueue> renderQueue;
+    Scene scene;
+    std::vector<InstanceData> sceneInstances;
+    std::vector<int> sceneMeshes;
+    int sceneProgram = -1;
+    // Volúmenes de los objetos en el espacio de la escena, su BVH (culling
+    // jerárquico y selección con el ratón) y visibles del frame
+    CullBounds sceneBounds;
+    Bvh sceneBvh;
+    std::vector<PickMesh> pickMeshes;
+    int selectedObject = -1;
+    bool mouseWasDown = false;
+    std::vector<std::uint32_t> visibleObjects;
+    std::size_t visibleCount = 0;
+    double cullingMs = 0.0;
+    // Oclusión por hardware (--occlusion): los tapados en el frame
+    // anterior se dibujan en una segunda pasada con render condicional
+    std::unique_ptr<OcclusionCuller> occlusion;
+    std::vector<std::uint32_t> hiddenObjects;
+    OcclusionStats occlusionTotals{};
+    RenderQueueStats firstPassStats{};
+    int uSceneModel = -1;
+    int uSceneNormalMatrix = -1;
+    ClusterUniforms sceneClusterUniforms;
+    auto setupInstancedShader = [&]() {
+        uSceneModel = instancedShader->GetUniform("model");
+        uSceneNormalMatrix = instancedShader->GetUniform("normalMatrix");
+        sceneClusterUniforms = resolveClusterUniforms(*instancedShader);
+
+        // La tabla de materiales no cambia: se sube una sola vez
+        glm::vec3 specular[4];
+        float shininess[4];
+        for (size_t i = 0; i < materials.size() && i < 4; ++i)
+        {
+            specular[i] = materials[i].specular;
+            shininess[i] = materials[i].shininess;
+        }
+        instancedShader->Bind();
+        instancedShader->SetVec3(instancedShader->GetUniform("materialSpecular"), specular, 4);
+        instancedShader->SetFloat(instancedShader->GetUniform("materialShininess"), shininess, 4);
+        };
+    glm::vec3 cameraPos(0.0f, 0.0f, 5.0f);
+    float farPlane = 100.0f;
+    if (options.sceneObjects > 0)
+    {
+        instancedShader = std::make_unique<Shader>(
+            injectDefines(loadTextFile("src/shaders/instanced_vertex_shader.glsl"), layoutDefines),
+            injectDefines(loadTextFile("src/shaders/instanced_fragment_shader.glsl"), lightingDefines));
+        if (instancedShader->GetId() == 0)
+        {
+            std::cerr << "Error: no se pudo crear el programa de instancias\n";
+            return -1;
+        }
+
+        scene = generateScene(options.sceneObjects, static_cast<int>(shapes.size()), colors,
+            static_cast<int>(materials.size()), 1234u);
+
+        // Los datos por instancia y los volúmenes no cambian: se calculan
+        // una vez y la cola solo guarda punteros a los datos
+        sceneInstances.reserve(scene.objects.size());
+        sceneBounds.Reserve(scene.objects.size());
+        visibleObjects.resize(scene.objects.size());
+        for (const SceneObject& object : scene.objects)
+        {
+            sceneBounds.Add(shapes[object.shapeType].bounds, object.model);
+
+            InstanceData data;
+            data.model = object.model * positionDecodeMatrix(shapes[object.shapeType]);
+            data.color = object.color;
+            data.material = static_cast<float>(object.material);
+            data.normalMatrix = computeNormalMatrix(object.model);
+            sceneInstances.push_back(data);
+        }
+
+        auto bvhStart = std::chrono::steady_clock::now();
+        sceneBvh.Build(boxesFromBounds(sceneBounds));
+        std::chrono::duration<double, std::milli> bvhTime = std::chrono::steady_clock::now() - bvhStart;
+        std::cout << "BVH de la escena: " << sceneBvh.GetNodes().size() << " nodos de " << sizeof(BvhNode)
+                  << " bytes en " << bvhTime.count() << " ms\n";
+
+        // Mallas en CPU para la selección: la misma geometría que el nivel
+        // que usa la escena (nivel 2 de esfera y toro)
+        pickMeshes.emplace_back(generateCube());
+        pickMeshes.emplace_back(generateSphere(32, 24));
+        pickMeshes.emplace_back(generatePyramid());
+        pickMeshes.emplace_back(generateTorus(32, 16, 1.0f, 0.3f));
+        if (objPickMesh)
+        {
+            pickMeshes.push_back(std::move(*objPickMesh));
+            objPickMesh.reset();
+        }
+
+        renderQueue = std::make_unique<RenderQueue>(std::min<std::size_t>(scene.objects.size(), 65536));
+        sceneProgram = renderQueue->AddProgram(instancedShader.get());
+        for (const Shape& shape : shapes)
+            sceneMeshes.push_back(renderQueue->AddMesh(shape));
+        setupInstancedShader();
+
+        if (options.occlusionCulling)
+        {
+            occlusion = std::make_unique<OcclusionCuller>(scene.objects.size());
+            if (!occlusion->IsValid())
+            {
+                std::cerr << "Error: no se pudo crear el programa de las cajas de oclusión\n";
+                return -1;
+            }
+            hiddenObjects.reserve(scene.objects.size());
+        }
+
+        // Cámara lo bastante lejos para ver toda la escena
+        cameraPos.z = std::max(5.0f, scene.radius * 2.5f);
+        farPlane = cameraPos.z + scene.radius + 10.0f;
+        lightPos = glm::vec3(cameraPos.z * 0.4f);
+    }
+
+    // Luces puntuales (--lights) repartidas por la escena o alrededor de
+    // la forma. El alcance baja con el número de luces para que cada
+    // punto quede dentro de unas 8 de media: el coste por fragmento no
+    // depende de cuántas haya.
+    std::vector<PointLight> pointLights;
+    std::vector<PointLight> worldLights;
+    std::unique_ptr<LightClusters> lightClusters;
+    double clusterAssignMs = 0.0;
+    int clusteredFrames = 0;
+    if (options.pointLights > 0)
+    {
+        float spread = renderQueue ? scene.radius : 2.5f;
+        float range = spread * std::cbrt(8.0f / options.pointLights);
+        pointLights = generateLights(options.pointLights, spread, range, 99u);
+        worldLights = pointLights;
+        lightClusters = std::make_unique<LightClusters>();
+    }
+
+    // Recarga en caliente: al guardar un .glsl de src/shaders/ el programa
+    // se recompila en otro hilo y se cambia entre dos frames si enlaza
+    std::unique_ptr<ShaderHotReload> hotReload;
+    // Un programa vigilado por modo: [0] forward, [1] G-buffer
+    int shaderWatch[2] = { -1, -1 };
+    int instancedWatch[2] = { -1, -1 };
+    if (options.hotReload)
+    {
+        hotReload = std::make_unique<ShaderHotReload>(window, "src/shaders");
+        if (hotReload->IsActive())
+        {
+            const std::string fragmentDefines[2] = { lightingDefines, gbufferDefines };
+            for (int mode = 0; mode < 2; ++mode)
+            {
+                shaderWatch[mode] = hotReload->Watch("src/shaders/vertex_shader.glsl",
+                    "src/shaders/fragment_shader.glsl", layoutDefines, fragmentDefines[mode]);
+                if (instancedShader)
+                    instancedWatch[mode] = hotReload->Watch("src/shaders/instanced_vertex_shader.glsl",
+                        "src/shaders/instanced_fragment_shader.glsl", layoutDefines, fragmentDefines[mode]);
+            }
+        }
+        else
+        {
+            hotReload.reset();
+        }
+    }
+
+    currentShapeIndex = options.shapeIndex;
+
+    // Bloque uniform por frame (punto de enlace FrameDataBlock)
+    auto frameUniforms = std::make_unique<FrameUniformBuffer>();
+
+    // Perfilador de frames (solo activo con --profile)
+    auto profiler = std::make_unique<FrameProfiler>(!options.profileOutput.empty());
+
     // Bucle principal
-    while (!glfwWindowShouldClose(window))
+    FixedTimestep timestep(kSimulationStep);
+    int frameCount = 0;
+    // Cambios de estado GL enviados y evitados por la caché (suma y último frame)
+    GLStateCounters stateTotals{};
+    GLStateCounters lastFrameState{};
+    while (!glfwWindowShouldClose(window) && (options.frames == 0 || frameCount < options.frames))
     {
+        profiler->BeginFrame();
+        beginGLStateFrame();
+
         // 5.1 Entrada
+        profiler->BeginPhase(FrameProfiler::Input);
         processInput(window);
 
+        // Simulación a paso fijo con el tiempo real transcurrido
+        int steps = timestep.Advance(glfwGetTime());
+        for (int step = 0; step < steps; ++step)
+        {
+            previousState = currentState;
+            updateSimulation(window, currentState, static_cast<float>(timestep.GetStep()));
+        }
+        SimulationState view = interpolate(previousState, currentState, timestep.GetAlpha());
+
+        // Primera vez en deferred: programas del G-buffer y de la luz. Si
+        // alguno falla se sigue en forward y la tecla G deja de funcionar.
+        if (deferredShading && !deferredRenderer)
+        {
+            inactiveShader = std::make_unique<Shader>(vsCode,
+                injectDefines(loadTextFile("src/shaders/fragment_shader.glsl"), gbufferDefines));
+            if (instancedShader)
+                inactiveInstancedShader = std::make_unique<Shader>(
+                    injectDefines(loadTextFile("src/shaders/instanced_vertex_shader.glsl"), layoutDefines),
+                    injectDefines(loadTextFile("src/shaders/instanced_fragment_shader.glsl"), gbufferDefines));
+            deferredRenderer = std::make_unique<DeferredRenderer>();
+            if (inactiveShader->GetId() == 0 || (inactiveInstancedShader && inactiveInstancedShader->GetId() == 0)
+                || !deferredRenderer->IsValid())
+            {
+                std::cerr << "Error: no se pudieron crear los programas del deferred shading, se sigue en forward\n";
+                deferredRenderer.reset();
+                inactiveInstancedShader.reset();
+                inactiveShader.reset();
+                deferredAvailable = false;
+                deferredShading = false;
+            }
+        }
+
+        // Cambio de forward a deferred o al revés: se intercambian los
+        // programas de los dos modos
+        if (deferredShading != deferredActive)
+        {
+            deferredActive = deferredShading;
+            std::swap(shader, inactiveShader);
+            resolveUniforms();
+            if (instancedShader)
+            {
+                std::swap(instancedShader, inactiveInstancedShader);
+                renderQueue->SetProgram(sceneProgram, instancedShader.get());
+                setupInstancedShader();
+            }
+            std::cout << (deferredActive ? "Deferred shading\n" : "Forward shading\n");
+        }
+
+        // Programas recompilados en segundo plano: se cambian aquí, entre
+        // frames, y solo si ya están listos (nunca se espera al driver).
+        // Los del modo inactivo esperan a que se vuelva a él.
+        if (hotReload)
+        {
+            if (std::unique_ptr<Shader> reloaded = hotReload->TakeReloaded(shaderWatch[deferredActive]))
+            {
+                shader = std::move(reloaded);
+                resolveUniforms();
+            }
+            if (std::unique_ptr<Shader> reloaded = hotReload->TakeReloaded(instancedWatch[deferredActive]))
+            {
+                instancedShader = std::move(reloaded);
+                renderQueue->SetProgram(sceneProgram, instancedShader.get());
+                setupInstancedShader();
+            }
+        }
+        profiler->EndPhase(FrameProfiler::Input);
+
+        // En deferred se dibuja en el G-buffer
+        if (deferredActive)
+            deferredRenderer->BeginGeometry(framebufferWidth, framebufferHeight);
+        else if (offscreen)
+            offscreen->Bind();
+
         // 5.2 Limpiar buffers
         glClearColor(0.07f, 0.07f, 0.09f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // 5.3 Activar programa de shaders
-        shader.Bind();
-        GLuint shaderProgram = shader.GetId();
-
-        // 5.4 Matrices de cmara y proyeccin
-        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f),
+        // 5.3 Estado por frame (cámara y luz): un único bloque uniform
+        //     compartido por todos los programas, subido solo si cambió
+        profiler->BeginPhase(FrameProfiler::Uniforms);
+        FrameData frameData{};
+        frameData.view = glm::lookAt(cameraPos,
             glm::vec3(0.0f, 0.0f, 0.0f),
             glm::vec3(0.0f, 1.0f, 0.0f));
-
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f),
-            800.0f / 600.0f,
+        frameData.projection = glm::perspective(glm::radians(45.0f),
+            (float)framebufferWidth / (float)std::max(framebufferHeight, 1),
             0.1f,
-            100.0f);
-
-        // 5.5 Matriz modelo (transformaciones de la figura)
+            farPlane);
+        frameData.viewPos = cameraPos;
+        frameData.lightPos = lightPos;
+        frameData.lightAmbient = glm::vec3(0.2f);
+        frameData.lightDiffuse = glm::vec3(0.7f);
+        frameData.lightSpecular = glm::vec3(1.0f);
+        frameUniforms->Update(frameData);
+
+        // 5.4 Activar programa de shaders
+        Shader& activeShader = renderQueue ? *instancedShader : *shader;
+        activeShader.Bind();
+
+        // 5.5 Matriz modelo (transformaciones de la figura o de toda la escena)
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::scale(model, glm::vec3(scaleFactor));
-        model = glm::rotate(model, glm::radians(rotX), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotY), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(rotZ), glm::vec3(0.0f, 0.0f, 1.0f));
-
-        // 5.6 Enviar matrices a los shaders
-        GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
-        GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
-        GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-
-        // 5.7 Parmetros de la luz
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 1, glm::value_ptr(lightPos));
-        glm::vec3 cameraPos(0.0f, 0.0f, 5.0f);
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 1, glm::value_ptr(cameraPos));
-
-        // Intensidad bsica de luz
-        glm::vec3 lightAmbient(0.2f);
-        glm::vec3 lightDiffuse(0.7f);
-        glm::vec3 lightSpecular(1.0f);
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightAmbient"), 1, glm::value_ptr(lightAmbient));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightDiffuse"), 1, glm::value_ptr(lightDiffuse));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightSpecular"), 1, glm::value_ptr(lightSpecular));
-
-        // 5.8 Color y material actuales
-        glm::vec3 objectColor = colors[currentColorIndex];
-        Material mat = materials[currentMaterialIndex];
-
-        glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, glm::value_ptr(objectColor));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "materialSpecular"), 1, glm::value_ptr(mat.specular));
-        glUniform1f(glGetUniformLocation(shaderProgram, "materialShininess"), mat.shininess);
-
-        // 5.9 Dibujar la forma actual
-        Shape currentShape = shapes[currentShapeIndex];
-        glBindVertexArray(currentShape.VAO);
-        glDrawArrays(GL_TRIANGLES, 0, currentShape.vertexCount);
-        glBindVertexArray(0);
+        model = glm::scale(model, glm::vec3(view.scale));
+        model = glm::rotate(model, glm::radians(view.rotX), glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(view.rotY), glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, glm::radians(view.rotZ), glm::vec3(0.0f, 0.0f, 1.0f));
+
+        // 5.6 Nivel de detalle según el tamaño en pantalla (solo forma suelta)
+        LodChain* lod = renderQueue ? nullptr : &lods[currentShapeIndex];
+        int lodLevel = 0;
+        if (lod)
+        {
+            float screenRadius = projectedRadius(*lod, model, frameData.view, frameData.projection, framebufferHeight);
+            lodLevel = selectLodLevel(*lod, screenRadius);
+        }
+
+        // 5.7 Enviar la matriz modelo y la de normales (solo se suben si
+        //     cambiaron). La de la forma incluye la decodificación de sus
+        //     posiciones cuantizadas; la de normales usa la original.
+        if (lod)
+            activeShader.SetMat4(uModel, model * positionDecodeMatrix(lod->levels[lodLevel]));
+        else
+            activeShader.SetMat4(uSceneModel, model);
+        activeShader.SetMat3(renderQueue ? uSceneNormalMatrix : uNormalMatrix, computeNormalMatrix(model));
+
+        // 5.7b Luces puntuales: giran con la escena (o la forma). En
+        //      forward se reparten por clusters en la CPU y se suben a sus
+        //      buffers; en deferred se dibujan tras la geometría (5.10).
+        if (lightClusters)
+        {
+            for (size_t i = 0; i < pointLights.size(); ++i)
+            {
+                worldLights[i] = pointLights[i];
+                worldLights[i].position = glm::vec3(model * glm::vec4(pointLights[i].position, 1.0f));
+                worldLights[i].radius = pointLights[i].radius * view.scale;
+            }
+            if (!deferredActive)
+            {
+                lightClusters->Assign(worldLights, frameData.view, frameData.projection);
+                lightClusters->Upload(worldLights);
+                lightClusters->Apply(activeShader, renderQueue ? sceneClusterUniforms : shapeClusterUniforms,
+                    framebufferWidth, framebufferHeight);
+                clusterAssignMs += lightClusters->GetStats().assignMs;
+                ++clusteredFrames;
+            }
+        }
+
+        // 5.8 Color y material actuales (en la escena van por instancia)
+        if (!renderQueue)
+        {
+            glm::vec3 objectColor = colors[currentColorIndex];
+            Material mat = materials[currentMaterialIndex];
+
+            shader->SetVec3(uObjectColor, objectColor);
+            shader->SetVec3(uMaterialSpecular, mat.specular);
+            shader->SetFloat(uMaterialShininess, mat.shininess);
+        }
+        profiler->EndPhase(FrameProfiler::Uniforms);
+
+        // 5.9 Dibujar la forma actual o la escena completa
+        profiler->BeginPhase(FrameProfiler::Draw);
+        if (renderQueue)
+        {
+            glm::mat4 viewModel = frameData.view * model;
+
+            // Clic izquierdo: el rayo del cursor, del plano cercano al
+            // lejano y llevado al espacio de la escena, elige el objeto
+            // que se resalta
+            bool mouseDown = !offscreen && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+            if (mouseDown && !mouseWasDown)
+            {
+                double cursorX, cursorY;
+                int windowWidth, windowHeight;
+                glfwGetCursorPos(window, &cursorX, &cursorY);
+                glfwGetWindowSize(window, &windowWidth, &windowHeight);
+                float ndcX = static_cast<float>(2.0 * cursorX / std::max(windowWidth, 1) - 1.0);
+                float ndcY = static_cast<float>(1.0 - 2.0 * cursorY / std::max(windowHeight, 1));
+                glm::mat4 toScene = glm::inverse(frameData.projection * viewModel);
+                glm::vec4 nearPoint = toScene * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+                glm::vec4 farPoint = toScene * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+                glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+                PickHit hit = pickObject(sceneBvh, scene.objects, pickMeshes, origin,
+                    glm::vec3(farPoint) / farPoint.w - origin);
+
+                if (selectedObject >= 0)
+                    sceneInstances[selectedObject].color = scene.objects[selectedObject].color;
+                selectedObject = hit.object;
+                if (hit.object >= 0)
+                {
+                    const char* shapeNames[] = { "cubo", "esfera", "pirámide", "toro", "modelo OBJ" };
+                    sceneInstances[hit.object].color = glm::vec3(1.0f, 0.5f, 0.0f);
+                    std::cout << "Objeto seleccionado: " << hit.object << " ("
+                              << shapeNames[scene.objects[hit.object].shapeType] << ")\n";
+                }
+            }
+            mouseWasDown = mouseDown;
+
+            // Solo los objetos que tocan el frustum (planos llevados al
+            // espacio de la escena con la matriz modelo), recorriendo el BVH
+            auto cullStart = std::chrono::steady_clock::now();
+            visibleCount = sceneBvh.Cull(extractFrustum(frameData.projection * viewModel), sceneBounds,
+                visibleObjects.data());
+            cullingMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cullStart).count();
+
+            // Profundidad en espacio de vista del centro de cada objeto.
+            // Con oclusión, los tapados según la última respuesta esperan
+            // a la segunda pasada.
+            if (occlusion)
+            {
+                occlusion->BeginFrame();
+                hiddenObjects.clear();
+            }
+            renderQueue->Begin();
+            for (std::size_t v = 0; v < visibleCount; ++v)
+            {
+                std::uint32_t i = visibleObjects[v];
+                if (occlusion && occlusion->IsOccluded(i))
+                {
+                    hiddenObjects.push_back(i);
+                    continue;
+                }
+                const SceneObject& object = scene.objects[i];
+                float depth = -(viewModel * object.model[3]).z;
+                renderQueue->Submit(PassOpaque, sceneProgram, sceneMeshes[object.shapeType], object.material,
+                    depth, &sceneInstances[i]);
+            }
+            renderQueue->Execute();
+            firstPassStats = renderQueue->GetStats();
+
+            if (occlusion)
+            {
+                // Cajas contra la profundidad de la primera pasada, con la
+                // cámara llevada al espacio de la escena. El margen es el
+                // doble del plano cercano (0.1) para cubrir sus esquinas.
+                glm::mat4 toScene = glm::inverse(viewModel);
+                float nearMargin = 0.2f * glm::length(glm::vec3(toScene[0]));
+                occlusion->Test(visibleObjects.data(), visibleCount, sceneBounds, frameData.projection * viewModel,
+                    glm::vec3(toScene[3]), nearMargin);
+
+                // Segunda pasada: cada tapado depende de su consulta (la
+                // GPU lo descarta sin que la CPU espere la respuesta)
+                renderQueue->Begin();
+                for (std::uint32_t i : hiddenObjects)
+                {
+                    const SceneObject& object = scene.objects[i];
+                    float depth = -(viewModel * object.model[3]).z;
+                    renderQueue->Submit(PassOpaque, sceneProgram, sceneMeshes[object.shapeType], object.material,
+                        depth, &sceneInstances[i], occlusion->GetConditionQuery(i));
+                }
+                renderQueue->Execute();
+
+                const OcclusionStats& frameStats = occlusion->GetStats();
+                occlusionTotals.tested += frameStats.tested;
+                occlusionTotals.culled += frameStats.culled;
+                occlusionTotals.falseNegatives += frameStats.falseNegatives;
+                occlusionTotals.pending += frameStats.pending;
+            }
+        }
+        else
+            drawLodLevel(*lod, lodLevel, lodStats);
+
+        // 5.10 Deferred: luz sobre el G-buffer y resultado al destino
+        if (deferredActive)
+            deferredRenderer->Light(worldLights, frameData.view, frameData.projection,
+                offscreen ? offscreen->GetId() : 0);
+        // Fence de las regiones del bloque FrameData y de las instancias
+        // usadas en este frame
+        frameUniforms->EndFrame();
+        if (renderQueue)
+            renderQueue->EndFrame();
+        profiler->EndPhase(FrameProfiler::Draw);
 
         // Intercambiar buffers y procesar eventos
-        glfwSwapBuffers(window);
+        profiler->BeginPhase(FrameProfiler::Swap);
+        if (!offscreen)
+            glfwSwapBuffers(window);
         glfwPollEvents();
+        profiler->EndPhase(FrameProfiler::Swap);
+
+        profiler->EndFrame();
+        lastFrameState = getGLStateFrameCounters();
+        stateTotals.issued += lastFrameState.issued;
+        stateTotals.elided += lastFrameState.elided;
+        ++frameCount;
+    }
+
+    if (offscreen && !options.outputImage.empty())
+        offscreen->SavePPM(options.outputImage);
+
+    if (profiler->IsEnabled())
+    {
+        profiler->PrintSummary();
+        profiler->Save(options.profileOutput);
+    }
+
+    const UniformStats& uniformStats = (renderQueue ? instancedShader : shader)->GetUniformStats();
+    std::cout << "Uniforms enviados: " << uniformStats.uploaded
+              << ", omitidos (sin cambios): " << uniformStats.skipped << "\n";
+    std::cout << "Bloque FrameData: " << frameUniforms->GetUploadCount() << " subidas, "
+              << frameUniforms->GetSkipCount() << " frames sin cambios\n";
+    if (renderQueue)
+    {
+        std::cout << "Frustum culling (BVH): " << visibleCount
+                  << " de " << scene.objects.size() << " objetos visibles en el último frame (" << cullingMs << " ms)\n";
+        const RenderQueueStats& queueStats = firstPassStats;
+        std::cout << "Cola de render: " << queueStats.items << " objetos en " << queueStats.drawCalls
+                  << " draws, " << queueStats.stateChanges << " cambios de estado (sin ordenar: "
+                  << queueStats.items << " draws, " << queueStats.unsortedStateChanges << " cambios); orden "
+                  << queueStats.sortMs << " ms, envío " << queueStats.submitMs << " ms\n";
+    }
+    if (occlusion && frameCount > 0)
+    {
+        const OcclusionStats& last = occlusion->GetStats();
+        std::cout << "Oclusión por hardware (por frame): " << static_cast<double>(occlusionTotals.tested) / frameCount
+                  << " cajas probadas, " << static_cast<double>(occlusionTotals.culled) / frameCount
+                  << " objetos tapados, " << static_cast<double>(occlusionTotals.falseNegatives) / frameCount
+                  << " falsos negativos, " << static_cast<double>(occlusionTotals.pending) / frameCount
+                  << " consultas sin respuesta (último frame: " << last.tested << " / " << last.culled << " / "
+                  << last.falseNegatives << " / " << last.pending << ", " << renderQueue->GetStats().conditionalDraws
+                  << " draws condicionales)\n";
+    }
+    if (lightClusters && clusteredFrames > 0)
+    {
+        const ClusterStats& clusterStats = lightClusters->GetStats();
+        std::cout << "Clustered shading: " << pointLights.size() << " luces, reparto " << clusterAssignMs / clusteredFrames
+                  << " ms por frame; último frame: " << clusterStats.activeClusters << " de "
+                  << lightClusters->GetClusterCount() << " clusters con luces, " << clusterStats.indices
+                  << " índices (máximo " << clusterStats.maxPerCluster << " por cluster)\n";
+    }
+    if (deferredActive)
+    {
+        const DeferredStats& deferredStats = deferredRenderer->GetStats();
+        std::cout << "Deferred shading: G-buffer y buffer de luz de " << framebufferWidth << "x" << framebufferHeight
+                  << " (" << deferredStats.gbufferBytes / (1024.0 * 1024.0) << " MB), "
+                  << deferredStats.lights << " esferas de luz por frame\n";
+    }
+    if (frameCount > 0)
+    {
+        std::cout << "Cambios de estado GL por frame: " << static_cast<double>(stateTotals.issued) / frameCount
+                  << " enviados, " << static_cast<double>(stateTotals.elided) / frameCount
+                  << " evitados (último frame: " << lastFrameState.issued << " / " << lastFrameState.elided << ")\n";
+    }
+    if (hotReload && hotReload->GetReloadCount() + hotReload->GetFailureCount() > 0)
+    {
+        std::cout << "Shaders recargados: " << hotReload->GetReloadCount() << ", con errores: "
+                  << hotReload->GetFailureCount() << "\n";
+    }
+    if (lodStats.fullDetailTriangles > 0)
+    {
+        std::cout << "Triángulos LOD: " << lodStats.drawnTriangles << " dibujados de "
+                  << lodStats.fullDetailTriangles << " disponibles ("
+                  << 100.0 * lodStats.drawnTriangles / lodStats.fullDetailTriangles << "%)\n";
     }
 
     // Limpieza
-    for (auto& s : shapes) {
-        glDeleteVertexArrays(1, &s.VAO);
+    hotReload.reset(); // para el hilo y destruye su contexto
+    profiler.reset();
+    frameUniforms.reset();
+    offscreen.reset();
+    for (LodChain& chain : lods) {
+        destroyLodChain(chain);
     }
-    glDeleteProgram(shaderProgram);
+    // Los objetos GL deben destruirse antes que el contexto
+    occlusion.reset();
+    lightClusters.reset();
+    deferredRenderer.reset();
+    inactiveInstancedShader.reset();
+    inactiveShader.reset();
+    renderQueue.reset();
+    instancedShader.reset();
+    shader.reset();
 
     glfwTerminate();
     return 0;
@@ -227,7 +873,9 @@ int main()
 // ---------------------------------------------------
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    framebufferWidth = width;
+    framebufferHeight = height;
+    cachedViewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* window)
@@ -235,28 +883,14 @@ void processInput(GLFWwindow* window)
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    // Cambiar de forma: 1 = cubo, 2 = esfera, 3 = pirmide, 4 = toro
+    // Cambiar de forma: 1 = cubo, 2 = esfera, 3 = pirámide, 4 = toro, 5 = OBJ
     if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) currentShapeIndex = 0;
     if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) currentShapeIndex = 1;
     if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) currentShapeIndex = 2;
     if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) currentShapeIndex = 3;
+    if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS && shapeCount > 4) currentShapeIndex = 4;
 
-    // Rotacin
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) rotX += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) rotX -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) rotY += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) rotY -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) rotZ += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) rotZ -= 1.0f;
-
-    // Escala
-    if (glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS)
-        scaleFactor += 0.01f;
-    if (glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS)
-        scaleFactor -= 0.01f;
-
-    if (scaleFactor < 0.1f) scaleFactor = 0.1f;
-    if (scaleFactor > 3.0f) scaleFactor = 3.0f;
+    // Rotación y escala: se aplican en updateSimulation, a paso fijo
 
     // Cambiar color
     static bool cPressed = false;
@@ -268,6 +902,17 @@ void processInput(GLFWwindow* window)
         cPressed = false;
     }
 
+    // Forward / deferred shading
+    static bool gPressed = false;
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS && !gPressed) {
+        gPressed = true;
+        if (deferredAvailable)
+            deferredShading = !deferredShading;
+    }
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_RELEASE) {
+        gPressed = false;
+    }
+
     // Cambiar material
     static bool mPressed = false;
     if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS && !mPressed) {
@@ -280,305 +925,42 @@ void processInput(GLFWwindow* window)
 
     // Reset
     if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-        rotX = rotY = rotZ = 0.0f;
-        scaleFactor = 1.0f;
+        // Sin interpolar desde el estado anterior
+        previousState = currentState = SimulationState();
         currentColorIndex = 0;
         currentMaterialIndex = 0;
     }
 }
 
 // ---------------------------------------------------
-// Utilitarios de shaders
-// ---------------------------------------------------
-std::string loadTextFile(const std::string& path)
-{
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "No se pudo abrir el archivo: " << path << "\n";
-        return "";
-    }
-    std::stringstream ss;
-    ss << file.rdbuf();
-    return ss.str();
-}
-
-
-
-// ---------------------------------------------------
-// Crear VAO a partir de un vector de vrtices
-// Formato: [posx, posy, posz, nx, ny, nz, ...]
-// ---------------------------------------------------
-Shape createShapeFromVertices(const std::vector<float>& data)
-{
-    Shape s{};
-    s.vertexCount = static_cast<GLsizei>(data.size() / 6); // 3 pos + 3 normal
-
-    GLuint VBO;
-    glGenVertexArrays(1, &s.VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(s.VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
-
-    // Posiciones
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    // Normales
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    return s;
-}
-
-// ---------------------------------------------------
-// Cubo (centrado en el origen)
+// Simulación: un paso de dt segundos con las teclas pulsadas
 // ---------------------------------------------------
-Shape createCube()
+void updateSimulation(GLFWwindow* window, SimulationState& state, float dt)
 {
-    // 36 vrtices (12 tringulos), cada uno pos + normal
-    float vertices[] = {
-        // Posicin          // Normal
-        // Cara frontal
-        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-         1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-
-         1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-        -1.0f,  1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-        -1.0f, -1.0f,  1.0f,   0.0f,  0.0f,  1.0f,
-
-        // Cara trasera
-        -1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-         1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-         1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-
-         1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-        -1.0f, -1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-        -1.0f,  1.0f, -1.0f,   0.0f,  0.0f, -1.0f,
-
-        // Cara izquierda
-        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
-        -1.0f,  1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
-        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
-
-        -1.0f, -1.0f, -1.0f,  -1.0f,  0.0f,  0.0f,
-        -1.0f, -1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
-        -1.0f,  1.0f,  1.0f,  -1.0f,  0.0f,  0.0f,
-
-        // Cara derecha
-         1.0f,  1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
-         1.0f, -1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
-         1.0f,  1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
-
-         1.0f, -1.0f, -1.0f,   1.0f,  0.0f,  0.0f,
-         1.0f,  1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
-         1.0f, -1.0f,  1.0f,   1.0f,  0.0f,  0.0f,
-
-         // Cara superior
-         -1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
-          1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
-          1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
-
-          1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
-         -1.0f,  1.0f, -1.0f,   0.0f,  1.0f,  0.0f,
-         -1.0f,  1.0f,  1.0f,   0.0f,  1.0f,  0.0f,
-
-         // Cara inferior
-         -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
-          1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f,
-          1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
-
-          1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
-         -1.0f, -1.0f,  1.0f,   0.0f, -1.0f,  0.0f,
-         -1.0f, -1.0f, -1.0f,   0.0f, -1.0f,  0.0f
-    };
-
-    std::vector<float> data(vertices, vertices + sizeof(vertices) / sizeof(float));
-    return createShapeFromVertices(data);
-}
+    // Rotación
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) state.rotX += kRotationSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) state.rotX -= kRotationSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) state.rotY += kRotationSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) state.rotY -= kRotationSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) state.rotZ += kRotationSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) state.rotZ -= kRotationSpeed * dt;
 
-// ---------------------------------------------------
-// Pirmide (base cuadrada)
-// ---------------------------------------------------
-Shape createPyramid()
-{
-    // Pirmide centrada, altura 2, base de 2x2
-    std::vector<float> data;
-
-    glm::vec3 top(0.0f, 1.0f, 0.0f);
-    glm::vec3 bl(-1.0f, -1.0f, 1.0f); // bottom-left front
-    glm::vec3 br(1.0f, -1.0f, 1.0f); // bottom-right front
-    glm::vec3 brb(1.0f, -1.0f, -1.0f); // bottom-right back
-    glm::vec3 blb(-1.0f, -1.0f, -1.0f); // bottom-left back
-
-    auto addTriangle = [&](glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
-        glm::vec3 u = p2 - p1;
-        glm::vec3 v = p3 - p1;
-        glm::vec3 n = glm::normalize(glm::cross(u, v));
-        // p1
-        data.push_back(p1.x); data.push_back(p1.y); data.push_back(p1.z);
-        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
-        // p2
-        data.push_back(p2.x); data.push_back(p2.y); data.push_back(p2.z);
-        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
-        // p3
-        data.push_back(p3.x); data.push_back(p3.y); data.push_back(p3.z);
-        data.push_back(n.x);  data.push_back(n.y);  data.push_back(n.z);
-        };
-
-    // Lados
-    addTriangle(top, bl, br);    // frente
-    addTriangle(top, br, brb);   // derecha
-    addTriangle(top, brb, blb);  // atrs
-    addTriangle(top, blb, bl);   // izquierda
-
-    // Base (dos tringulos)
-    glm::vec3 nBase(0.0f, -1.0f, 0.0f);
-
-    auto addBaseTri = [&](glm::vec3 p1, glm::vec3 p2, glm::vec3 p3) {
-        data.push_back(p1.x); data.push_back(p1.y); data.push_back(p1.z);
-        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
-
-        data.push_back(p2.x); data.push_back(p2.y); data.push_back(p2.z);
-        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
-
-        data.push_back(p3.x); data.push_back(p3.y); data.push_back(p3.z);
-        data.push_back(nBase.x); data.push_back(nBase.y); data.push_back(nBase.z);
-        };
-
-    addBaseTri(bl, br, brb);
-    addBaseTri(brb, blb, bl);
-
-    return createShapeFromVertices(data);
-}
-
-// ---------------------------------------------------
-// Esfera generada por sectores y stacks
-// ---------------------------------------------------
-Shape createSphere(int sectorCount, int stackCount)
-{
-    std::vector<float> data;
-
-    float radius = 1.0f;
-    float pi = 3.14159265f;
-    float twoPi = 2.0f * pi;
-
-    for (int i = 0; i < stackCount; ++i)
-    {
-        float stackAngle1 = pi / 2 - (float)i * (pi / stackCount);
-        float stackAngle2 = pi / 2 - (float)(i + 1) * (pi / stackCount);
-
-        float y1 = radius * sinf(stackAngle1);
-        float r1 = radius * cosf(stackAngle1);
-
-        float y2 = radius * sinf(stackAngle2);
-        float r2 = radius * cosf(stackAngle2);
-
-        for (int j = 0; j < sectorCount; ++j)
-        {
-            float sectorAngle1 = j * (twoPi / sectorCount);
-            float sectorAngle2 = (j + 1) * (twoPi / sectorCount);
-
-            float x1 = r1 * cosf(sectorAngle1);
-            float z1 = r1 * sinf(sectorAngle1);
-
-            float x2 = r1 * cosf(sectorAngle2);
-            float z2 = r1 * sinf(sectorAngle2);
-
-            float x3 = r2 * cosf(sectorAngle1);
-            float z3 = r2 * sinf(sectorAngle1);
-
-            float x4 = r2 * cosf(sectorAngle2);
-            float z4 = r2 * sinf(sectorAngle2);
-
-            glm::vec3 p1(x1, y1, z1);
-            glm::vec3 p2(x2, y1, z2);
-            glm::vec3 p3(x3, y2, z3);
-            glm::vec3 p4(x4, y2, z4);
-
-            auto addVertex = [&](glm::vec3 p) {
-                glm::vec3 n = glm::normalize(p);
-                data.push_back(p.x); data.push_back(p.y); data.push_back(p.z);
-                data.push_back(n.x); data.push_back(n.y); data.push_back(n.z);
-                };
-
-            // tringulo 1
-            addVertex(p1);
-            addVertex(p2);
-            addVertex(p3);
-
-            // tringulo 2
-            addVertex(p2);
-            addVertex(p4);
-            addVertex(p3);
-        }
-    }
+    // Escala
+    if (glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS)
+        state.scale += kScaleSpeed * dt;
+    if (glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS)
+        state.scale -= kScaleSpeed * dt;
 
-    return createShapeFromVertices(data);
+    if (state.scale < 0.1f) state.scale = 0.1f;
+    if (state.scale > 3.0f) state.scale = 3.0f;
 }
 
-// ---------------------------------------------------
-// Toro (donut) paramtrico
-// ---------------------------------------------------
-Shape createTorus(int numMajor, int numMinor, float majorRadius, float minorRadius)
+SimulationState interpolate(const SimulationState& a, const SimulationState& b, float t)
 {
-    std::vector<float> data;
-
-    float twoPi = 2.0f * 3.14159265f;
-
-    for (int i = 0; i < numMajor; ++i)
-    {
-        float a0 = i * twoPi / numMajor;
-        float a1 = (i + 1) * twoPi / numMajor;
-
-        float x0 = cosf(a0);
-        float y0 = sinf(a0);
-        float x1 = cosf(a1);
-        float y1 = sinf(a1);
-
-        for (int j = 0; j < numMinor; ++j)
-        {
-            float b0 = j * twoPi / numMinor;
-            float b1 = (j + 1) * twoPi / numMinor;
-
-            float c0 = cosf(b0);
-            float r0 = minorRadius * c0 + majorRadius;
-            float z0 = minorRadius * sinf(b0);
-
-            float c1 = cosf(b1);
-            float r1 = minorRadius * c1 + majorRadius;
-            float z1 = minorRadius * sinf(b1);
-
-            glm::vec3 p1(r0 * x0, r0 * y0, z0);
-            glm::vec3 p2(r0 * x1, r0 * y1, z0);
-            glm::vec3 p3(r1 * x0, r1 * y0, z1);
-            glm::vec3 p4(r1 * x1, r1 * y1, z1);
-
-            auto addVertex = [&](glm::vec3 p, glm::vec3 centerRing) {
-                glm::vec3 n = glm::normalize(p - centerRing);
-                data.push_back(p.x); data.push_back(p.y); data.push_back(p.z);
-                data.push_back(n.x); data.push_back(n.y); data.push_back(n.z);
-                };
-
-            glm::vec3 center1(majorRadius * x0, majorRadius * y0, 0.0f);
-            glm::vec3 center2(majorRadius * x1, majorRadius * y1, 0.0f);
-
-            // tringulo 1
-            addVertex(p1, center1);
-            addVertex(p2, center2);
-            addVertex(p3, center1);
-
-            // tringulo 2
-            addVertex(p2, center2);
-            addVertex(p4, center2);
-            addVertex(p3, center1);
-        }
-    }
-
-    return createShapeFromVertices(data);
+    SimulationState result;
+    result.rotX = a.rotX + (b.rotX - a.rotX) * t;
+    result.rotY = a.rotY + (b.rotY - a.rotY) * t;
+    result.rotZ = a.rotZ + (b.rotZ - a.rotZ) * t;
+    result.scale = a.scale + (b.scale - a.scale) * t;
+    return result;
 }
@@ -0,0 +1,91 @@
+#version 330 core
+
+out vec4 FragColor;
+
+// G-buffer (DeferredRenderer.h)
+uniform sampler2D gbufferAlbedo; // rgb: albedo, a: intensidad especular
+uniform sampler2D gbufferNormal; // rg: normal octaédrica, b: brillo / 256
+uniform sampler2D gbufferDepth;
+uniform mat4 inverseViewProjection;
+
+// Estado por frame compartido por todos los programas (FrameUniformBuffer.h)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightAmbient;
+    vec3 lightDiffuse;
+    vec3 lightSpecular;
+};
+
+#ifdef LIGHT_VOLUME
+flat in vec4 LightPosition; // centro + alcance
+flat in vec3 LightColor;
+#endif
+
+// Inversa de encodeNormal (fragment_shader.glsl)
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        vec2 signs = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(e.yx)) * signs;
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gbufferDepth, pixel, 0).r;
+    // Fondo: no hay superficie que iluminar (las esferas ya lo descartan
+    // con la prueba de profundidad)
+    if (depth == 1.0)
+        discard;
+
+    // Posición en el mundo a partir de la profundidad
+    vec2 ndc = gl_FragCoord.xy / vec2(textureSize(gbufferDepth, 0)) * 2.0 - 1.0;
+    vec4 world = inverseViewProjection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+#ifdef LIGHT_VOLUME
+    vec3 toLight = LightPosition.xyz - fragPos;
+    float distance = length(toLight);
+    if (distance >= LightPosition.w)
+        discard;
+#endif
+
+    vec4 albedoSpecular  = texelFetch(gbufferAlbedo, pixel, 0);
+    vec4 normalShininess = texelFetch(gbufferNormal, pixel, 0);
+    vec3 albedo        = albedoSpecular.rgb;
+    vec3 specularColor = vec3(albedoSpecular.a);
+    float shininess    = normalShininess.b * 256.0;
+    vec3 norm          = decodeNormal(normalShininess.rg * 2.0 - 1.0);
+    vec3 viewDir       = normalize(viewPos - fragPos);
+
+#ifdef LIGHT_VOLUME
+    // Igual que clusteredLighting (fragment_shader.glsl)
+    float falloff = 1.0 - distance / LightPosition.w;
+    vec3 lightDir = toLight / max(distance, 1e-4);
+
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), shininess);
+    FragColor  = vec4(falloff * falloff * LightColor * (diff * albedo + spec * specularColor), 1.0);
+#else
+    vec3 lightDir = normalize(lightPos - fragPos);
+
+    vec3 ambient  = lightAmbient * albedo;
+
+    float diff    = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse  = lightDiffuse * diff * albedo;
+
+    vec3 reflectDir  = reflect(-lightDir, norm);
+    float spec       = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular    = lightSpecular * spec * specularColor;
+
+    FragColor = vec4(ambient + diffuse + specular, 1.0);
+#endif
+}
@@ -0,0 +1,43 @@
+#version 330 core
+
+#ifdef LIGHT_VOLUME
+// Esfera unidad (createSphere) llevada al alcance de cada luz
+in vec3 aPos;
+// Por luz (glVertexAttribDivisor = 1)
+in vec4 aLightPosition; // centro + alcance
+in vec3 aLightColor;
+
+uniform mat4  meshDecode;  // posiciones cuantizadas de la esfera
+uniform float volumeScale; // la malla queda dentro de la esfera: se agranda
+
+// Estado por frame compartido por todos los programas (FrameUniformBuffer.h)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightAmbient;
+    vec3 lightDiffuse;
+    vec3 lightSpecular;
+};
+
+flat out vec4 LightPosition;
+flat out vec3 LightColor;
+
+void main()
+{
+    LightPosition = aLightPosition;
+    LightColor    = aLightColor;
+    vec3 unitPos  = vec3(meshDecode * vec4(aPos, 1.0)) * volumeScale;
+    gl_Position   = projection * view * vec4(aLightPosition.xyz + unitPos * aLightPosition.w, 1.0);
+}
+#else
+// Triangulo que cubre la pantalla, sin atributos: vertices 0, 1, 2 en
+// (-1, -1), (3, -1) y (-1, 3)
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
+#endif
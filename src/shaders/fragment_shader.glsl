@@ -1,38 +1,116 @@
-#version 330 core
-
-in vec3 FragPos;
-in vec3 Normal;
-
-out vec4 FragColor;
-
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 objectColor;
-
-// Material
-uniform vec3  materialSpecular;
-uniform float materialShininess;
-
-// Luz
-uniform vec3 lightAmbient;
-uniform vec3 lightDiffuse;
-uniform vec3 lightSpecular;
-
-void main()
-{
-    vec3 norm     = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-
-    vec3 ambient  = lightAmbient * objectColor;
-
-    float diff    = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse  = lightDiffuse * diff * objectColor;
-
-    vec3 viewDir     = normalize(viewPos - FragPos);
-    vec3 reflectDir  = reflect(-lightDir, norm);
-    float spec       = pow(max(dot(viewDir, reflectDir), 0.0), materialShininess);
-    vec3 specular    = lightSpecular * spec * materialSpecular;
-
-    vec3 result = ambient + diffuse + specular;
-    FragColor  = vec4(result, 1.0);
-}
+#version 330 core
+
+in vec3 FragPos;
+in vec3 Normal;
+
+#ifdef DEFERRED_GBUFFER
+// Pasada de geometría del deferred shading (DeferredRenderer.h): no se
+// ilumina, se guarda el G-buffer
+layout(location = 0) out vec4 GBufferAlbedo;
+layout(location = 1) out vec4 GBufferNormal;
+#else
+out vec4 FragColor;
+#endif
+
+uniform vec3 objectColor;
+
+// Material
+uniform vec3  materialSpecular;
+uniform float materialShininess;
+
+// Estado por frame compartido por todos los programas (FrameUniformBuffer.h)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightAmbient;
+    vec3 lightDiffuse;
+    vec3 lightSpecular;
+};
+
+#ifdef CLUSTERED_LIGHTING
+// Luces puntuales repartidas por clusters (ClusteredLighting.h)
+uniform samplerBuffer  clusterLights;  // 2 texels por luz: posición + alcance, color
+uniform usamplerBuffer clusterGrid;    // por cluster: primer índice y número de luces
+uniform usamplerBuffer clusterIndices; // listas de todos los clusters seguidas
+uniform vec3  clusterTiles;            // baldosas en x, en y y cortes de profundidad
+uniform vec3  clusterScale;
+uniform float clusterBias;
+
+// Suma de las luces del cluster del fragmento (difusa + especular)
+vec3 clusteredLighting(vec3 norm, vec3 viewDir, vec3 albedo, vec3 specularColor, float shininess)
+{
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    vec3 cell = vec3(gl_FragCoord.xy, log(depth)) * clusterScale + vec3(0.0, 0.0, clusterBias);
+    ivec3 tiles = ivec3(clusterTiles);
+    ivec3 c = clamp(ivec3(floor(cell)), ivec3(0), tiles - 1);
+    uvec2 range = texelFetch(clusterGrid, (c.z * tiles.y + c.y) * tiles.x + c.x).xy;
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < range.y; ++i)
+    {
+        int light = int(texelFetch(clusterIndices, int(range.x + i)).x);
+        vec4 positionRadius = texelFetch(clusterLights, 2 * light);
+        vec3 color = texelFetch(clusterLights, 2 * light + 1).rgb;
+
+        vec3 toLight = positionRadius.xyz - FragPos;
+        float distance = length(toLight);
+        float falloff = clamp(1.0 - distance / positionRadius.w, 0.0, 1.0);
+        vec3 lightDir = toLight / max(distance, 1e-4);
+
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), shininess);
+        result += falloff * falloff * color * (diff * albedo + spec * specularColor);
+    }
+    return result;
+}
+#endif
+
+#ifdef DEFERRED_GBUFFER
+// Normal unitaria plegada en el octaedro y llevada a [0, 1]
+vec2 encodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    if (n.z < 0.0)
+    {
+        vec2 signs = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * signs;
+    }
+    return n.xy * 0.5 + 0.5;
+}
+
+// Los materiales son grises: la especular se guarda como intensidad
+void writeGBuffer(vec3 norm, vec3 albedo, vec3 specularColor, float shininess)
+{
+    GBufferAlbedo = vec4(albedo, max(specularColor.r, max(specularColor.g, specularColor.b)));
+    GBufferNormal = vec4(encodeNormal(norm), shininess / 256.0, 0.0);
+}
+#endif
+
+void main()
+{
+#ifdef DEFERRED_GBUFFER
+    writeGBuffer(normalize(Normal), objectColor, materialSpecular, materialShininess);
+#else
+    vec3 norm     = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+
+    vec3 ambient  = lightAmbient * objectColor;
+
+    float diff    = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse  = lightDiffuse * diff * objectColor;
+
+    vec3 viewDir     = normalize(viewPos - FragPos);
+    vec3 reflectDir  = reflect(-lightDir, norm);
+    float spec       = pow(max(dot(viewDir, reflectDir), 0.0), materialShininess);
+    vec3 specular    = lightSpecular * spec * materialSpecular;
+
+    vec3 result = ambient + diffuse + specular;
+#ifdef CLUSTERED_LIGHTING
+    result += clusteredLighting(norm, viewDir, objectColor, materialSpecular, materialShininess);
+#endif
+    FragColor  = vec4(result, 1.0);
+#endif
+}
@@ -0,0 +1,66 @@
+#version 330 core
+
+in vec3 aPos;
+#ifdef NORMAL_OCTAHEDRAL
+// Normal en 2 x snorm16 (VertexFormat.h): se despliega del octaedro
+in vec2 aNormal;
+
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        vec2 signs = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(e.yx)) * signs;
+    }
+    return normalize(n);
+}
+#else
+// Float o GL_INT_2_10_10_10_REV: glVertexAttribPointer ya da el vec3
+in vec3 aNormal;
+
+vec3 decodeNormal(vec3 n)
+{
+    return n;
+}
+#endif
+
+// Por instancia (glVertexAttribDivisor = 1)
+in mat4  aModel;
+in vec3  aColor;
+in float aMaterial;
+in mat3  aNormalMatrix;
+
+// Transformacion global de la escena (rotacion / escala del usuario)
+uniform mat4 model;
+uniform mat3 normalMatrix;
+
+// Estado por frame compartido por todos los programas (FrameUniformBuffer.h)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightAmbient;
+    vec3 lightDiffuse;
+    vec3 lightSpecular;
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec3 Color;
+flat out int MaterialIndex;
+
+void main()
+{
+    mat4 world = model * aModel;
+    FragPos = vec3(world * vec4(aPos, 1.0));
+    // La inversa traspuesta de un producto es el producto de las inversas
+    // traspuestas: la de la escena (uniform) por la de la instancia
+    Normal  = normalMatrix * aNormalMatrix * decodeNormal(aNormal);
+    Color   = aColor;
+    MaterialIndex = int(aMaterial);
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
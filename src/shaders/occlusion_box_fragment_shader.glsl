@@ -0,0 +1,10 @@
+#version 330 core
+
+// Sin escritura de color: solo cuenta si algún fragmento pasa la
+// prueba de profundidad
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(1.0);
+}
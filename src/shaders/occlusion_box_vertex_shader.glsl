@@ -0,0 +1,13 @@
+#version 330 core
+
+// Cubo unidad [-1, 1]: se escala y se lleva a la caja del objeto
+in vec3 aPos;
+
+uniform mat4 viewProjection;
+uniform vec3 boxCenter;
+uniform vec3 boxExtent;
+
+void main()
+{
+    gl_Position = viewProjection * vec4(boxCenter + aPos * boxExtent, 1.0);
+}
@@ -1,19 +1,64 @@
 #version 330 core
 
 in vec3 aPos;
+#ifdef NORMAL_OCTAHEDRAL
+// Normal en 2 x snorm16 (VertexFormat.h): se despliega del octaedro
+in vec2 aNormal;
+
+vec3 decodeNormal(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        vec2 signs = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(e.yx)) * signs;
+    }
+    return normalize(n);
+}
+#else
+// Float o GL_INT_2_10_10_10_REV: glVertexAttribPointer ya da el vec3
 in vec3 aNormal;
 
+vec3 decodeNormal(vec3 n)
+{
+    return n;
+}
+#endif
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Inversa traspuesta de model, calculada una vez por objeto en la CPU
+uniform mat3 normalMatrix;
+#ifdef NORMAL_MATRIX_PER_VERTEX
+// La decodificacion de las posiciones va aparte: model es solo la matriz
+// modelo, asi que su inversa traspuesta es la misma que normalMatrix
+uniform mat4 positionDecode;
+#endif
+
+// Estado por frame compartido por todos los programas (FrameUniformBuffer.h)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+    vec3 lightAmbient;
+    vec3 lightDiffuse;
+    vec3 lightSpecular;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 
 void main()
 {
+#ifdef NORMAL_MATRIX_PER_VERTEX
+    // Variante antigua, solo para --bench normal-matrix
+    FragPos = vec3(model * positionDecode * vec4(aPos, 1.0));
+    Normal  = mat3(transpose(inverse(model))) * decodeNormal(aNormal);
+#else
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal  = mat3(transpose(inverse(model))) * aNormal;
+    Normal  = normalMatrix * decodeNormal(aNormal);
+#endif
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }